@@ -47,8 +47,7 @@ public:
 
     void load_file(const std::string& path) {
         try {
-            std::vector<std::vector<kepler::Char>> lines = kepler::read_file(path);
-            input = kepler::concat_lines(lines);
+            input = kepler::read_file(path).text;
         } catch(kepler::Error& err) {
             stream << err.to_string() << std::endl;
         }
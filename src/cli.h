@@ -32,6 +32,11 @@ namespace kepler::cli {
     struct Config {
         bool show_help = false;
         bool run_tests = false;
+        bool report_memory = false;
+        std::size_t workspace_limit = 0;
+        std::string cache_directory;
+        std::string profile_format;
+        std::string sample_format;
         std::vector<std::string> commands;
     } config;
 
@@ -41,6 +46,21 @@ namespace kepler::cli {
     auto cli
             = lyra::help(config.show_help).description("Here is a list of all command-line arguments.")
                 | lyra::opt(config.run_tests)["-t"]["--test"]("Run the test suite.")
+                | lyra::opt(config.cache_directory, "directory")["-c"]["--cache"]("Keep the tokens of executed "
+                                                                                 "source files in the given directory, "
+                                                                                 "so later runs skip tokenizing them.")
+                | lyra::opt(config.profile_format, "text|json|folded")["-p"]["--profile"]("Profile the calls of functions, "
+                                                                                        "and write a report in the given "
+                                                                                        "format to stderr on exit.")
+                | lyra::opt(config.sample_format, "annotated|collapsed")["-s"]["--sample"]("Sample the lines of the "
+                                                                                          "source file being executed, "
+                                                                                          "and write a report in the given "
+                                                                                          "format to stderr on exit.")
+                | lyra::opt(config.report_memory)["-m"]["--memory"]("Count the memory allocated by each function, "
+                                                                   "and write a report to stderr on exit.")
+                | lyra::opt(config.workspace_limit, "bytes")["-w"]["--workspace"]("Limit the memory held by arrays, "
+                                                                                 "raising a WS FULL error instead "
+                                                                                 "of exceeding it.")
                 | lyra::arg(config.commands, "workspace|test tags")("Which source file (.kpl) to execute "
                                                                     "if <-t|--test> is not set, else specific "
                                                                     "tags to run tests for.");
@@ -28,10 +28,24 @@
 
 namespace kepler {
 
-    Array::Array(std::vector<unsigned int> shape_, std::vector<element_type> data_) : shape(std::move(shape_)), data(std::move(data_)) {}
+    Array::Array(std::vector<unsigned int> shape_, Storage<element_type> data_) : shape(std::move(shape_)), data(std::move(data_)) {}
 
     Array::Array(element_type scalar_) : shape(), data({scalar_}) {}
 
+    Array::Array(Text chars) : shape({static_cast<unsigned int>(chars.size())}), data(std::move(chars)) {}
+
+    template<>
+    Array::element_type from_char<Array::element_type>(Char c) {
+        // Like any other element of a vector, the character is boxed.
+        return Array{c};
+    }
+
+    template<>
+    Array::element_type from_number<Array::element_type>(const Number& number) {
+        // Like any other element of a vector, the number is boxed.
+        return Array{number};
+    }
+
     int Array::rank() const {
         return shape.size();
     }
@@ -79,4 +93,12 @@ namespace kepler {
         ArrayPrinter printer((int)std::get<Number>(arr.data[0]).real());
         return printer(*this);
     }
+
+    void Array::print(std::ostream& out, const SymbolTable* symbol_table) const {
+        auto& precision = symbol_table->get<Array>(constants::print_precision_id);
+        auto& width = symbol_table->get<Array>(constants::print_width_id);
+        ArrayPrinter printer((int)std::get<Number>(precision.data[0]).real(),
+                             (unsigned int)std::get<Number>(width.data[0]).real(), constants::max_print_rows);
+        printer.print(*this, out);
+    }
 };
\ No newline at end of file
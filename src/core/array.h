@@ -19,6 +19,8 @@
 
 #pragma once
 #include "datatypes.h"
+#include "storage.h"
+#include <ostream>
 #include <variant>
 
 namespace kepler {
@@ -29,19 +31,24 @@ namespace kepler {
      * Central data structure in Kepler.
      *
      * Represents a multidimensional array of elements.
-     * The elements can be of either type String, Number or Array.
+     * The elements can be of either type Char, Number or Array.
+     * Character vectors (strings) are rank 1 Arrays of Chars.
      *
      * Elements can be of mixed type.
      *
      * The shape of the array is stored in the shape vector,
-     * while the data is stored in the data vector.
+     * while the data is stored in the data Storage, which is
+     * shared between copies of the Array until one of them is modified.
      */
     struct Array {
         // Possible types of elements in the array.
-        using element_type = std::variant<String, Number, Array>;
+        using element_type = std::variant<Char, Number, Array>;
+
+        // The vector holding the elements of an Array.
+        using buffer_type = Storage<element_type>::buffer_type;
 
         std::vector<unsigned int> shape;
-        std::vector<element_type> data;
+        Storage<element_type> data;
 
         /**
          * Creates an Array with the given shape and data.
@@ -49,7 +56,7 @@ namespace kepler {
          * @param shape_ The shape of the array.
          * @param data_ The data of the array.
          */
-        Array(std::vector<unsigned int> shape_, std::vector<element_type> data_);
+        Array(std::vector<unsigned int> shape_, Storage<element_type> data_);
 
         /**
          * Creates an Array of one element (also called a Scalar)
@@ -57,6 +64,12 @@ namespace kepler {
          */
         Array(element_type scalar_);
 
+        /**
+         * Creates a character vector from compactly stored characters.
+         * @param chars The characters of the vector.
+         */
+        explicit Array(Text chars);
+
 
         /**
          * Returns the rank of the Array.
@@ -118,6 +131,18 @@ namespace kepler {
          */
         std::string to_string(const SymbolTable* symbol_table) const;
 
+        /**
+         * Writes the Array to the given stream, as it is displayed to the user.
+         *
+         * The SymbolTable is used to resolve the print precision '⎕PP' and the print width '⎕PW'.
+         * Lines wider than the print width are cut short, and rows beyond the first
+         * constants::max_print_rows are left out, so only the visible part of the Array is formatted.
+         *
+         * @param out The stream to write to.
+         * @param symbol_table The SymbolTable to get the print precision and width from.
+         */
+        void print(std::ostream& out, const SymbolTable* symbol_table) const;
+
         /**
          * Returns true if two Arrays are equal.
          *
@@ -131,4 +156,10 @@ namespace kepler {
             return lhs.shape == rhs.shape && lhs.data == rhs.data;
         }
     };
+
+    template<>
+    Array::element_type from_char<Array::element_type>(Char c);
+
+    template<>
+    Array::element_type from_number<Array::element_type>(const Number& number);
 };
\ No newline at end of file
@@ -40,6 +40,8 @@ std::string kepler::to_string(ErrorType error_type) {
             return "NOT IMPLEMENTED";
         case InternalError:
             return "INTERNAL ERROR";
+        case WSFullError:
+            return "WS FULL";
         default:
             return "UNDEFINED ERROR";
     }
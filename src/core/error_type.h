@@ -32,6 +32,7 @@ namespace kepler {
         RankError,
         SyntaxError,
         ValueError,
+        WSFullError,
     };
 
     /**
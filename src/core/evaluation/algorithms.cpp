@@ -19,6 +19,7 @@
 
 #include "algorithms.h"
 #include "core/error.h"
+#include "hashing.h"
 #include <cmath>
 #include <numeric>
 #include <algorithm>
@@ -51,7 +52,7 @@ kepler::Number kepler::binomial(const Number &alpha, const Number &omega) {
 }
 
 kepler::Array kepler::partitioned_enclose(const Array &alpha, const Array &omega) {
-    std::vector<Array::element_type> lists;
+    Array::buffer_type lists;
 
     if(alpha.size() > omega.size()) {
         throw kepler::Error(LengthError, "String must be at least as long as the partitioning.");
@@ -86,49 +87,18 @@ kepler::Array kepler::partitioned_enclose(const Array &alpha, const Array &omega
     return std::get<Array>(lists[0]);
 }
 
-kepler::Array kepler::partitioned_enclose(const Array &alpha, const String &omega) {
-    std::vector<Array::element_type> lists;
-
-    if(alpha.size() > omega.length()) {
-        throw kepler::Error(LengthError, "String must be at least the the partitioning.");
-    }
-
-    for(int i = 0; i < alpha.data.size(); ++i) {
-        auto element = std::get<Array>(alpha.data[i]);
-        if(!std::holds_alternative<Number>(element.data[0])) {
-            throw kepler::Error(DomainError, "Expected numbers only.");
-        }
-
-        auto& ctrl_bool = std::get<Number>(element.data[0]);
-
-        if((ctrl_bool.imag() != 0.0) || (ctrl_bool != 0.0 && ctrl_bool != 1.0)) {
-            throw kepler::Error(DomainError, "Expected boolean values only.");
-        }
-
-        if(ctrl_bool == 1.0) {
-            lists.emplace_back(Array{{}, {U""}});
-        }
-
-        if(!lists.empty()) {
-            auto& arr = std::get<Array>(lists.back());
-            auto& str = std::get<String>(arr.data[0]);
-            str += omega[i];
-        }
-    }
-
-    unsigned int size = lists.size();
-    if(size > 1 || size == 0) {
-        return {{size}, std::move(lists)};
-    }
-    return std::get<Array>(lists[0]);
-}
-
 kepler::Array kepler::without(const Array &alpha, const Array &omega) {
     Array result{{}, {}};
 
-    for(auto& element : alpha.data) {
-        if(std::count(omega.data.begin(), omega.data.end(), element) == 0) {
-            result.data.emplace_back(element);
+    // A simple scalar holds its value directly, while the elements of a vector are boxed.
+    Storage<Array::element_type> boxed_alpha, boxed_omega;
+    const auto& needles = alpha.is_simple_scalar() ? (boxed_alpha = {Array{alpha.data[0]}}) : alpha.data;
+    const auto& haystack = omega.is_simple_scalar() ? (boxed_omega = {Array{omega.data[0]}}) : omega.data;
+    auto found = index_of(haystack, needles);
+
+    for(int i = 0; i < alpha.data.size(); ++i) {
+        if(found[i] == not_found) {
+            result.data.emplace_back(alpha.data[i]);
         }
     }
 
@@ -141,18 +111,6 @@ kepler::Array kepler::without(const Array &alpha, const Array &omega) {
     return result.data[0];
 }
 
-kepler::Array kepler::without(const String &alpha, const String &omega) {
-    String result;
-
-    for(auto& c : alpha) {
-        if(std::count(omega.begin(), omega.end(), c) == 0) {
-            result += c;
-        }
-    }
-
-    return {{}, {result}};
-}
-
 kepler::Array kepler::rho(const Array &alpha, const Array &omega) {
     Array result{{}, {}};
 
@@ -182,14 +140,15 @@ kepler::Array kepler::rho(const Array &alpha, const Array &omega) {
     int alpha_length = result.flattened_shape();
 
     result.data.resize(alpha_length);
+    auto& elements = result.data.mutate();
     for(int i = 0; i < alpha_length; ++i) {
         if(omega.is_scalar()) {
-            result.data[i] = omega;
+            elements[i] = omega;
         } else if(omega_length == 0) {
-            result.data[i] = Array{0};
+            elements[i] = Array{0};
         } else {
             auto index = i % omega_length;
-            result.data[i] = omega.data[index];
+            elements[i] = omega.data[index];
         }
     }
 
@@ -62,18 +62,6 @@ namespace kepler {
      */
     Array partitioned_enclose(const Array& partitioning, const Array& subject);
 
-    /**
-    * Encloses elements in the subject string according to the partitioning.
-    *
-    * The behaviour is described in detail on this page:
-    * https://aplwiki.com/wiki/Partitioned_Enclose
-    *
-    * @param partitioning The partitioning to use.
-    * @param subject The string to enclose.
-    * @return The result of the partitioned enclose operation.
-    */
-    Array partitioned_enclose(const Array& partitioning, const String& subject);
-
     /**
      * Returns an Array which consists of all elements in alpha, except those in omega.
      *
@@ -86,18 +74,6 @@ namespace kepler {
      */
     Array without(const Array& alpha, const Array& omega);
 
-    /**
-     * Returns a String which consists of all symbols in alpha, except those in omega.
-     *
-     * The behaviour is described in detail on this page:
-     * https://aplwiki.com/wiki/Without
-     *
-     * @param alpha The String to remove symbols from.
-     * @param omega The String of symbols to remove.
-     * @return The result of the without operation.
-     */
-    Array without(const String& alpha, const String& omega);
-
     /**
      * Performs a reshape operation. A new array is created which has the shape list
      * of alpha, and the elements of omega. If omega does not have enough elements,
@@ -22,9 +22,55 @@
 #include "core/symbol_table.h"
 
 namespace kepler {
-    Scalar::Scalar(Token token_, std::variant<Number, String> content_) : token(std::move(token_)), content(std::move(content_)) {}
+    namespace {
+        Array literal(std::variant<Number, String> content) {
+            if(auto number = std::get_if<Number>(&content)) {
+                return {{}, {*number}};
+            }
+
+            String chars = std::get<String>(std::move(content));
+
+            // Expand the escape sequence for newlines.
+            for(auto index = chars.find(U"\\n"); index != String::npos; index = chars.find(U"\\n", index + 1)) {
+                chars.replace(index, 2, U"\n");
+            }
+
+            // A single character is a scalar, while any other number of characters is a vector.
+            if(chars.size() == 1) {
+                return {{}, {chars[0]}};
+            }
+            return Array(Text(chars));
+        }
+
+        std::optional<Array> fold(const std::vector<ASTNode<Array>*>& children) {
+            Array::buffer_type elements;
+            elements.reserve(children.size());
+            for(auto& child : children) {
+                if(auto scalar = dynamic_cast<Scalar*>(child)) {
+                    elements.emplace_back(scalar->value);
+                } else if(auto vector = dynamic_cast<Vector*>(child); vector && vector->value) {
+                    elements.emplace_back(*vector->value);
+                } else {
+                    return std::nullopt;
+                }
+            }
+            return Array{{static_cast<unsigned int>(elements.size())}, std::move(elements)};
+        }
+    }
+
+    Scalar::Scalar(Token token_, std::variant<Number, String> content_) : token(std::move(token_)), value(literal(std::move(content_))) {}
 
     std::string Scalar::to_string() const {
+        if(token.type == STRING && token.id == no_id) {
+            // The content of the string is not interned, so it is shown from the value it was read into.
+            String chars;
+            if(auto text = value.data.text()) {
+                chars = text->to_string();
+            } else {
+                chars = std::get<Char>(value.data[0]);
+            }
+            return "Scalar(Token(STRING, " + uni::utf32to8(chars) + "))";
+        }
         return "Scalar(" + token.to_string() + ")";
     }
 
@@ -39,7 +85,7 @@ namespace kepler {
         children.clear();
     }
 
-    Vector::Vector(std::vector<ASTNode *> children_) : children(std::move(children_)) {}
+    Vector::Vector(std::vector<ASTNode *> children_) : children(std::move(children_)), value(fold(children)) {}
 
 
     std::string Vector::to_string() const {
@@ -59,6 +105,40 @@ namespace kepler {
 
 
 
+    Constant::~Constant() {
+        delete origin;
+    }
+
+    Constant::Constant(Array value_, ASTNode<Array>* origin_) : value(std::move(value_)), origin(origin_) {
+        set_position(origin->get_position());
+    }
+
+    std::string Constant::to_string() const {
+        return "Constant(" + origin->to_string() + ")";
+    }
+
+    Array Constant::accept(NodeVisitor &visitor) { return visitor.visit(this); }
+
+
+
+
+    Invariant::~Invariant() {
+        delete child;
+    }
+
+    Invariant::Invariant(ASTNode<Array>* child_) : child(child_) {
+        set_position(child->get_position());
+    }
+
+    std::string Invariant::to_string() const {
+        return "Invariant(" + child->to_string() + ")";
+    }
+
+    Array Invariant::accept(NodeVisitor &visitor) { return visitor.visit(this); }
+
+
+
+
     MonadicOperator::~MonadicOperator() {
         delete child;
     }
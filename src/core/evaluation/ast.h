@@ -24,6 +24,7 @@
 #include "core/token.h"
 #include "core/datatypes.h"
 #include <memory>
+#include <optional>
 #include "core/evaluation/operations/operation.h"
 #include "core/position.h"
 
@@ -66,7 +67,9 @@ namespace kepler {
      */
     struct Scalar : ASTNode<Array> {
         Token token;
-        std::variant<Number, String> content;
+
+        // The value of the literal, built once when the node is created.
+        Array value;
 
         explicit Scalar(Token token_, std::variant<Number, String> content_);
 
@@ -76,10 +79,16 @@ namespace kepler {
 
     /**
      * A node representing a vector of other ASTNodes.
+     *
+     * A vector consisting only of literals is folded into a constant when the node is created.
+     * Every evaluation then shares the data of that constant, which is copied only if modified.
      */
     struct Vector : ASTNode<Array> {
         std::vector<ASTNode*> children;
 
+        // The folded value, if every child is a literal.
+        std::optional<Array> value;
+
         ~Vector() override;
         explicit Vector(std::vector<ASTNode*> children_);
 
@@ -87,6 +96,37 @@ namespace kepler {
         Array accept(NodeVisitor &visitor) override;
     };
 
+    /**
+     * A node representing a value computed before interpretation, replacing the node it was computed from.
+     */
+    struct Constant : ASTNode<Array> {
+        Array value;
+        ASTNode<Array>* origin;
+
+        ~Constant() override;
+        explicit Constant(Array value_, ASTNode<Array>* origin_);
+
+        std::string to_string() const override;
+        Array accept(NodeVisitor &visitor) override;
+    };
+
+    /**
+     * A node representing a subexpression of a dfn body which has the same value in every call of the dfn.
+     *
+     * The value is computed the first time the node is evaluated, and kept
+     * until the dfn is created again by its enclosing expression.
+     */
+    struct Invariant : ASTNode<Array> {
+        ASTNode<Array>* child;
+        std::optional<Array> value;
+
+        ~Invariant() override;
+        explicit Invariant(ASTNode<Array>* child_);
+
+        std::string to_string() const override;
+        Array accept(NodeVisitor &visitor) override;
+    };
+
     /**
      * A node representing a monadic operator node.
      */
@@ -165,6 +205,9 @@ namespace kepler {
         Token identifier;
         ASTNode<Operation_ptr>* function;
 
+        // The tokens of the function, from which it can be defined again.
+        TokenRange definition;
+
         ~FunctionAssignment() override;
         explicit FunctionAssignment(Token identifier, ASTNode<Operation_ptr>* function);
 
@@ -232,6 +275,9 @@ namespace kepler {
     struct AnonymousFunction : ASTNode<Operation_ptr> {
         Statements* body;
 
+        // The invariant subexpressions of the body, which are reset whenever the function is created.
+        std::vector<Invariant*> invariants;
+
         ~AnonymousFunction() override;
         explicit AnonymousFunction(Statements* body);
 
@@ -19,54 +19,103 @@
 
 #include "execution.h"
 #include <numeric>
+#include <streambuf>
 #include "core/literals.h"
 #include "interface/file_reader.h"
+#include "interface/script_cache.h"
 #include "core/evaluation/tokenizer.h"
 #include "core/evaluation/parser.h"
+#include "core/evaluation/optimizer.h"
 #include "core/evaluation/interpreter.h"
+#include "core/evaluation/hashing.h"
 #include "core/symbol_table.h"
 #include "core/datatypes.h"
 
-
-
-struct error_loc {
-    long line_number;
-    long pos;
-    const std::vector<kepler::Char>& line;
-
-    error_loc(long line_number_, long pos_, const std::vector<kepler::Char>& line_) : line_number(line_number_), pos(pos_), line(line_) {}
-};
-
-error_loc find_line(const std::vector<std::vector<kepler::Char>>& lines, long position) {
-    long line_index = 0;
-    while(position > lines[line_index].size() + 1 && line_index < lines.size()) {
-        position -= lines[line_index].size() + 1;
-        ++line_index;
+namespace {
+    // Makes the positions of a statement's tokens relative to the whole source, so calls made
+    // later from functions it defines are still located in the right statement.
+    std::vector<kepler::Token> located(std::vector<kepler::Token> tokens, std::size_t start) {
+        for(auto& token : tokens) {
+            if(token.offset >= 0) {
+                token.offset += static_cast<std::int32_t>(start);
+            }
+        }
+        return tokens;
     }
 
-    if(line_index >= lines.size()) {
-        return {line_index + 1, position, lines.back()};
-    } else {
-        return {line_index + 1, position, lines[line_index]};
-    }
+    // Clears the cached hash indices once a statement has been executed, so they do not outlive the arrays they index.
+    struct IndexCacheScope {
+        ~IndexCacheScope() {
+            kepler::clear_index_cache();
+        }
+    };
 }
 
-int kepler::run_file(const std::string &path, std::ostream & stream) {
+int kepler::run_file(const std::string &path, std::ostream & stream, const std::string& cache_directory) {
     try {
         SymbolTable symbol_table;
         symbol_table.insert_system_parameters();
 
-        std::vector<std::vector<Char>> lines = kepler::read_file(path);
-        std::vector<Char> all_lines = kepler::concat_lines(lines);
-        try {
-            kepler::immediate_execution(all_lines, stream, false, &symbol_table);
-        } catch (kepler::Error& err) {
-            auto loc = find_line(lines, err.position);
-            err.set_input(&loc.line);
-            err.position = loc.pos;
-            err.set_file(path);
-            err.set_line(loc.line_number);
-            stream  << "\n"  << err.to_string() << "\n" << std::endl;
+        Source source = kepler::read_file(path);
+
+        std::optional<CompiledScript> cached;
+        if(!cache_directory.empty()) {
+            cached = kepler::load_script(cache_directory, source);
+        }
+        CompiledScript compiled;
+        bool completed = true;
+
+        // Statements are tokenized, parsed and executed one at a time, so only one is held in memory.
+        std::vector<Char> statement;
+        std::size_t start = 0;
+        std::size_t index = 0;
+        while(cached ? index < cached->starts.size() : start < source.text.size()) {
+            try {
+                if(cached) {
+                    start = cached->starts[index];
+                    kepler::immediate_execution(located(cached->statement(index), start), stream, false, &symbol_table, &source.text);
+                    ++index;
+                    continue;
+                }
+
+                std::size_t end = Tokenizer::statement_end(source.text, start);
+                statement.assign(source.text.begin() + static_cast<long>(start), source.text.begin() + static_cast<long>(end));
+
+                Tokenizer tokenizer;
+                std::vector<Token> tokens;
+                try {
+                    tokens = tokenizer.tokenize(&statement);
+                } catch (kepler::Error& err) {
+                    // The statement is tokenized on its own, so its errors are located relative to its start.
+                    if(err.position >= 0) {
+                        err.position += static_cast<long>(start);
+                    }
+                    throw;
+                }
+                if(!cache_directory.empty()) {
+                    compiled.add(start, tokens);
+                }
+                kepler::immediate_execution(located(std::move(tokens), start), stream, false, &symbol_table, &source.text);
+                start = end + 1;
+            } catch (kepler::Error& err) {
+                // Positions are relative to the source, and errors without one are reported at the statement's start.
+                long position = err.position < 0 ? static_cast<long>(start) : err.position;
+                auto line_index = source.line_of(position);
+                auto line = source.line(line_index);
+                err.set_input(&line);
+                if(err.position >= 0) {
+                    err.position = position - static_cast<long>(source.line_starts[line_index]);
+                }
+                err.set_file(path);
+                err.set_line(static_cast<int>(line_index + 1));
+                stream  << "\n"  << err.to_string() << "\n" << std::endl;
+                completed = false;
+                break;
+            }
+        }
+
+        if(completed && !cached && !cache_directory.empty()) {
+            kepler::store_script(cache_directory, source, compiled);
         }
 
         symbol_table.clear();
@@ -80,6 +129,46 @@ int kepler::run_file(const std::string &path, std::ostream & stream) {
 
 
 
+namespace {
+    /**
+     * Forwards output to another stream buffer, remembering whether anything was written.
+     */
+    class OutputTracker : public std::streambuf {
+    private:
+        std::streambuf* target;
+        bool any = false;
+
+    public:
+        explicit OutputTracker(std::streambuf* target_) : target(target_) {}
+
+        [[nodiscard]] bool written() const {
+            return any;
+        }
+
+        void reset() {
+            any = false;
+        }
+
+    protected:
+        int_type overflow(int_type c) override {
+            if(traits_type::eq_int_type(c, traits_type::eof())) {
+                return traits_type::not_eof(c);
+            }
+            any = true;
+            return target->sputc(traits_type::to_char_type(c));
+        }
+
+        std::streamsize xsputn(const char* s, std::streamsize n) override {
+            any = any || n > 0;
+            return target->sputn(s, n);
+        }
+
+        int sync() override {
+            return target->pubsync();
+        }
+    };
+}
+
 void display_prompt(std::string& input) {
     std::cout << kepler::constants::indent_prompt << std::flush;
     getline(std::cin, input);
@@ -93,18 +182,21 @@ kepler::String read_input() {
 }
 
 int kepler::run_repl() {
-    std::stringstream ss;
     SymbolTable symbol_table;
 
     symbol_table.insert_system_parameters();
 
+    // Results are written to the terminal as they are formatted, rather than collected first.
+    OutputTracker tracker(std::cout.rdbuf());
+    std::ostream out(&tracker);
+
     while(true) {
         String input = read_input();
-        ss.str("");
+        tracker.reset();
         List<Char> in = {input.begin(), input.end()};
-        kepler::safe_execution(in, ss, true, &symbol_table);
-        if(!ss.str().empty()) {
-            std::cout << ss.str() << std::endl;
+        kepler::safe_execution(in, out, true, &symbol_table);
+        if(tracker.written()) {
+            out << std::endl;
         }
     }
 }
@@ -120,19 +212,26 @@ void kepler::safe_execution(const std::vector<Char> &input, std::ostream &stream
 
 void kepler::immediate_execution(const std::vector<Char> &input, std::ostream &stream, bool print_last, SymbolTable* symbol_table) {
     Tokenizer tokenizer;
-    List<Token> tokens = tokenizer.tokenize(&input);
+    kepler::immediate_execution(tokenizer.tokenize(&input), stream, print_last, symbol_table, &input);
+}
 
+void kepler::immediate_execution(const std::vector<Token> &tokens, std::ostream &stream, bool print_last, SymbolTable* symbol_table, const std::vector<Char>* text) {
+    IndexCacheScope index_cache;
     Parser parser;
     if(symbol_table != nullptr) {
         parser.use_table(symbol_table);
     }
-    auto ast = parser.parse(tokens);
+    auto ast = parser.parse(tokens, text);
+
+    Optimizer optimizer(*ast->symbol_table);
+    optimizer.optimize(ast);
 
     Interpreter interpreter(*ast, *ast->symbol_table, stream);
     auto result = interpreter.interpret();
 
     if(print_last) {
-        stream << result.to_string(ast->symbol_table) << std::flush;
+        result.print(stream, ast->symbol_table);
+        stream << std::flush;
     }
     delete ast;
 }
\ No newline at end of file
@@ -21,15 +21,21 @@
 #include <string>
 #include "core/datatypes.h"
 #include "core/symbol_table.h"
+#include "core/token.h"
 
 namespace kepler {
     /**
      * Executes the '.kpl' file which is located at the given path, and outputs any results/errors to the given stream.
+     *
+     * If a cache directory is given, the tokens of the file are loaded from the cache when it holds them
+     * for the current contents of the file, and are stored there after a run which completes without errors.
+     *
      * @param path The path of the file to execute.
      * @param stream The output stream to write to.
+     * @param cache_directory The directory of the script cache, or empty to not use the cache.
      * @return 1 if an error occurred, 0 otherwise.
      */
-    int run_file(const std::string& path, std::ostream & stream = std::cout);
+    int run_file(const std::string& path, std::ostream & stream = std::cout, const std::string& cache_directory = "");
 
     /**
      * Starts a REPL (Read-Eval-Print-Loop) which reads input from the user, evaluates it, and prints the result.
@@ -60,4 +66,17 @@ namespace kepler {
      * @param symbol_table The symbol table to use during evaluation. Can be nullptr.
      */
     void immediate_execution(const std::vector<Char>& input, std::ostream & stream, bool print_last = true, SymbolTable* symbol_table = nullptr);
+
+    /**
+     * Executes the given tokens, and outputs any results/errors to the given stream.
+     *
+     * This function is unsafe, meaning that it will throw exceptions if errors occur.
+     *
+     * @param tokens The tokens of the input to execute, as produced by the Tokenizer.
+     * @param stream The output stream to write to.
+     * @param print_last Whether or not to print the last result.
+     * @param symbol_table The symbol table to use during evaluation. Can be nullptr.
+     * @param text The input the tokens were read from, holding the contents of their strings. Can be nullptr if they are interned.
+     */
+    void immediate_execution(const std::vector<Token>& tokens, std::ostream & stream, bool print_last = true, SymbolTable* symbol_table = nullptr, const std::vector<Char>* text = nullptr);
 };
\ No newline at end of file
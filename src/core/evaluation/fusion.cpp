@@ -0,0 +1,203 @@
+//
+// Copyright 2023 Nikolaj Banke Jensen.
+//
+// This file is part of Kepler.
+// 
+// Kepler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Kepler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License 
+// along with Kepler. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "fusion.h"
+#include "core/error.h"
+#include "core/evaluation/parallel.h"
+#include "core/evaluation/operations/monadic_operators.h"
+
+namespace kepler {
+    FusedExpression FusedExpression::leaf(const Array& value) {
+        FusedExpression result;
+        result.value = &value;
+        return result;
+    }
+
+    FusedExpression FusedExpression::leaf(Array&& value) {
+        FusedExpression result;
+        result.storage = std::make_shared<const Array>(std::move(value));
+        result.value = result.storage.get();
+        return result;
+    }
+
+    FusedExpression FusedExpression::monadic(Operation_ptr op, FusedExpression omega) {
+        FusedExpression result;
+        result.op = std::move(op);
+        result.arguments.emplace_back(std::move(omega));
+        return result;
+    }
+
+    FusedExpression FusedExpression::dyadic(Operation_ptr op, FusedExpression alpha, FusedExpression omega) {
+        FusedExpression result;
+        result.op = std::move(op);
+        result.arguments.emplace_back(std::move(alpha));
+        result.arguments.emplace_back(std::move(omega));
+        return result;
+    }
+
+    Array FusedExpression::materialize() const {
+        if(!op) {
+            return *value;
+        } else if(arguments.size() == 1) {
+            return (*op)(arguments[0].materialize());
+        }
+
+        Array omega = arguments[1].materialize();
+        return (*op)(arguments[0].materialize(), omega);
+    }
+
+    namespace {
+        // Thrown when an element turns out not to be a simple number.
+        struct NotFusable {};
+
+        /**
+         * A FusedExpression flattened into a list of nodes, where the
+         * arguments of a node always precede it. The root is the last node.
+         */
+        struct Program {
+            struct Node {
+                const ScalarKernel* kernel = nullptr;
+                int alpha = -1;
+                int omega = -1;
+                const Array* leaf = nullptr;
+            };
+
+            std::vector<Node> nodes;
+            const std::vector<unsigned int>* shape = nullptr;
+
+            // Returns false if the expression cannot be fused.
+            bool compile(const FusedExpression& expression) {
+                Node node;
+                if(!expression.op) {
+                    node.leaf = expression.value;
+                    if(!node.leaf->is_scalar()) {
+                        if(shape && *shape != node.leaf->shape) {
+                            return false;
+                        }
+                        shape = &node.leaf->shape;
+                    }
+                } else {
+                    node.kernel = expression.op->kernel();
+                    if(!node.kernel) {
+                        return false;
+                    } else if(expression.arguments.size() == 1) {
+                        if(!node.kernel->monadic || !compile(expression.arguments[0])) {
+                            return false;
+                        }
+                        node.omega = static_cast<int>(nodes.size()) - 1;
+                    } else {
+                        if(!node.kernel->dyadic || !compile(expression.arguments[0])) {
+                            return false;
+                        }
+                        node.alpha = static_cast<int>(nodes.size()) - 1;
+                        if(!compile(expression.arguments[1])) {
+                            return false;
+                        }
+                        node.omega = static_cast<int>(nodes.size()) - 1;
+                    }
+                }
+                nodes.emplace_back(node);
+                return true;
+            }
+
+            static const Number& number_at(const Array& array, std::size_t index) {
+                const auto& element = array.data[array.is_scalar() ? 0 : index];
+                if(auto number = std::get_if<Number>(&element)) {
+                    return *number;
+                } else if(auto nested = std::get_if<Array>(&element); nested && nested->is_scalar()) {
+                    if(auto number = std::get_if<Number>(&nested->data[0])) {
+                        return *number;
+                    }
+                }
+                throw NotFusable{};
+            }
+
+            Number evaluate(int node, std::size_t index) const {
+                const Node& n = nodes[node];
+                if(n.leaf) {
+                    return number_at(*n.leaf, index);
+                } else if(n.alpha < 0) {
+                    return n.kernel->monadic(evaluate(n.omega, index));
+                }
+
+                Number omega = evaluate(n.omega, index);
+                return n.kernel->dyadic(evaluate(n.alpha, index), omega);
+            }
+        };
+    }
+
+    std::optional<Number> fused_reduce(const ScalarKernel& reducer, const FusedExpression& expression) {
+        Program program;
+        if(!program.compile(expression) || !program.shape) {
+            return std::nullopt;
+        }
+
+        std::size_t size = 1;
+        for(auto dim : *program.shape) {
+            size *= dim;
+        }
+        if(size < 2) {
+            return std::nullopt;
+        }
+
+        int root = static_cast<int>(program.nodes.size()) - 1;
+        auto reduce_range = [&](std::size_t begin, std::size_t end) {
+            Number acc = program.evaluate(root, end - 1);
+            for(std::size_t i = end - 1; i-- > begin;) {
+                acc = reducer.dyadic(program.evaluate(root, i), acc);
+            }
+            return acc;
+        };
+
+        try {
+            if(!reducer.associative) {
+                return reduce_range(0, size);
+            }
+
+            std::vector<Number> partials(parallel::chunk_count(size));
+            parallel::for_chunks(size, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+                partials[chunk] = reduce_range(begin, end);
+            });
+
+            Number acc = partials.back();
+            for(std::size_t i = partials.size() - 1; i-- > 0;) {
+                acc = reducer.dyadic(partials[i], acc);
+            }
+            return acc;
+        } catch (NotFusable&) {
+            return std::nullopt;
+        } catch (kepler::Error&) {
+            return std::nullopt;
+        }
+    }
+
+    Array reduce(const Operation_ptr& reducer, const FusedExpression& expression) {
+        if(auto kernel = reducer->kernel(); kernel && kernel->dyadic) {
+            if(auto result = fused_reduce(*kernel, expression)) {
+                return {*result};
+            }
+        }
+
+        Slash slash(reducer);
+        if(!expression.op) {
+            return slash(*expression.value);
+        }
+        return slash(expression.materialize());
+    }
+};
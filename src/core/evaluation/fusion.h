@@ -0,0 +1,104 @@
+//
+// Copyright 2023 Nikolaj Banke Jensen.
+//
+// This file is part of Kepler.
+// 
+// Kepler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Kepler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License 
+// along with Kepler. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include <optional>
+#include <memory>
+#include <vector>
+#include "core/array.h"
+#include "core/evaluation/operations/operation.h"
+#include "core/evaluation/ast.h"
+
+namespace kepler {
+    /**
+     * A tree of scalar primitives applied to already evaluated arrays.
+     *
+     * An expression such as 'a×b-c' is represented with '×' and '-' in the inner
+     * nodes, and the values of a, b, and c in the leaves. Since the primitives
+     * are scalar, the expression can be evaluated one element at a time, without
+     * materializing the intermediate arrays.
+     */
+    struct FusedExpression {
+        // The operation of an inner node, or nullptr for a leaf.
+        Operation_ptr op;
+
+        // The arguments of an inner node, either {omega} or {alpha, omega}.
+        std::vector<FusedExpression> arguments;
+
+        // The value of a leaf, either borrowed or owned by storage.
+        const Array* value = nullptr;
+        std::shared_ptr<const Array> storage;
+
+        /**
+         * Creates a leaf that refers to an Array owned by the caller.
+         * @param value The Array, which must outlive the expression.
+         * @return The leaf.
+         */
+        static FusedExpression leaf(const Array& value);
+
+        /**
+         * Creates a leaf that owns its Array.
+         * @param value The Array.
+         * @return The leaf.
+         */
+        static FusedExpression leaf(Array&& value);
+
+        /**
+         * Creates an inner node applying op monadically.
+         */
+        static FusedExpression monadic(Operation_ptr op, FusedExpression omega);
+
+        /**
+         * Creates an inner node applying op dyadically.
+         */
+        static FusedExpression dyadic(Operation_ptr op, FusedExpression alpha, FusedExpression omega);
+
+        /**
+         * Evaluates the expression the ordinary way, applying each operation to whole arrays.
+         * @return The value of the expression.
+         */
+        Array materialize() const;
+    };
+
+    /**
+     * Reduces an expression right-to-left with the reducer, computing each element
+     * of the expression as the reduction consumes it.
+     *
+     * Large reductions with an associative reducer are split across threads.
+     *
+     * The fused evaluation only applies to expressions whose leaves are simple numeric
+     * arrays of equal shape (or scalars), and of which at least two elements are reduced.
+     * Otherwise, and if evaluation fails with an error, std::nullopt is returned, and the
+     * caller is expected to evaluate the expression in the ordinary way, which also
+     * reproduces the error.
+     *
+     * @param reducer The kernel of the reducing operation, which must have a dyadic kernel.
+     * @param expression The expression to reduce.
+     * @return The result of the reduction, or std::nullopt.
+     */
+    std::optional<Number> fused_reduce(const ScalarKernel& reducer, const FusedExpression& expression);
+
+    /**
+     * Evaluates reducer/expression, fusing the reduction with the expression where possible.
+     * @param reducer The reducing operation.
+     * @param expression The expression to reduce.
+     * @return The result of the reduction.
+     */
+    Array reduce(const Operation_ptr& reducer, const FusedExpression& expression);
+};
@@ -0,0 +1,203 @@
+//
+// Copyright 2023 Nikolaj Banke Jensen.
+//
+// This file is part of Kepler.
+// 
+// Kepler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Kepler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License 
+// along with Kepler. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "hashing.h"
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <variant>
+
+namespace kepler {
+    namespace {
+        // Finalizer of splitmix64, which spreads the bits of x across the whole hash.
+        std::size_t mix(std::uint64_t x) {
+            x ^= x >> 30;
+            x *= 0xbf58476d1ce4e5b9ULL;
+            x ^= x >> 27;
+            x *= 0x94d049bb133111ebULL;
+            x ^= x >> 31;
+            return static_cast<std::size_t>(x);
+        }
+
+        std::size_t combine(std::size_t seed, std::size_t value) {
+            return mix(seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2)));
+        }
+
+        std::uint64_t bits(double d) {
+            // Map ¯0 to 0, as they compare equal.
+            return std::bit_cast<std::uint64_t>(d == 0.0 ? 0.0 : d);
+        }
+    }
+
+    std::size_t hash(const Number& number) {
+        return mix(bits(number.real()) ^ mix(bits(number.imag())));
+    }
+
+    std::size_t hash(Char c) {
+        return mix(c);
+    }
+
+    std::size_t hash(const Array::element_type& element) {
+        std::size_t seed = element.index();
+        if(auto number = std::get_if<Number>(&element)) {
+            return combine(seed, hash(*number));
+        } else if(auto c = std::get_if<Char>(&element)) {
+            return combine(seed, hash(*c));
+        }
+        return combine(seed, hash(std::get<Array>(element)));
+    }
+
+    std::size_t hash(const Array& array) {
+        std::size_t seed = mix(array.shape.size());
+        for(auto dim : array.shape) {
+            seed = combine(seed, dim);
+        }
+        for(auto& element : array.data) {
+            seed = combine(seed, hash(element));
+        }
+        return seed;
+    }
+
+    std::size_t hash(const ElementRef& ref) {
+        return hash(*ref.element);
+    }
+
+    namespace {
+        // Returns the Number held by a simple numeric scalar element, or nullptr for any other element.
+        const Number* number_key(const Array::element_type& element) {
+            if(auto array = std::get_if<Array>(&element); array && array->is_scalar()) {
+                return std::get_if<Number>(&array->data[0]);
+            }
+            return nullptr;
+        }
+
+        // Extracts the Numbers of elements, if every element is a simple numeric scalar.
+        bool numeric_keys(const Storage<Array::element_type>& elements, std::vector<Number>& keys) {
+            keys.reserve(elements.size());
+            for(auto& element : elements) {
+                auto number = number_key(element);
+                if(!number) {
+                    return false;
+                }
+                keys.emplace_back(*number);
+            }
+            return true;
+        }
+
+        std::vector<ElementRef> element_keys(const Storage<Array::element_type>& elements) {
+            std::vector<ElementRef> keys;
+            keys.reserve(elements.size());
+            for(auto& element : elements) {
+                keys.push_back({&element});
+            }
+            return keys;
+        }
+
+        /**
+         * A hash index of a buffer, kept for reuse by later lookups into the same buffer.
+         *
+         * Holding the buffer keeps it shared, so it is never modified while cached,
+         * and the element references of the index stay valid.
+         */
+        struct CachedIndex {
+            std::shared_ptr<const Array::buffer_type> buffer;
+            std::variant<HashIndex<Number>, HashIndex<ElementRef>> index;
+        };
+
+        // The most recently used indices, most recent first.
+        thread_local std::vector<std::shared_ptr<CachedIndex>> index_cache;
+
+        std::shared_ptr<CachedIndex> cached_index(const Storage<Array::element_type>& haystack) {
+            auto it = std::find_if(index_cache.begin(), index_cache.end(), [&](auto& entry) {
+                return entry->buffer.get() == haystack.identity();
+            });
+
+            std::shared_ptr<CachedIndex> entry;
+            if(it != index_cache.end()) {
+                entry = *it;
+                index_cache.erase(it);
+            } else {
+                std::vector<Number> numbers;
+                if(numeric_keys(haystack, numbers)) {
+                    entry = std::make_shared<CachedIndex>(CachedIndex{haystack.share(), HashIndex<Number>(numbers)});
+                } else {
+                    entry = std::make_shared<CachedIndex>(CachedIndex{haystack.share(), HashIndex<ElementRef>(element_keys(haystack))});
+                }
+
+                if(index_cache.size() == index_cache_capacity) {
+                    index_cache.pop_back();
+                }
+            }
+
+            index_cache.insert(index_cache.begin(), entry);
+            return entry;
+        }
+
+        std::vector<std::size_t> find_all(const CachedIndex& entry, const Storage<Array::element_type>& needles) {
+            std::vector<std::size_t> result(needles.size(), not_found);
+            if(auto numbers = std::get_if<HashIndex<Number>>(&entry.index)) {
+                // Only simple numeric scalars can equal elements of a numeric haystack.
+                for(std::size_t i = 0; i < needles.size(); ++i) {
+                    if(auto number = number_key(needles[i])) {
+                        result[i] = numbers->find(*number);
+                    }
+                }
+            } else {
+                auto& elements = std::get<HashIndex<ElementRef>>(entry.index);
+                for(std::size_t i = 0; i < needles.size(); ++i) {
+                    result[i] = elements.find({&needles[i]});
+                }
+            }
+            return result;
+        }
+    }
+
+    std::vector<std::size_t> index_of(const Storage<Array::element_type>& haystack, const Storage<Array::element_type>& needles) {
+        if(haystack.text() && needles.text()) {
+            // Characters stored as text are compared without creating their elements.
+            auto haystack_chars = haystack.text()->to_string();
+            auto needle_chars = needles.text()->to_string();
+            return index_of<Char>(haystack_chars, needle_chars);
+        }
+
+        bool same = haystack.identity() == needles.identity();
+
+        std::vector<Number> haystack_numbers;
+        std::vector<Number> needle_numbers;
+        if(!same && haystack.size() >= index_cache_threshold && haystack.size() + needles.size() < sort_threshold) {
+            return find_all(*cached_index(haystack), needles);
+        } else if(numeric_keys(haystack, haystack_numbers)) {
+            if(same) {
+                return index_of<Number>(haystack_numbers, haystack_numbers);
+            } else if(numeric_keys(needles, needle_numbers)) {
+                return index_of<Number>(haystack_numbers, needle_numbers);
+            }
+        }
+
+        auto haystack_keys = element_keys(haystack);
+        if(same) {
+            return index_of<ElementRef>(haystack_keys, haystack_keys);
+        }
+        return index_of<ElementRef>(haystack_keys, element_keys(needles));
+    }
+
+    void clear_index_cache() {
+        index_cache.clear();
+    }
+};
@@ -0,0 +1,166 @@
+//
+// Copyright 2023 Nikolaj Banke Jensen.
+//
+// This file is part of Kepler.
+// 
+// Kepler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Kepler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License 
+// along with Kepler. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include <cstddef>
+#include <span>
+#include <vector>
+#include "core/datatypes.h"
+#include "core/array.h"
+
+namespace kepler {
+    // Position of keys which could not be found.
+    constexpr std::size_t not_found = static_cast<std::size_t>(-1);
+
+    /**
+     * Returns a hash of a Number.
+     *
+     * Numbers which compare equal hash equally, so 0 and ¯0 share a hash.
+     *
+     * @param number The Number to hash.
+     * @return The hash.
+     */
+    std::size_t hash(const Number& number);
+
+    /**
+     * Returns a hash of a Char.
+     * @param c The Char to hash.
+     * @return The hash.
+     */
+    std::size_t hash(Char c);
+
+    /**
+     * Returns a structural hash of an element.
+     *
+     * The hash is consistent with element equality: it covers the type of the
+     * element, and for Arrays their shape and (recursively) their elements.
+     *
+     * @param element The element to hash.
+     * @return The hash.
+     */
+    std::size_t hash(const Array::element_type& element);
+
+    /**
+     * Returns a structural hash of an Array.
+     * @param array The Array to hash.
+     * @return The hash.
+     */
+    std::size_t hash(const Array& array);
+
+    /**
+     * A reference to an element, hashed and compared structurally.
+     *
+     * This is the key used when the elements do not fit any of the typed fast paths.
+     */
+    struct ElementRef {
+        const Array::element_type* element;
+
+        friend bool operator==(const ElementRef& lhs, const ElementRef& rhs) {
+            return *lhs.element == *rhs.element;
+        }
+    };
+
+    std::size_t hash(const ElementRef& ref);
+
+    /**
+     * An open addressing hash table mapping keys to the position
+     * of their first occurrence in a sequence.
+     *
+     * @tparam Key The type of keys. A kepler::hash(Key) overload must exist.
+     */
+    template<typename Key>
+    struct HashIndex {
+        /**
+         * Creates an index of every key in the sequence.
+         * @param keys The sequence of keys to index.
+         */
+        explicit HashIndex(std::span<const Key> keys);
+
+        /**
+         * Returns the position of the first occurrence of key.
+         * @param key The key to look up.
+         * @return The position, or not_found if key does not occur.
+         */
+        [[nodiscard]] std::size_t find(const Key& key) const;
+
+    private:
+        struct Slot {
+            Key key;
+            std::size_t position = not_found;
+        };
+
+        std::vector<Slot> slots;
+        std::size_t mask;
+    };
+
+    /**
+     * Inputs of at least this many elements are matched by sorting rather than hashing,
+     * as the random access pattern of a hash table becomes the bottleneck.
+     */
+    constexpr std::size_t sort_threshold = 1 << 22;
+
+    /**
+     * Returns, for each needle, the position of the first equal element in haystack.
+     *
+     * Uses a HashIndex, or sorting for inputs larger than sort_threshold.
+     *
+     * @tparam Key The type of keys.
+     * @param haystack The keys to search in.
+     * @param needles The keys to search for.
+     * @return The positions, where not_found marks needles which do not occur in haystack.
+     */
+    template<typename Key>
+    std::vector<std::size_t> index_of(std::span<const Key> haystack, std::span<const Key> needles);
+
+    /**
+     * Haystacks of at least this many elements have their hash index cached,
+     * so repeated lookups into the same haystack reuse it. Inputs of sort_threshold
+     * elements or more are sorted instead, and are not cached.
+     */
+    constexpr std::size_t index_cache_threshold = 1 << 10;
+
+    /**
+     * The maximum amount of cached hash indices.
+     */
+    constexpr std::size_t index_cache_capacity = 8;
+
+    /**
+     * Returns, for each element of needles, the position of the first equal element in haystack.
+     *
+     * If every element of haystack is a simple numeric scalar, the Numbers are used as keys
+     * directly. Otherwise, elements are hashed and compared structurally.
+     *
+     * Large haystacks have their index cached against the identity of their Storage buffer,
+     * so looking up values in the same (unmodified) Array again does not rebuild the index.
+     * The cache keeps the buffers alive until it is cleared.
+     *
+     * @param haystack The elements to search in.
+     * @param needles The elements to search for.
+     * @return The positions, where not_found marks needles which do not occur in haystack.
+     */
+    std::vector<std::size_t> index_of(const Storage<Array::element_type>& haystack, const Storage<Array::element_type>& needles);
+
+    /**
+     * Discards the indices cached by index_of on the calling thread, releasing the buffers they keep alive.
+     */
+    void clear_index_cache();
+};
+
+// Include of .tpp file goes at the bottom.
+#include "hashing.tpp"
@@ -0,0 +1,115 @@
+//
+// Copyright 2023 Nikolaj Banke Jensen.
+//
+// This file is part of Kepler.
+// 
+// Kepler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Kepler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License 
+// along with Kepler. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <type_traits>
+
+namespace kepler {
+    template<typename Key>
+    HashIndex<Key>::HashIndex(std::span<const Key> keys) {
+        // Keep the load factor at or below one half.
+        slots.resize(std::bit_ceil(std::max<std::size_t>(keys.size() * 2, 8)));
+        mask = slots.size() - 1;
+
+        for(std::size_t position = 0; position < keys.size(); ++position) {
+            const Key& key = keys[position];
+            for(std::size_t i = hash(key) & mask;; i = (i + 1) & mask) {
+                Slot& slot = slots[i];
+                if(slot.position == not_found) {
+                    slot.key = key;
+                    slot.position = position;
+                    break;
+                } else if(slot.key == key) {
+                    break;
+                }
+            }
+        }
+    }
+
+    template<typename Key>
+    std::size_t HashIndex<Key>::find(const Key& key) const {
+        for(std::size_t i = hash(key) & mask;; i = (i + 1) & mask) {
+            const Slot& slot = slots[i];
+            if(slot.position == not_found || slot.key == key) {
+                return slot.position;
+            }
+        }
+    }
+
+    namespace detail {
+        inline bool less(const Number& lhs, const Number& rhs) {
+            return lhs.real() < rhs.real() || (lhs.real() == rhs.real() && lhs.imag() < rhs.imag());
+        }
+
+        inline bool less(Char lhs, Char rhs) {
+            return lhs < rhs;
+        }
+
+        // Keys are only sortable if they have a strict weak ordering, which NaN breaks.
+        inline bool sortable(std::span<const Number> keys) {
+            return std::none_of(keys.begin(), keys.end(), [](const Number& n) {
+                return std::isnan(n.real()) || std::isnan(n.imag());
+            });
+        }
+
+        inline bool sortable(std::span<const Char>) {
+            return true;
+        }
+
+        template<typename Key>
+        std::vector<std::size_t> sorted_index_of(std::span<const Key> haystack, std::span<const Key> needles) {
+            std::vector<std::size_t> order(haystack.size());
+            for(std::size_t i = 0; i < order.size(); ++i) {
+                order[i] = i;
+            }
+
+            // Stable, so the first of a run of equal keys is its first occurrence.
+            std::stable_sort(order.begin(), order.end(), [&](std::size_t lhs, std::size_t rhs) {
+                return less(haystack[lhs], haystack[rhs]);
+            });
+
+            std::vector<std::size_t> result(needles.size());
+            for(std::size_t i = 0; i < needles.size(); ++i) {
+                auto it = std::lower_bound(order.begin(), order.end(), needles[i], [&](std::size_t position, const Key& key) {
+                    return less(haystack[position], key);
+                });
+                result[i] = (it != order.end() && haystack[*it] == needles[i]) ? *it : not_found;
+            }
+            return result;
+        }
+    };
+
+    template<typename Key>
+    std::vector<std::size_t> index_of(std::span<const Key> haystack, std::span<const Key> needles) {
+        if constexpr (!std::is_same_v<Key, ElementRef>) {
+            if(haystack.size() + needles.size() >= sort_threshold && detail::sortable(haystack) && detail::sortable(needles)) {
+                return detail::sorted_index_of(haystack, needles);
+            }
+        }
+
+        HashIndex<Key> index(haystack);
+        std::vector<std::size_t> result(needles.size());
+        for(std::size_t i = 0; i < needles.size(); ++i) {
+            result[i] = index.find(needles[i]);
+        }
+        return result;
+    }
+};
@@ -20,35 +20,77 @@
 #include <string>
 #include "interpreter.h"
 #include <memory>
+#include <optional>
 #include "core/literals.h"
 #include "core/symbol_table.h"
 #include "core/evaluation/parser.h"
 #include "core/evaluation/operations/defined_function.h"
+#include "core/evaluation/operations/system_functions.h"
+#include "core/evaluation/profiler.h"
+#include "core/evaluation/sampler.h"
+#include "core/memory.h"
+#include "uni_algo/conv.h"
 
 namespace kepler {
+    namespace {
+        // Names a function for the profiler, as it is written in the source.
+        std::string name_of(ASTNode<Operation_ptr>* node) {
+            if(auto function = dynamic_cast<Function*>(node)) {
+                return uni::utf32to8(function->token.content());
+            } else if(auto variable = dynamic_cast<FunctionVariable*>(node)) {
+                return uni::utf32to8(variable->identifier.content());
+            } else if(auto monadic = dynamic_cast<MonadicOperator*>(node)) {
+                return name_of(monadic->child) + uni::utf32to8(monadic->token.content());
+            } else if(auto dyadic = dynamic_cast<DyadicOperator*>(node)) {
+                auto right = std::get_if<ASTNode<Operation_ptr>*>(&dyadic->right);
+                return name_of(dyadic->left) + uni::utf32to8(dyadic->token.content()) + (right ? name_of(*right) : "");
+            }
+            return "{…}";
+        }
+
+        // The number of elements reduced from an expression, which is that of its largest leaf.
+        std::size_t fused_size(const FusedExpression& expression) {
+            if(!expression.op) {
+                return expression.value->data.size();
+            }
+            std::size_t size = 0;
+            for(auto& argument : expression.arguments) {
+                size = std::max(size, fused_size(argument));
+            }
+            return size;
+        }
+    }
+
     Operation_ptr Interpreter::visit(Function *node) {
         return build_operation(node->token.type);
     }
 
     Array Interpreter::visit(Scalar *node) {
-        if (std::holds_alternative<String>(node->content)) {
-            return {{},
-                    {std::get<String>(node->content)}};
-        } else if (std::holds_alternative<Number>(node->content)) {
-            return {{},
-                    {std::get<Number>(node->content)}};
-        } else {
-            throw kepler::Error(InternalError, "Expected either a string or number as Scalar.");
-        }
+        return node->value;
     }
 
     Array Interpreter::visit(Vector *node) {
-        std::vector<Array::element_type> scalars;
+        if(node->value) {
+            return *node->value;
+        }
+
+        Array::buffer_type scalars;
         scalars.reserve(node->children.size());
         for (auto &child: node->children) {
             scalars.emplace_back(child->accept(*this));
         }
-        return {{static_cast<unsigned int>(scalars.size())}, scalars};
+        return {{static_cast<unsigned int>(scalars.size())}, std::move(scalars)};
+    }
+
+    Array Interpreter::visit(Constant *node) {
+        return node->value;
+    }
+
+    Array Interpreter::visit(Invariant *node) {
+        if(!node->value) {
+            node->value = node->child->accept(*this);
+        }
+        return *node->value;
     }
 
     Operation_ptr Interpreter::visit(MonadicOperator *node) {
@@ -65,10 +107,67 @@ namespace kepler {
         throw kepler::Error(InternalError, "Unexpected case reached when evaluating DyadicOperator.");
     }
 
+    FusedExpression Interpreter::fuse(ASTNode<Array>* node) {
+        if(auto monadic = dynamic_cast<MonadicFunction*>(node)) {
+            if(auto function = dynamic_cast<Function*>(monadic->function)) {
+                Operation_ptr f = function->accept(*this);
+                if(f->kernel() && f->kernel()->monadic) {
+                    return FusedExpression::monadic(f, fuse(monadic->omega));
+                }
+            }
+        } else if(auto dyadic = dynamic_cast<DyadicFunction*>(node)) {
+            if(auto function = dynamic_cast<Function*>(dyadic->function)) {
+                Operation_ptr f = function->accept(*this);
+                if(f->kernel() && f->kernel()->dyadic) {
+                    FusedExpression omega = fuse(dyadic->omega);
+                    return FusedExpression::dyadic(f, fuse(dyadic->alpha), std::move(omega));
+                }
+            }
+        }
+
+        return FusedExpression::leaf(node->accept(*this));
+    }
+
     Array Interpreter::visit(MonadicFunction *node) {
         try {
+            if(auto reduction = dynamic_cast<MonadicOperator*>(node->function); reduction && reduction->token.type == SLASH) {
+                // Reductions are fused with the scalar primitives producing their argument.
+                Operation_ptr reducer = reduction->child->accept(*this);
+                FusedExpression expression = fuse(node->omega);
+
+                std::optional<profiler::Scope> scope;
+                if(profiler::enabled()) {
+                    scope.emplace(name_of(node->function));
+                }
+                std::optional<memory::Attribution> attribution;
+                if(memory::attributing()) {
+                    attribution.emplace(name_of(node->function));
+                }
+                sampler::Frame frame(node->function->get_position());
+                Array result = reduce(reducer, expression);
+                if(scope) {
+                    scope->record(fused_size(expression) + result.data.size());
+                }
+                return result;
+            }
+
             Operation_ptr f = node->function->accept(*this);
-            return (*f)(node->omega->accept(*this));
+            Array omega = node->omega->accept(*this);
+
+            std::optional<profiler::Scope> scope;
+            if(profiler::enabled()) {
+                scope.emplace(name_of(node->function));
+            }
+            std::optional<memory::Attribution> attribution;
+            if(memory::attributing()) {
+                attribution.emplace(name_of(node->function));
+            }
+            sampler::Frame frame(node->function->get_position());
+            Array result = (*f)(omega);
+            if(scope) {
+                scope->record(omega.data.size() + result.data.size());
+            }
+            return result;
         } catch (kepler::Error& err) {
             err.position = node->function->get_position();
             throw err;
@@ -77,7 +176,25 @@ namespace kepler {
 
     Array Interpreter::visit(DyadicFunction *node) {
         try {
-            return (*node->function->accept(*this))(node->alpha->accept(*this), node->omega->accept(*this));
+            // Arguments are evaluated right to left.
+            Operation_ptr f = node->function->accept(*this);
+            Array omega = node->omega->accept(*this);
+            Array alpha = node->alpha->accept(*this);
+
+            std::optional<profiler::Scope> scope;
+            if(profiler::enabled()) {
+                scope.emplace(name_of(node->function));
+            }
+            std::optional<memory::Attribution> attribution;
+            if(memory::attributing()) {
+                attribution.emplace(name_of(node->function));
+            }
+            sampler::Frame frame(node->function->get_position());
+            Array result = (*f)(alpha, omega);
+            if(scope) {
+                scope->record(alpha.data.size() + omega.data.size() + result.data.size());
+            }
+            return result;
         } catch (kepler::Error& err) {
             err.position = node->function->get_position();
             throw err;
@@ -85,42 +202,58 @@ namespace kepler {
     }
 
     Operation_ptr Interpreter::visit(AnonymousFunction* node) {
+        for(auto invariant : node->invariants) {
+            invariant->value.reset();
+        }
+
         auto dfn = std::make_shared<DefinedFunction>(node, output_stream);
         node->body->symbol_table->set(constants::recursive_call_id, dfn);
         return dfn;
     }
 
     Operation_ptr Interpreter::visit(FunctionVariable *node) {
-        auto &content = node->identifier.content.value();
-        return symbol_table.get<Operation_ptr>({content.begin(), content.end()});
+        const String& identifier = node->identifier.content();
+        if(identifier == constants::save_workspace_id) {
+            return std::make_shared<SaveWorkspace>(&symbol_table);
+        } else if(identifier == constants::load_workspace_id) {
+            return std::make_shared<LoadWorkspace>(&symbol_table, output_stream);
+        } else if(identifier == constants::read_binary_id) {
+            return std::make_shared<ReadBinary>(&symbol_table);
+        } else if(identifier == constants::write_binary_id) {
+            return std::make_shared<WriteBinary>(&symbol_table);
+        } else if(identifier == constants::read_csv_id) {
+            return std::make_shared<ReadCSV>(&symbol_table);
+        } else if(identifier == constants::profile_id) {
+            return std::make_shared<Profile>(&symbol_table);
+        } else if(identifier == constants::workspace_available_id) {
+            return std::make_shared<WorkspaceAvailable>(&symbol_table);
+        }
+        return symbol_table.get<Operation_ptr>(identifier);
     }
 
     Array Interpreter::visit(Variable *node) {
-        auto &content = node->token.content.value();
-        String identifier = {content.begin(), content.end()};
-        return symbol_table.get<Array>(identifier);
+        return symbol_table.get<Array>(node->token.content());
     }
 
     Array Interpreter::visit(FunctionAssignment *node) {
-        auto &content = node->identifier.content.value();
-        String identifier = {content.begin(), content.end()};
+        const String& identifier = node->identifier.content();
         if(identifier.starts_with(constants::recursive_call_id)) {
             throw kepler::Error(DefinitionError, "Cannot assign a variable to the recursive call symbol.", node->identifier.get_position());
         }
         auto s = node->function->accept(*this);
-        symbol_table.set(identifier, s);
+        symbol_table.set(identifier, s, false, node->definition);
         return {{}, {}};
     }
 
     Array Interpreter::visit(Assignment *node) {
-        auto &content = node->identifier.content.value();
-        String identifier = {content.begin(), content.end()};
+        const String& identifier = node->identifier.content();
         Array value = node->value->accept(*this);
 
         if (identifier.starts_with(U'⎕')) {
             if(identifier.length() == 1) {
                 // Print out.
-                output_stream << value.to_string(&symbol_table) << std::flush;
+                value.print(output_stream, &symbol_table);
+                output_stream << std::flush;
                 return {{}, {}};
             }
 
@@ -138,18 +271,12 @@ namespace kepler {
     }
 
     Array Interpreter::visit(Statements *node) {
-        std::vector<Array> results;
-        results.reserve(node->children.size());
-
+        // Only the value of the last statement is kept, so earlier values are freed as soon as they are replaced.
+        Array result = {{}, {}};
         for (auto& child : node->children) {
-            results.emplace_back(child->accept(*this));
-        }
-
-        if(!results.empty()) {
-            return results.back();
-        } else {
-            return {{}, {}};
+            result = child->accept(*this);
         }
+        return result;
     }
 
     Array Interpreter::visit(Conditional *node) {
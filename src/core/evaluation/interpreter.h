@@ -23,6 +23,7 @@
 #include "core/evaluation/operations/functions.h"
 #include "core/evaluation/operations/monadic_operators.h"
 #include "core/evaluation/operations/dyadic_operators.h"
+#include "core/evaluation/fusion.h"
 #include "core/error.h"
 
 namespace kepler {
@@ -87,6 +88,16 @@ namespace kepler {
                     return std::make_shared<Not>(&symbol_table);
                 } else if(type == IOTA) {
                     return std::make_shared<Iota>(&symbol_table);
+                } else if(type == EPSILON) {
+                    return std::make_shared<Epsilon>(&symbol_table);
+                } else if(type == DOWN_SHOE) {
+                    return std::make_shared<DownShoe>(&symbol_table);
+                } else if(type == UP_SHOE) {
+                    return std::make_shared<UpShoe>(&symbol_table);
+                } else if(type == DELTA_STILE) {
+                    return std::make_shared<DeltaStile>(&symbol_table);
+                } else if(type == DEL_STILE) {
+                    return std::make_shared<DelStile>(&symbol_table);
                 } else if(type == RHO) {
                     return std::make_shared<Rho>(&symbol_table);
                 } else if(type == CIRCLE_BAR) {
@@ -140,9 +151,23 @@ namespace kepler {
                                                std::to_string(sizeof...(args)) + " operations.");
         }
 
+        /**
+         * Evaluates the arguments of a chain of scalar primitives, but not the primitives themselves.
+         *
+         * Applications of primitives with a ScalarKernel become inner nodes of the
+         * resulting FusedExpression, and every other expression is evaluated into a leaf.
+         * As usual, arguments are evaluated right-to-left.
+         *
+         * @param node The expression to fuse.
+         * @return The FusedExpression equivalent to node.
+         */
+        FusedExpression fuse(ASTNode<Array>* node);
+
         Operation_ptr visit(Function *node) override;
         Array visit(Scalar *node) override;
         Array visit(Vector *node) override;
+        Array visit(Constant *node) override;
+        Array visit(Invariant *node) override;
         Operation_ptr visit(MonadicOperator *node) override;
         Operation_ptr visit(DyadicOperator *node) override;
         Array visit(MonadicFunction *node) override;
@@ -47,6 +47,20 @@ namespace kepler {
          */
         virtual Array visit(Vector* node) = 0;
 
+        /**
+         * Visit a constant node.
+         * @param node Node to visit
+         * @return The result of visiting the node.
+         */
+        virtual Array visit(Constant* node) = 0;
+
+        /**
+         * Visit an invariant node.
+         * @param node Node to visit
+         * @return The result of visiting the node.
+         */
+        virtual Array visit(Invariant* node) = 0;
+
         /**
          * Visit a monadic operator node.
          * @param node Node to visit
@@ -20,6 +20,7 @@
 #include "dyadic_operators.h"
 #include "monadic_operators.h"
 #include "core/error.h"
+#include "core/evaluation/fusion.h"
 
 namespace kepler {
     DyadicOp::DyadicOp(Operation_ptr aalpha_, Operation_ptr oomega_) : aalpha(std::move(aalpha_)), oomega(std::move(oomega_)), Operation(
@@ -50,6 +51,13 @@ namespace kepler {
     }
 
     Array InnerProduct::operator()(const Array &alpha, const Array &omega) {
+        if(auto kernel = aalpha->kernel(); kernel && kernel->dyadic) {
+            auto expression = FusedExpression::dyadic(oomega, FusedExpression::leaf(alpha), FusedExpression::leaf(omega));
+            if(auto result = fused_reduce(*kernel, expression)) {
+                return {*result};
+            }
+        }
+
         Diaeresis diaeresis(oomega);
         Slash slash(aalpha);
 
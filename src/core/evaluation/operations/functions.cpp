@@ -26,139 +26,255 @@
 #include <cmath>
 #include "core/symbol_table.h"
 #include "core/evaluation/algorithms.h"
+#include "core/evaluation/hashing.h"
+#include "core/evaluation/sorting.h"
 #include "core/array.h"
 #include "core/literals.h"
 #include "core/helpers.h"
 
 namespace kepler {
+    Number Plus::dyadic(const Number& alpha, const Number& omega) {
+        return alpha + omega;
+    }
+
     Array Plus::operator()(const Number& alpha, const Number& omega) {
-        return {alpha + omega};
+        return {dyadic(alpha, omega)};
+    }
+
+    Number Plus::monadic(const Number& omega) {
+        return conj(omega);
     }
 
     Array Plus::operator()(const Number& omega) {
-        return {conj(omega)};
+        return {monadic(omega)};
+    }
+
+    const ScalarKernel* Plus::kernel() const {
+        static const ScalarKernel kernel{&Plus::monadic, &Plus::dyadic, true};
+        return &kernel;
+    }
+
+    Number Minus::dyadic(const Number& alpha, const Number& omega) {
+        return alpha - omega;
     }
 
     Array Minus::operator()(const Number& alpha, const Number& omega) {
-        return {alpha - omega};
+        return {dyadic(alpha, omega)};
+    }
+
+    Number Minus::monadic(const Number& omega) {
+        return omega * -1.0;
     }
 
     Array Minus::operator()(const Number& omega) {
-        return {omega * -1.0};
+        return {monadic(omega)};
+    }
+
+    const ScalarKernel* Minus::kernel() const {
+        static const ScalarKernel kernel{&Minus::monadic, &Minus::dyadic, false};
+        return &kernel;
+    }
+
+    Number Times::dyadic(const Number& alpha, const Number& omega) {
+        return alpha * omega;
     }
 
     Array Times::operator()(const Number& alpha, const Number& omega) {
-        return {alpha * omega};
+        return {dyadic(alpha, omega)};
+    }
+
+    Number Times::monadic(const Number& omega) {
+        return (omega == 0.0) ? omega : omega / abs(omega);
     }
 
     Array Times::operator()(const Number& omega) {
-        return {(omega == 0.0) ? omega : omega / abs(omega)};
+        return {monadic(omega)};
     }
 
-    Array Divide::operator()(const Number& alpha, const Number& omega) {
+    const ScalarKernel* Times::kernel() const {
+        static const ScalarKernel kernel{&Times::monadic, &Times::dyadic, true};
+        return &kernel;
+    }
+
+    Number Divide::dyadic(const Number& alpha, const Number& omega) {
         if(omega == 0.0) {
             if(alpha != 0.0) {
                 throw kepler::Error(DomainError, "Division by 0 is undefined.");
             } else {
-                return {1};
+                return 1;
             }
         }
-        return {alpha / omega};
+        return alpha / omega;
     }
 
-    Array Divide::operator()(const Number& omega) {
+    Array Divide::operator()(const Number& alpha, const Number& omega) {
+        return {dyadic(alpha, omega)};
+    }
+
+    Number Divide::monadic(const Number& omega) {
         if(omega == 0.0) {
             throw kepler::Error(DomainError, "Reciprocal of 0 is undefined.");
         }
-        return {1.0 / omega};
+        return 1.0 / omega;
     }
 
-    Array Ceiling::operator()(const Number& alpha, const Number& omega) {
+    Array Divide::operator()(const Number& omega) {
+        return {monadic(omega)};
+    }
+
+    const ScalarKernel* Divide::kernel() const {
+        static const ScalarKernel kernel{&Divide::monadic, &Divide::dyadic, false};
+        return &kernel;
+    }
+
+    Number Ceiling::dyadic(const Number& alpha, const Number& omega) {
         if(alpha.imag() != 0.0 || omega.imag() != 0.0) {
             throw kepler::Error(DomainError, "Maximum of complex numbers is undefined.");
         }
 
-        return {std::max(alpha.real(), omega.real())};
+        return std::max(alpha.real(), omega.real());
+    }
+
+    Array Ceiling::operator()(const Number& alpha, const Number& omega) {
+        return {dyadic(alpha, omega)};
+    }
+
+    Number Ceiling::monadic(const Number& omega) {
+        return -1.0 * kepler::floor(-1.0 * omega);
     }
 
     Array Ceiling::operator()(const Number& omega) {
-        return {-1.0 * kepler::floor(-1.0 * omega)};
+        return {monadic(omega)};
     }
 
-    Array Floor::operator()(const Number& alpha, const Number& omega) {
+    const ScalarKernel* Ceiling::kernel() const {
+        static const ScalarKernel kernel{&Ceiling::monadic, &Ceiling::dyadic, true};
+        return &kernel;
+    }
+
+    Number Floor::dyadic(const Number& alpha, const Number& omega) {
         if(alpha.imag() != 0.0 || omega.imag() != 0.0) {
             throw kepler::Error(DomainError, "Minimum of complex numbers is undefined.");
         }
 
-        return {std::min(alpha.real(), omega.real())};
+        return std::min(alpha.real(), omega.real());
+    }
+
+    Array Floor::operator()(const Number& alpha, const Number& omega) {
+        return {dyadic(alpha, omega)};
+    }
+
+    Number Floor::monadic(const Number& omega) {
+       return kepler::floor(omega);
     }
 
     Array Floor::operator()(const Number& omega) {
-       return {kepler::floor(omega)};
+        return {monadic(omega)};
+    }
+
+    const ScalarKernel* Floor::kernel() const {
+        static const ScalarKernel kernel{&Floor::monadic, &Floor::dyadic, true};
+        return &kernel;
     }
 
-    Array And::operator()(const Number &alpha, const Number &omega) {
+    Number And::dyadic(const Number& alpha, const Number& omega) {
         if(alpha.imag() != 0.00 || omega.imag() != 0.0) {
             throw kepler::Error(DomainError, "Least common multiple of complex numbers is unsupported.");
         } else if(round(alpha.real()) != alpha.real() || round(omega.real()) != omega.real()) {
             throw kepler::Error(DomainError, "Least common multiple of fractional numbers is unsupported.");
         }
-        return {std::lcm((int) alpha.real(), (int) omega.real())};
+        return std::lcm((int) alpha.real(), (int) omega.real());
     }
 
-    Array And::operator()(const String &alpha, const String &omega) {
-        throw kepler::Error(DomainError, "The function is undefined on string arguments.");
+    Array And::operator()(const Number& alpha, const Number& omega) {
+        return {dyadic(alpha, omega)};
+    }
+
+    const ScalarKernel* And::kernel() const {
+        static const ScalarKernel kernel{nullptr, &And::dyadic, true};
+        return &kernel;
+    }
+
+    Array And::operator()(const Char &alpha, const Char &omega) {
+        throw kepler::Error(DomainError, "The function is undefined on character arguments.");
     }
 
     Array And::operator()(const Number &omega) {
         throw kepler::Error(SyntaxError, "The function requires a left argument.");
     }
 
-    Array Nand::operator()(const Number &alpha, const Number &omega) {
+    Number Nand::dyadic(const Number& alpha, const Number& omega) {
         if(alpha.imag() != 0.00 || omega.imag() != 0.0) {
             throw kepler::Error(DomainError, "Logical NAND of complex numbers is unsupported.");
         } else if((alpha.real() != 1.0 && alpha.real() != 0.0) || (omega.real() != 1.0 && omega.real() != 0.0)) {
             throw kepler::Error(DomainError, "Logical NAND of non-boolean numbers is unsupported.");
         }
-        return {1.0 - std::lcm((int) alpha.real(), (int) omega.real())};
+        return 1.0 - std::lcm((int) alpha.real(), (int) omega.real());
+    }
+
+    Array Nand::operator()(const Number& alpha, const Number& omega) {
+        return {dyadic(alpha, omega)};
+    }
+
+    const ScalarKernel* Nand::kernel() const {
+        static const ScalarKernel kernel{nullptr, &Nand::dyadic, false};
+        return &kernel;
     }
 
     Array Nand::operator()(const Number &omega) {
         throw kepler::Error(SyntaxError, "The function requires a left argument.");
     }
 
-    Array Nand::operator()(const String &alpha, const String &omega) {
-        throw kepler::Error(DomainError, "The function is undefined on string arguments.");
+    Array Nand::operator()(const Char &alpha, const Char &omega) {
+        throw kepler::Error(DomainError, "The function is undefined on character arguments.");
     }
 
-    Array Or::operator()(const Number &alpha, const Number &omega) {
+    Number Or::dyadic(const Number& alpha, const Number& omega) {
         if(alpha.imag() != 0.00 || omega.imag() != 0.0) {
             throw kepler::Error(DomainError, "Greatest common divisor of complex numbers is unsupported.");
         } else if(round(alpha.real()) != alpha.real() || round(omega.real()) != omega.real()) {
             throw kepler::Error(DomainError, "Greatest common divisor of fractional numbers is unsupported.");
         }
-        return {std::gcd((int) alpha.real(), (int) omega.real())};
+        return std::gcd((int) alpha.real(), (int) omega.real());
+    }
+
+    Array Or::operator()(const Number& alpha, const Number& omega) {
+        return {dyadic(alpha, omega)};
+    }
+
+    const ScalarKernel* Or::kernel() const {
+        static const ScalarKernel kernel{nullptr, &Or::dyadic, true};
+        return &kernel;
     }
 
     Array Or::operator()(const Number &omega) {
         throw kepler::Error(SyntaxError, "The function requires a left argument.");
     }
 
-    Array Or::operator()(const String &alpha, const String &omega) {
-        throw kepler::Error(DomainError, "The function is undefined on string arguments.");
+    Array Or::operator()(const Char &alpha, const Char &omega) {
+        throw kepler::Error(DomainError, "The function is undefined on character arguments.");
     }
 
-    Array Nor::operator()(const Number &alpha, const Number &omega) {
+    Number Nor::dyadic(const Number& alpha, const Number& omega) {
         if(alpha.imag() != 0.00 || omega.imag() != 0.0) {
             throw kepler::Error(DomainError, "Logical NOR of complex numbers is unsupported.");
         } else if((alpha.real() != 1.0 && alpha.real() != 0.0) || (omega.real() != 1.0 && omega.real() != 0.0)) {
             throw kepler::Error(DomainError, "Logical NOR of non-boolean numbers is unsupported.");
         }
-        return {1.0 - std::gcd((int) alpha.real(), (int) omega.real())};
+        return 1.0 - std::gcd((int) alpha.real(), (int) omega.real());
+    }
+
+    Array Nor::operator()(const Number& alpha, const Number& omega) {
+        return {dyadic(alpha, omega)};
     }
 
-    Array Nor::operator()(const String &alpha, const String &omega) {
-        throw kepler::Error(DomainError, "The function is undefined on string arguments.");
+    const ScalarKernel* Nor::kernel() const {
+        static const ScalarKernel kernel{nullptr, &Nor::dyadic, false};
+        return &kernel;
+    }
+
+    Array Nor::operator()(const Char &alpha, const Char &omega) {
+        throw kepler::Error(DomainError, "The function is undefined on character arguments.");
     }
 
     Array Nor::operator()(const Number &omega) {
@@ -181,65 +297,147 @@ namespace kepler {
         return omega;
     }
 
-    Array Less::operator()(const Number& alpha, const Number& omega) {
+    Number Less::dyadic(const Number& alpha, const Number& omega) {
         if(alpha.imag() != 0.00 || omega.imag() != 0.0) {
             throw kepler::Error(DomainError, "Less-than of complex numbers is unsupported.");
         }
 
-        return {alpha.real() < omega.real()};
+        return alpha.real() < omega.real();
     }
 
-    Array LessEq::operator()(const Number& alpha, const Number& omega) {
+    Array Less::operator()(const Number& alpha, const Number& omega) {
+        return {dyadic(alpha, omega)};
+    }
+
+    const ScalarKernel* Less::kernel() const {
+        static const ScalarKernel kernel{nullptr, &Less::dyadic, false};
+        return &kernel;
+    }
+
+    Array Less::operator()(const Char &alpha, const Char &omega) {
+        return {Number(alpha < omega)};
+    }
+
+    Number LessEq::dyadic(const Number& alpha, const Number& omega) {
         if(alpha.imag() != 0.00 || omega.imag() != 0.0) {
             throw kepler::Error(DomainError, "Less-than-or-equal of complex numbers is unsupported.");
         }
 
-        return {alpha.real() <= omega.real()};
+        return alpha.real() <= omega.real();
+    }
+
+    Array LessEq::operator()(const Number& alpha, const Number& omega) {
+        return {dyadic(alpha, omega)};
+    }
+
+    const ScalarKernel* LessEq::kernel() const {
+        static const ScalarKernel kernel{nullptr, &LessEq::dyadic, false};
+        return &kernel;
+    }
+
+    Array LessEq::operator()(const Char &alpha, const Char &omega) {
+        return {Number(alpha <= omega)};
+    }
+
+    Number Eq::dyadic(const Number& alpha, const Number& omega) {
+        return alpha == omega;
     }
 
     Array Eq::operator()(const Number& alpha, const Number& omega) {
-        return {alpha == omega};
+        return {dyadic(alpha, omega)};
+    }
+
+    const ScalarKernel* Eq::kernel() const {
+        static const ScalarKernel kernel{nullptr, &Eq::dyadic, false};
+        return &kernel;
     }
 
     Array Eq::operator()(const Char &alpha, const Char &omega) {
-        return {alpha == omega};
+        return {Number(alpha == omega)};
     }
 
-    Array GreaterEq::operator()(const Number& alpha, const Number& omega) {
+    Array Eq::operator()(const Char &alpha, const Number &omega) {
+        return {Number(0.0)};
+    }
+
+    Array Eq::operator()(const Number &alpha, const Char &omega) {
+        return {Number(0.0)};
+    }
+
+    Number GreaterEq::dyadic(const Number& alpha, const Number& omega) {
         if(alpha.imag() != 0.00 || omega.imag() != 0.0) {
             throw kepler::Error(DomainError, "Greater-than of complex numbers is unsupported.");
         }
 
-        return {alpha.real() >= omega.real()};
+        return alpha.real() >= omega.real();
     }
 
-    Array Greater::operator()(const Number& alpha, const Number& omega) {
+    Array GreaterEq::operator()(const Number& alpha, const Number& omega) {
+        return {dyadic(alpha, omega)};
+    }
+
+    const ScalarKernel* GreaterEq::kernel() const {
+        static const ScalarKernel kernel{nullptr, &GreaterEq::dyadic, false};
+        return &kernel;
+    }
+
+    Array GreaterEq::operator()(const Char &alpha, const Char &omega) {
+        return {Number(alpha >= omega)};
+    }
+
+    Number Greater::dyadic(const Number& alpha, const Number& omega) {
         if(alpha.imag() != 0.00 || omega.imag() != 0.0) {
             throw kepler::Error(DomainError, "Greater-than of complex numbers is unsupported.");
         }
 
-        return {alpha.real() > omega.real()};
+        return alpha.real() > omega.real();
+    }
+
+    Array Greater::operator()(const Number& alpha, const Number& omega) {
+        return {dyadic(alpha, omega)};
+    }
+
+    const ScalarKernel* Greater::kernel() const {
+        static const ScalarKernel kernel{nullptr, &Greater::dyadic, false};
+        return &kernel;
+    }
+
+    Array Greater::operator()(const Char &alpha, const Char &omega) {
+        return {Number(alpha > omega)};
+    }
+
+    Number Neq::dyadic(const Number& alpha, const Number& omega) {
+        return alpha != omega;
+    }
+
+    Array Neq::operator()(const Number& alpha, const Number& omega) {
+        return {dyadic(alpha, omega)};
     }
 
-    Array Neq::operator()(const Number &alpha, const Number &omega) {
-        return {alpha != omega};
+    const ScalarKernel* Neq::kernel() const {
+        static const ScalarKernel kernel{nullptr, &Neq::dyadic, false};
+        return &kernel;
     }
 
     Array Neq::operator()(const Char &alpha, const Char &omega) {
-        return {alpha != omega};
+        return {Number(alpha != omega)};
+    }
+
+    Array Neq::operator()(const Char &alpha, const Number &omega) {
+        return {Number(1.0)};
+    }
+
+    Array Neq::operator()(const Number &alpha, const Char &omega) {
+        return {Number(1.0)};
     }
 
     Array Neq::operator()(const Array &omega) {
         Array result = omega;
-        std::vector<Array::element_type> seen;
+        auto first = index_of(omega.data, omega.data);
 
+        auto& elements = result.data.mutate();
         for(int i = 0; i < omega.size(); ++i) {
-            if(std::count(seen.begin(), seen.end(), omega.data[i]) == 0) {
-                seen.push_back(omega.data[i]);
-                result.data[i] = Array{{}, {1}};
-            } else {
-                result.data[i] = Array{{}, {0}};
-            }
+            elements[i] = Array{{}, {Number(first[i] == static_cast<std::size_t>(i))}};
         }
 
         return result;
@@ -254,20 +452,24 @@ namespace kepler {
     }
 
     Array LeftShoe::operator()(const Array &alpha, const Array &omega) {
-        if(alpha.size() > omega.size()) {
-            if(holds_alternative<String>(omega.data[0])) {
-                return partitioned_enclose(alpha, get<String>(omega.data[0]));
-            }
-        }
         return partitioned_enclose(alpha, omega);
     }
 
-    Array Not::operator()(const Number &omega) {
+    Number Not::monadic(const Number& omega) {
         if(omega != 0.0 && omega != 1.0) {
             throw kepler::Error(DomainError, "Expected an array of boolean values.");
         }
 
-        return {!(bool)omega.real()};
+        return !(bool)omega.real();
+    }
+
+    Array Not::operator()(const Number& omega) {
+        return {monadic(omega)};
+    }
+
+    const ScalarKernel* Not::kernel() const {
+        static const ScalarKernel kernel{&Not::monadic, nullptr, false};
+        return &kernel;
     }
 
     Array Not::operator()(const Array &alpha, const Array &omega) {
@@ -275,16 +477,6 @@ namespace kepler {
             throw kepler::Error(RankError, "Incompatible ranks.");
         }
 
-        if((alpha.rank() == 0 && !alpha.is_numeric()) || (omega.rank() == 0 && !omega.is_numeric())) {
-            // Individual element.
-            return std::visit(*this, alpha.data[0], omega.data[0]);
-        } else {
-            // Rank 1.
-            return without(alpha, omega);
-        }
-    }
-
-    Array Not::operator()(const String &alpha, const String &omega) {
         return without(alpha, omega);
     }
 
@@ -316,10 +508,216 @@ namespace kepler {
         return result;
     }
 
+    // Returns the elements of array as a list of boxed elements.
+    Storage<Array::element_type> list_elements(const Array& array) {
+        if(!array.is_simple_scalar()) {
+            return array.data;
+        }
+        return {Array{array.data[0]}};
+    }
+
+    bool is_text(const Array& array) {
+        return array.data.text() != nullptr;
+    }
+
+    // Builds the vector of a set function. If both arguments were stored as text, so is the result.
+    Array list_result(Storage<Array::element_type> elements, bool text) {
+        if(text) {
+            String result;
+            result.reserve(elements.size());
+            for(auto& element : elements) {
+                result += std::get<Char>(std::get<Array>(element).data[0]);
+            }
+            return Array(Text(result));
+        }
+
+        return {{static_cast<unsigned int>(elements.size())}, std::move(elements)};
+    }
+
+    void check_set_argument(const Array& array) {
+        if(array.rank() > 1) {
+            throw kepler::Error(RankError, "Expected a scalar or vector argument.");
+        }
+    }
+
+    Array Iota::operator()(const Array &alpha, const Array &omega) {
+        check_set_argument(alpha);
+
+        auto haystack = list_elements(alpha);
+        auto found = index_of(haystack, list_elements(omega));
+
+        Array io = symbol_table->get<Array>(constants::index_origin_id);
+        Number origin = get<Number>(io.data[0]);
+
+        Storage<Array::element_type> result;
+        result.reserve(found.size());
+        for(auto position : found) {
+            auto index = static_cast<double>(position == not_found ? haystack.size() : position);
+            result.emplace_back(Array{index + origin});
+        }
+
+        if(omega.is_scalar()) {
+            return std::get<Array>(result[0]);
+        }
+        return {omega.shape, std::move(result)};
+    }
+
+    Array Epsilon::operator()(const Array &alpha, const Array &omega) {
+        auto found = index_of(list_elements(omega), list_elements(alpha));
+
+        Storage<Array::element_type> result;
+        result.reserve(found.size());
+        for(auto position : found) {
+            result.emplace_back(Array{Number(position != not_found)});
+        }
+
+        if(alpha.is_scalar()) {
+            return std::get<Array>(result[0]);
+        }
+        return {alpha.shape, std::move(result)};
+    }
+
+    Array DownShoe::operator()(const Array &omega) {
+        check_set_argument(omega);
+
+        auto elements = list_elements(omega);
+        auto first = index_of(elements, elements);
+
+        Storage<Array::element_type> result;
+        for(std::size_t i = 0; i < elements.size(); ++i) {
+            if(first[i] == i) {
+                result.emplace_back(elements[i]);
+            }
+        }
+        return list_result(std::move(result), is_text(omega));
+    }
+
+    Array DownShoe::operator()(const Array &alpha, const Array &omega) {
+        check_set_argument(alpha);
+        check_set_argument(omega);
+
+        auto left = list_elements(alpha);
+        auto right = list_elements(omega);
+        auto found = index_of(left, right);
+
+        Storage<Array::element_type> result = left;
+        for(std::size_t i = 0; i < right.size(); ++i) {
+            if(found[i] == not_found) {
+                result.emplace_back(right[i]);
+            }
+        }
+        return list_result(std::move(result), is_text(alpha) && is_text(omega));
+    }
+
+    Array UpShoe::operator()(const Array &alpha, const Array &omega) {
+        check_set_argument(alpha);
+        check_set_argument(omega);
+
+        auto left = list_elements(alpha);
+        auto found = index_of(list_elements(omega), left);
+
+        Storage<Array::element_type> result;
+        for(std::size_t i = 0; i < left.size(); ++i) {
+            if(found[i] != not_found) {
+                result.emplace_back(left[i]);
+            }
+        }
+        return list_result(std::move(result), is_text(alpha) && is_text(omega));
+    }
+
+    // Returns the simple value of the element at index, looking through a boxed scalar.
+    const Array::element_type& simple_element(const Array& array, std::size_t index) {
+        const auto& element = array.data[index];
+        if(auto boxed = std::get_if<Array>(&element); boxed && boxed->is_simple_scalar()) {
+            return boxed->data[0];
+        }
+        return element;
+    }
+
+    // Returns the permutation which stably sorts the major cells of omega, comparing them element by element.
+    std::vector<std::size_t> grade_cells(const Array& omega, bool descending) {
+        if(omega.rank() == 1 && is_text(omega)) {
+            auto chars = omega.data.text()->to_string();
+            return grade(std::span<const Char>(chars.data(), chars.size()), descending);
+        } else if(omega.is_scalar()) {
+            throw kepler::Error(RankError, "Expected a non-scalar argument to grade.");
+        }
+
+        std::size_t rows = omega.shape[0];
+        std::size_t columns = rows == 0 ? 0 : omega.size() / rows;
+
+        std::vector<std::size_t> order(rows);
+        std::iota(order.begin(), order.end(), 0);
+
+        // Sorting stably by each column, from the last to the first, sorts the rows lexicographically.
+        for(std::size_t column = columns; column-- > 0;) {
+            std::vector<std::int64_t> integers;
+            std::vector<double> reals;
+            std::vector<Char> chars;
+            bool integral = true;
+
+            for(auto row : order) {
+                const auto& element = simple_element(omega, row * columns + column);
+                if(auto number = std::get_if<Number>(&element)) {
+                    if(number->imag() != 0.0) {
+                        throw kepler::Error(DomainError, "Complex numbers cannot be graded.");
+                    }
+                    double real = number->real();
+                    integral = integral && real == std::round(real) && std::abs(real) < 9.2e18;
+                    reals.emplace_back(real);
+                } else if(auto c = std::get_if<Char>(&element)) {
+                    chars.emplace_back(*c);
+                } else {
+                    throw kepler::Error(DomainError, "Only simple numeric or character arrays can be graded.");
+                }
+            }
+
+            std::vector<std::size_t> permutation;
+            if(!chars.empty() && !reals.empty()) {
+                throw kepler::Error(DomainError, "Mixed numeric and character arrays cannot be graded.");
+            } else if(!chars.empty()) {
+                permutation = grade(std::span<const Char>(chars), descending);
+            } else if(integral) {
+                integers.assign(reals.begin(), reals.end());
+                permutation = grade(std::span<const std::int64_t>(integers), descending);
+            } else {
+                permutation = grade(std::span<const double>(reals), descending);
+            }
+
+            std::vector<std::size_t> reordered(rows);
+            for(std::size_t i = 0; i < rows; ++i) {
+                reordered[i] = order[permutation[i]];
+            }
+            order = std::move(reordered);
+        }
+
+        return order;
+    }
+
+    Array grade_result(const std::vector<std::size_t>& order, SymbolTable* symbol_table) {
+        Array io = symbol_table->get<Array>(constants::index_origin_id);
+        Number origin = get<Number>(io.data[0]);
+
+        Storage<Array::element_type> result;
+        result.reserve(order.size());
+        for(auto position : order) {
+            result.emplace_back(Array{static_cast<double>(position) + origin});
+        }
+        return {{static_cast<unsigned int>(order.size())}, std::move(result)};
+    }
+
+    Array DeltaStile::operator()(const Array &omega) {
+        return grade_result(grade_cells(omega, false), symbol_table);
+    }
+
+    Array DelStile::operator()(const Array &omega) {
+        return grade_result(grade_cells(omega, true), symbol_table);
+    }
+
     Array Rho::operator()(const Array& omega) {
         Array result{{static_cast<unsigned int>(omega.shape.size())}, {}};
         for(auto& dim : omega.shape) {
-            result.data.emplace_back(Array{{}, {dim}});
+            result.data.emplace_back(Array{{}, {Number(dim)}});
         }
         return result;
     }
@@ -373,11 +771,12 @@ namespace kepler {
         int block_size = get_block_size(omega.shape, axis);
 
         Array result = omega;
+        auto& elements = result.data.mutate();
         for(int i = 0; i < omega.size(); ++i) {
             int shift = get_shift(i, axis, step_size, alpha, omega);
 
             int index = (int)(std::floor((double)i / block_size) * block_size) + (((step_size * shift + i) % block_size + block_size) % block_size);//((step_size * shift + i) % (block_size));
-            result.data[i] = omega.data[index];
+            elements[i] = omega.data[index];
         }
         return result;
     }
@@ -388,11 +787,12 @@ namespace kepler {
         int block_size = get_block_size(omega.shape, axis);
 
         Array result = omega;
+        auto& elements = result.data.mutate();
         for(int i = 0; i < omega.size(); ++i) {
             int width = omega.shape[axis];
             double shift = (width - 1) - 2 * ((int)std::floor((double)i / step_size) % width);
             int index = (int)(std::floor((double)i / block_size) * block_size) + ((step_size * (int)shift + i) % (block_size));
-            result.data[i] = omega.data[index];
+            elements[i] = omega.data[index];
         }
         return result;
     }
@@ -401,14 +801,12 @@ namespace kepler {
         return {omega};
     }
 
-    Array CircleBar::operator()(const String &omega) {
-        return {String{omega.rbegin(), omega.rend()}};
+    Array CircleBar::operator()(const Char &omega) {
+        return {omega};
     }
 
-    Array CircleBar::operator()(const Number &shift, const String &omega) {
-        String result = omega;
-        std::rotate(result.begin(), result.begin() + (int)shift.real(), result.end());
-        return {result};
+    Array CircleBar::operator()(const Number &shift, const Char &omega) {
+        return {omega};
     }
 
     Array CircleBar::operator()(const Number &shift, const Number &omega) {
@@ -477,14 +875,12 @@ namespace kepler {
         return {omega};
     }
 
-    Array CircleStile::operator()(const String &omega) {
-        return {String{omega.rbegin(), omega.rend()}};
+    Array CircleStile::operator()(const Char &omega) {
+        return {omega};
     }
 
-    Array CircleStile::operator()(const Number &shift, const String &omega) {
-        String result = omega;
-        std::rotate(result.begin(), result.begin() + (int)shift.real(), result.end());
-        return {result};
+    Array CircleStile::operator()(const Number &shift, const Char &omega) {
+        return {omega};
     }
 
     Array CircleStile::operator()(const Number &shift, const Number &omega) {
@@ -626,73 +1022,134 @@ namespace kepler {
         }
     }
 
-    Array Star::operator()(const Number &omega) {
-        return {exp(omega)};
+    Number Star::monadic(const Number& omega) {
+        return exp(omega);
+    }
+
+    Array Star::operator()(const Number& omega) {
+        return {monadic(omega)};
     }
 
-    Array Star::operator()(const Number &alpha, const Number &omega) {
+    Number Star::dyadic(const Number& alpha, const Number& omega) {
         if(alpha == 0.0 && omega == 0.0) {
-            return {1};
+            return 1;
         } else if(alpha == 0.0) {
             if(omega.real() > 0.0) {
-                return {0};
+                return 0;
             } else {
                 throw kepler::Error(DomainError, "0 to the power of a negative number is undefined.");
             }
         }
 
-        return {std::pow(alpha, omega)};
+        return std::pow(alpha, omega);
     }
 
-    Array Log::operator()(const Number &omega) {
+    Array Star::operator()(const Number& alpha, const Number& omega) {
+        return {dyadic(alpha, omega)};
+    }
+
+    const ScalarKernel* Star::kernel() const {
+        static const ScalarKernel kernel{&Star::monadic, &Star::dyadic, false};
+        return &kernel;
+    }
+
+    Number Log::monadic(const Number& omega) {
         if(omega == 0.0) {
             throw kepler::Error(DomainError, "Natural logarithm of 0 is undefined.");
         }
 
-        return {log(omega)};
+        return log(omega);
     }
 
-    Array Log::operator()(const Number &alpha, const Number &omega) {
+    Array Log::operator()(const Number& omega) {
+        return {monadic(omega)};
+    }
+
+    Number Log::dyadic(const Number& alpha, const Number& omega) {
         if(alpha == omega) {
-            return {1};
+            return 1;
         } else if(alpha == 1.0) {
             throw kepler::Error(DomainError, "Logarithm of base 1 is undefined.");
         }
 
-        return { log(omega) / log(alpha) };
+        return log(omega) / log(alpha);
+    }
+
+    Array Log::operator()(const Number& alpha, const Number& omega) {
+        return {dyadic(alpha, omega)};
+    }
+
+    const ScalarKernel* Log::kernel() const {
+        static const ScalarKernel kernel{&Log::monadic, &Log::dyadic, false};
+        return &kernel;
     }
 
-    Array Bar::operator()(const Number &omega) {
-        return {abs(omega)};
+    Number Bar::monadic(const Number& omega) {
+        return abs(omega);
     }
 
-    Array Bar::operator()(const Number &alpha, const Number &omega) {
+    Array Bar::operator()(const Number& omega) {
+        return {monadic(omega)};
+    }
+
+    Number Bar::dyadic(const Number& alpha, const Number& omega) {
         if(alpha == 0.0) {
             throw kepler::Error(DomainError, "Expected a non-zero left argument.");
         }
 
-        return {omega - alpha * kepler::floor(omega / (alpha + (double)(0.0 == omega)))};
+        return omega - alpha * kepler::floor(omega / (alpha + (double)(0.0 == omega)));
+    }
+
+    Array Bar::operator()(const Number& alpha, const Number& omega) {
+        return {dyadic(alpha, omega)};
     }
 
-    Array ExclamationMark::operator()(const Number &omega) {
+    const ScalarKernel* Bar::kernel() const {
+        static const ScalarKernel kernel{&Bar::monadic, &Bar::dyadic, false};
+        return &kernel;
+    }
+
+    Number ExclamationMark::monadic(const Number& omega) {
         if(omega.imag() != 0.0) {
             throw kepler::Error(DomainError, "Factorial of complex numbers is undefined.");
         } if(omega.real() < 0.0 && omega.real() == round(omega.real())) {
             throw kepler::Error(DomainError, "Factorial of negative integers is undefined.");
         }
 
-        return {tgamma(omega.real() + 1)};
+        return tgamma(omega.real() + 1);
+    }
+
+    Array ExclamationMark::operator()(const Number& omega) {
+        return {monadic(omega)};
+    }
+
+    Number ExclamationMark::dyadic(const Number& alpha, const Number& omega) {
+        return kepler::binomial(alpha, omega);
+    }
+
+    Array ExclamationMark::operator()(const Number& alpha, const Number& omega) {
+        return {dyadic(alpha, omega)};
+    }
+
+    const ScalarKernel* ExclamationMark::kernel() const {
+        static const ScalarKernel kernel{&ExclamationMark::monadic, &ExclamationMark::dyadic, false};
+        return &kernel;
     }
 
-    Array ExclamationMark::operator()(const Number &alpha, const Number &omega) {
-        return {kepler::binomial(alpha, omega)};
+    Number Circle::monadic(const Number& omega) {
+        return M_PI * omega;
     }
 
-    Array Circle::operator()(const Number &omega) {
-        return {M_PI * omega};
+    Array Circle::operator()(const Number& omega) {
+        return {monadic(omega)};
     }
 
-    Array Circle::operator()(const Number &alpha, const Number &omega) {
+    const ScalarKernel* Circle::kernel() const {
+        static const ScalarKernel kernel{&Circle::monadic, &Circle::dyadic, false};
+        return &kernel;
+    }
+
+    Number Circle::dyadic(const Number& alpha, const Number& omega) {
         if(alpha.imag() != 0.0) {
             throw kepler::Error(DomainError, "Left argument cannot be complex.");
         } else if(alpha.real() != round(alpha.real())) {
@@ -706,76 +1163,80 @@ namespace kepler {
 
         switch (designator) {
             case -12:
-                return {std::exp(omega * Number(0, 1))};
+                return std::exp(omega * Number(0, 1));
             case -11:
-                return {Number(0, 1) * omega};
+                return Number(0, 1) * omega;
             case -10:
-                return {std::conj(omega)};
+                return std::conj(omega);
             case -9:
-                return {omega};
+                return omega;
             case -8:
-                return {-1.0 * pow(-1.0 - pow(omega, 2), 0.5)};
+                return -1.0 * pow(-1.0 - pow(omega, 2), 0.5);
             case -7:
                 if(omega == -1.0 || omega == 1.0) {
                     throw kepler::Error(DomainError, "Inverse hyperbolic tangent undefined for " +
                                                      kepler::helpers::number_to_string(omega, 2));
                 }
 
-                return {atanh(omega)};
+                return atanh(omega);
             case -6:
-                return {acosh(omega)};
+                return acosh(omega);
             case -5:
-                return {asinh(omega)};
+                return asinh(omega);
             case -4:
                 if(omega == -1.0) {
-                    return {0};
+                    return 0;
                 } else {
-                    return {pow(((omega - 1.0) / (omega + 1.0)), 0.5) * (omega + 1.0)};
+                    return pow(((omega - 1.0) / (omega + 1.0)), 0.5) * (omega + 1.0);
                 }
             case -3:
-                return {atan(omega)};
+                return atan(omega);
             case -2:
-                return {acos(omega)};
+                return acos(omega);
             case -1:
-                return {asin(omega)};
+                return asin(omega);
             case 0:
                 if(omega.imag() != 0.0) {
                     throw kepler::Error(DomainError, "Expected non-complex argument.");
                 } else if(omega.real() < -1.0 || omega.real() > 1.0) {
                     throw kepler::Error(DomainError, "Expected argument between -1 and 1.");
                 } else {
-                    return {pow((1.0 - pow(omega.real(), 2.0)), 0.5)};
+                    return pow((1.0 - pow(omega.real(), 2.0)), 0.5);
                 }
             case 1:
-                return {sin(omega)};
+                return sin(omega);
             case 2:
-                return {cos(omega)};
+                return cos(omega);
             case 3:
                 if(omega.imag() == 0.0
                    && static_cast<int>(std::round(omega.real() / M_PI_2)) % 2 != 0) {
                     throw kepler::Error(DomainError, "Tangent is undefined for odd multiples of π/2.");
                 }
-                return {tan(omega)};
+                return tan(omega);
             case 4:
-                return {pow((1.0 + pow(omega, 2)), 0.5)};
+                return pow((1.0 + pow(omega, 2)), 0.5);
             case 5:
-                return {sinh(omega)};
+                return sinh(omega);
             case 6:
-                return {cosh(omega)};
+                return cosh(omega);
             case 7:
-                return {tanh(omega)};
+                return tanh(omega);
             case 8:
-                return {pow(-1.0 - pow(omega, 2), 0.5)};
+                return pow(-1.0 - pow(omega, 2), 0.5);
             case 9:
-                return {omega.real()};
+                return omega.real();
             case 10:
-                return {abs(omega)};
+                return abs(omega);
             case 11:
-                return {omega.imag()};
+                return omega.imag();
             case 12:
-                return {std::arg(omega)};
+                return std::arg(omega);
             default:
                 throw kepler::Error(InternalError, "Could not match designator.");
         }
     }
+
+    Array Circle::operator()(const Number& alpha, const Number& omega) {
+        return {dyadic(alpha, omega)};
+    }
 };
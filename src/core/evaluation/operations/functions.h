@@ -34,8 +34,13 @@ namespace kepler {
     struct Plus : PervadeMixin<Operation> {
         using PervadeMixin<Operation>::PervadeMixin;
 
+        static Number monadic(const Number& omega);
+        static Number dyadic(const Number& alpha, const Number& omega);
+
         Array operator()(const Number& alpha, const Number& omega) override;
         Array operator()(const Number& omega) override;
+
+        const ScalarKernel* kernel() const override;
     };
 
     /**
@@ -44,8 +49,13 @@ namespace kepler {
     struct Minus : PervadeMixin<Operation> {
         using PervadeMixin<Operation>::PervadeMixin;
 
+        static Number monadic(const Number& omega);
+        static Number dyadic(const Number& alpha, const Number& omega);
+
         Array operator()(const Number& alpha, const Number& omega) override;
         Array operator()(const Number& omega) override;
+
+        const ScalarKernel* kernel() const override;
     };
 
     /**
@@ -54,8 +64,13 @@ namespace kepler {
     struct Times : PervadeMixin<Operation> {
         using PervadeMixin<Operation>::PervadeMixin;
 
+        static Number monadic(const Number& omega);
+        static Number dyadic(const Number& alpha, const Number& omega);
+
         Array operator()(const Number& alpha, const Number& omega) override;
         Array operator()(const Number& omega) override;
+
+        const ScalarKernel* kernel() const override;
     };
 
     /**
@@ -64,8 +79,13 @@ namespace kepler {
     struct Divide : PervadeMixin<Operation> {
         using PervadeMixin<Operation>::PervadeMixin;
 
+        static Number monadic(const Number& omega);
+        static Number dyadic(const Number& alpha, const Number& omega);
+
         Array operator()(const Number& alpha, const Number& omega) override;
         Array operator()(const Number& omega) override;
+
+        const ScalarKernel* kernel() const override;
     };
 
     /**
@@ -74,8 +94,13 @@ namespace kepler {
     struct Ceiling : PervadeMixin<Operation> {
         using PervadeMixin<Operation>::PervadeMixin;
 
+        static Number monadic(const Number& omega);
+        static Number dyadic(const Number& alpha, const Number& omega);
+
         Array operator()(const Number& alpha, const Number& omega) override;
         Array operator()(const Number& omega) override;
+
+        const ScalarKernel* kernel() const override;
     };
 
     /**
@@ -84,8 +109,13 @@ namespace kepler {
     struct Floor : PervadeMixin<Operation> {
         using PervadeMixin<Operation>::PervadeMixin;
 
+        static Number monadic(const Number& omega);
+        static Number dyadic(const Number& alpha, const Number& omega);
+
         Array operator()(const Number& alpha, const Number& omega) override;
         Array operator()(const Number& omega) override;
+
+        const ScalarKernel* kernel() const override;
     };
 
     /**
@@ -94,9 +124,13 @@ namespace kepler {
     struct And : PervadeMixin<Operation> {
         using PervadeMixin<Operation>::PervadeMixin;
 
+        static Number dyadic(const Number& alpha, const Number& omega);
+
         Array operator()(const Number& alpha, const Number& omega) override;
-        Array operator()(const String& alpha, const String& omega) override;
+        Array operator()(const Char& alpha, const Char& omega) override;
         Array operator()(const Number& omega) override;
+
+        const ScalarKernel* kernel() const override;
     };
 
     /**
@@ -105,9 +139,13 @@ namespace kepler {
     struct Nand : PervadeMixin<Operation> {
         using PervadeMixin<Operation>::PervadeMixin;
 
+        static Number dyadic(const Number& alpha, const Number& omega);
+
         Array operator()(const Number& alpha, const Number& omega) override;
-        Array operator()(const String& alpha, const String& omega) override;
+        Array operator()(const Char& alpha, const Char& omega) override;
         Array operator()(const Number& omega) override;
+
+        const ScalarKernel* kernel() const override;
     };
 
     /**
@@ -116,9 +154,13 @@ namespace kepler {
     struct Or : PervadeMixin<Operation> {
         using PervadeMixin<Operation>::PervadeMixin;
 
+        static Number dyadic(const Number& alpha, const Number& omega);
+
         Array operator()(const Number& alpha, const Number& omega) override;
-        Array operator()(const String& alpha, const String& omega) override;
+        Array operator()(const Char& alpha, const Char& omega) override;
         Array operator()(const Number& omega) override;
+
+        const ScalarKernel* kernel() const override;
     };
 
     /**
@@ -127,9 +169,13 @@ namespace kepler {
     struct Nor : PervadeMixin<Operation> {
         using PervadeMixin<Operation>::PervadeMixin;
 
+        static Number dyadic(const Number& alpha, const Number& omega);
+
         Array operator()(const Number& alpha, const Number& omega) override;
-        Array operator()(const String& alpha, const String& omega) override;
+        Array operator()(const Char& alpha, const Char& omega) override;
         Array operator()(const Number& omega) override;
+
+        const ScalarKernel* kernel() const override;
     };
 
     /**
@@ -158,7 +204,12 @@ namespace kepler {
     struct Less : PervadeMixin<Operation> {
         using PervadeMixin<Operation>::PervadeMixin;
 
+        static Number dyadic(const Number& alpha, const Number& omega);
+
         Array operator()(const Number& alpha, const Number& omega) override;
+        Array operator()(const Char& alpha, const Char& omega) override;
+
+        const ScalarKernel* kernel() const override;
     };
 
     /**
@@ -167,7 +218,12 @@ namespace kepler {
     struct LessEq : PervadeMixin<Operation> {
         using PervadeMixin<Operation>::PervadeMixin;
 
+        static Number dyadic(const Number& alpha, const Number& omega);
+
         Array operator()(const Number& alpha, const Number& omega) override;
+        Array operator()(const Char& alpha, const Char& omega) override;
+
+        const ScalarKernel* kernel() const override;
     };
 
     /**
@@ -176,8 +232,14 @@ namespace kepler {
     struct Eq : PervadeMixin<Operation> {
         using PervadeMixin<Operation>::PervadeMixin;
 
+        static Number dyadic(const Number& alpha, const Number& omega);
+
         Array operator()(const Number& alpha, const Number& omega) override;
         Array operator()(const Char& alpha, const Char& omega) override;
+        Array operator()(const Char& alpha, const Number& omega) override;
+        Array operator()(const Number& alpha, const Char& omega) override;
+
+        const ScalarKernel* kernel() const override;
     };
 
     /**
@@ -186,7 +248,12 @@ namespace kepler {
     struct GreaterEq : PervadeMixin<Operation> {
         using PervadeMixin<Operation>::PervadeMixin;
 
+        static Number dyadic(const Number& alpha, const Number& omega);
+
         Array operator()(const Number& alpha, const Number& omega) override;
+        Array operator()(const Char& alpha, const Char& omega) override;
+
+        const ScalarKernel* kernel() const override;
     };
 
     /**
@@ -195,7 +262,12 @@ namespace kepler {
     struct Greater : PervadeMixin<Operation> {
         using PervadeMixin<Operation>::PervadeMixin;
 
+        static Number dyadic(const Number& alpha, const Number& omega);
+
         Array operator()(const Number &alpha, const Number &omega) override;
+        Array operator()(const Char& alpha, const Char& omega) override;
+
+        const ScalarKernel* kernel() const override;
     };
 
     /**
@@ -204,9 +276,15 @@ namespace kepler {
     struct Neq : PervadeMixin<Operation> {
         using PervadeMixin<Operation>::PervadeMixin;
 
+        static Number dyadic(const Number& alpha, const Number& omega);
+
         Array operator()(const Number& alpha, const Number& omega) override;
         Array operator()(const Char& alpha, const Char& omega) override;
+        Array operator()(const Char& alpha, const Number& omega) override;
+        Array operator()(const Number& alpha, const Char& omega) override;
         Array operator()(const Array& omega) override;
+
+        const ScalarKernel* kernel() const override;
     };
 
     /**
@@ -226,17 +304,67 @@ namespace kepler {
         using PervadeMixin<Operation>::PervadeMixin;
         using PervadeMixin<Operation>::operator();
 
+        static Number monadic(const Number& omega);
+
         Array operator()(const Number& omega) override;
         Array operator()(const Array& alpha, const Array& omega) override;
-        Array operator()(const String& alpha, const String& omega) override;
+
+        const ScalarKernel* kernel() const override;
     };
 
     /**
-     * Represents 'iota' (index generation).
+     * Represents 'iota' (index generation) and 'index of'.
      */
     struct Iota : Operation {
         using Operation::Operation;
 
+        Array operator()(const Array& omega) override;
+        Array operator()(const Array& alpha, const Array& omega) override;
+    };
+
+    /**
+     * Represents 'membership'.
+     */
+    struct Epsilon : Operation {
+        using Operation::Operation;
+
+        Array operator()(const Array& alpha, const Array& omega) override;
+    };
+
+    /**
+     * Represents 'unique' and 'union'.
+     */
+    struct DownShoe : Operation {
+        using Operation::Operation;
+
+        Array operator()(const Array& omega) override;
+        Array operator()(const Array& alpha, const Array& omega) override;
+    };
+
+    /**
+     * Represents 'intersection'.
+     */
+    struct UpShoe : Operation {
+        using Operation::Operation;
+
+        Array operator()(const Array& alpha, const Array& omega) override;
+    };
+
+    /**
+     * Represents 'grade up'.
+     */
+    struct DeltaStile : Operation {
+        using Operation::Operation;
+
+        Array operator()(const Array& omega) override;
+    };
+
+    /**
+     * Represents 'grade down'.
+     */
+    struct DelStile : Operation {
+        using Operation::Operation;
+
         Array operator()(const Array& omega) override;
     };
 
@@ -258,8 +386,8 @@ namespace kepler {
         using Operation::operator();
 
         Array operator()(const Number& omega) override;
-        Array operator()(const String& omega) override;
-        Array operator()(const Number& shift, const String& omega) override;
+        Array operator()(const Char& omega) override;
+        Array operator()(const Number& shift, const Char& omega) override;
         Array operator()(const Number& shift, const Number& omega) override;
 
         Array operator()(const Array& alpha, const Array& omega) override;
@@ -274,8 +402,8 @@ namespace kepler {
         using Operation::operator();
 
         Array operator()(const Number& omega) override;
-        Array operator()(const String& omega) override;
-        Array operator()(const Number& shift, const String& omega) override;
+        Array operator()(const Char& omega) override;
+        Array operator()(const Number& shift, const Char& omega) override;
         Array operator()(const Number& shift, const Number& omega) override;
 
         Array operator()(const Array& alpha, const Array& omega) override;
@@ -316,8 +444,13 @@ namespace kepler {
     struct Star : PervadeMixin<Operation> {
         using PervadeMixin<Operation>::PervadeMixin;
 
+        static Number monadic(const Number& omega);
+        static Number dyadic(const Number& alpha, const Number& omega);
+
         Array operator()(const Number& omega) override;
         Array operator()(const Number& alpha, const Number& omega) override;
+
+        const ScalarKernel* kernel() const override;
     };
 
     /**
@@ -326,8 +459,13 @@ namespace kepler {
     struct Log : PervadeMixin<Operation> {
         using PervadeMixin<Operation>::PervadeMixin;
 
+        static Number monadic(const Number& omega);
+        static Number dyadic(const Number& alpha, const Number& omega);
+
         Array operator()(const Number& omega) override;
         Array operator()(const Number& alpha, const Number& omega) override;
+
+        const ScalarKernel* kernel() const override;
     };
 
     /**
@@ -336,8 +474,13 @@ namespace kepler {
     struct Bar : PervadeMixin<Operation> {
         using PervadeMixin<Operation>::PervadeMixin;
 
+        static Number monadic(const Number& omega);
+        static Number dyadic(const Number& alpha, const Number& omega);
+
         Array operator()(const Number& omega) override;
         Array operator()(const Number& alpha, const Number& omega) override;
+
+        const ScalarKernel* kernel() const override;
     };
 
     /**
@@ -346,8 +489,13 @@ namespace kepler {
     struct ExclamationMark : PervadeMixin<Operation> {
         using PervadeMixin<Operation>::PervadeMixin;
 
+        static Number monadic(const Number& omega);
+        static Number dyadic(const Number& alpha, const Number& omega);
+
         Array operator()(const Number& omega) override;
         Array operator()(const Number& alpha, const Number& omega) override;
+
+        const ScalarKernel* kernel() const override;
     };
 
     /**
@@ -356,7 +504,12 @@ namespace kepler {
     struct Circle : PervadeMixin<Operation> {
         using PervadeMixin<Operation>::PervadeMixin;
 
+        static Number monadic(const Number& omega);
+        static Number dyadic(const Number& alpha, const Number& omega);
+
         Array operator()(const Number& omega) override;
         Array operator()(const Number& alpha, const Number& omega) override;
+
+        const ScalarKernel* kernel() const override;
     };
 };
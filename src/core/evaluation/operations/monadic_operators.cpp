@@ -92,7 +92,7 @@ namespace kepler {
     Array Diaeresis::operator()(const Array &omega) {
         Array result = omega;
 
-        for(auto& element : result.data) {
+        for(auto& element : result.data.mutate()) {
             element = (*op)(get<Array>(element));
         }
 
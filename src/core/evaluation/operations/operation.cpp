@@ -31,7 +31,7 @@ namespace kepler {
         throw kepler::Error(DomainError);
     }
 
-    Array Operation::operator()(const String& omega) {
+    Array Operation::operator()(const Char& omega) {
         throw kepler::Error(DomainError);
     }
 
@@ -45,7 +45,7 @@ namespace kepler {
         throw kepler::Error(DomainError);
     }
 
-    Array Operation::operator()(const Array& alpha, const String& omega) {
+    Array Operation::operator()(const Array& alpha, const Char& omega) {
         throw kepler::Error(DomainError);
     }
 
@@ -59,26 +59,25 @@ namespace kepler {
         throw kepler::Error(DomainError);
     }
 
-    Array Operation::operator()(const Number& alpha, const String& omega) {
+    Array Operation::operator()(const Number& alpha, const Char& omega) {
         throw kepler::Error(DomainError);
     }
 
 
 
-    Array Operation::operator()(const String& alpha, const String& omega) {
+    Array Operation::operator()(const Char& alpha, const Char& omega) {
         throw kepler::Error(DomainError);
     }
 
-    Array Operation::operator()(const String& alpha, const Number& omega) {
+    Array Operation::operator()(const Char& alpha, const Number& omega) {
         throw kepler::Error(DomainError);
     }
 
-    Array Operation::operator()(const String& alpha, const Array& omega) {
+    Array Operation::operator()(const Char& alpha, const Array& omega) {
         throw kepler::Error(DomainError);
     }
 
-
-    Array Operation::operator()(const Char &alpha, const Char &omega) {
-        throw kepler::Error(DomainError);
+    const ScalarKernel* Operation::kernel() const {
+        return nullptr;
     }
 };
\ No newline at end of file
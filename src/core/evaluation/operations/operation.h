@@ -26,6 +26,22 @@
 namespace kepler {
     struct SymbolTable;
 
+    /**
+     * The scalar definition of a pervasive primitive.
+     *
+     * Pervasive primitives are ultimately defined on individual Numbers. Exposing
+     * this definition allows callers to apply the primitive element by element,
+     * without allocating an Array for every intermediate result.
+     * Either kernel is nullptr if the primitive has no scalar definition for that valence.
+     */
+    struct ScalarKernel {
+        Number (*monadic)(const Number& omega);
+        Number (*dyadic)(const Number& alpha, const Number& omega);
+
+        // Whether the dyadic kernel is associative, i.e. whether a reduction may be split into chunks.
+        bool associative;
+    };
+
     /**
      * Represents an arbitrary Operation to be applied to some data.
      *
@@ -63,10 +79,10 @@ namespace kepler {
 
         /**
          * Applies an operation to a single argument.
-         * @param omega The String to apply the operation to.
+         * @param omega The Char to apply the operation to.
          * @return The result of applying the operation.
          */
-        virtual Array operator()(const String& omega);
+        virtual Array operator()(const Char& omega);
 
         /**
          * Applies an operation to two arguments.
@@ -87,10 +103,10 @@ namespace kepler {
         /**
          * Applies an operation to two arguments.
          * @param alpha The Array left argument.
-         * @param omega The String right argument.
+         * @param omega The Char right argument.
          * @return The result of applying the operation.
          */
-        virtual Array operator()(const Array& alpha, const String& omega);
+        virtual Array operator()(const Array& alpha, const Char& omega);
 
         /**
          * Applies an operation to two arguments.
@@ -111,41 +127,39 @@ namespace kepler {
         /**
          * Applies an operation to two arguments.
          * @param alpha The Number left argument.
-         * @param omega The String right argument.
+         * @param omega The Char right argument.
          * @return The result of applying the operation.
          */
-        virtual Array operator()(const Number& alpha, const String& omega);
+        virtual Array operator()(const Number& alpha, const Char& omega);
 
         /**
          * Applies an operation to two arguments.
-         * @param alpha The String left argument.
-         * @param omega The String right argument.
+         * @param alpha The Char left argument.
+         * @param omega The Char right argument.
          * @return The result of applying the operation.
          */
-        virtual Array operator()(const String& alpha, const String& omega);
+        virtual Array operator()(const Char& alpha, const Char& omega);
 
         /**
          * Applies an operation to two arguments.
-         * @param alpha The String left argument.
+         * @param alpha The Char left argument.
          * @param omega The Number right argument.
          * @return The result of applying the operation.
          */
-        virtual Array operator()(const String& alpha, const Number& omega);
+        virtual Array operator()(const Char& alpha, const Number& omega);
 
         /**
          * Applies an operation to two arguments.
-         * @param alpha The String left argument.
+         * @param alpha The Char left argument.
          * @param omega The Array right argument.
          * @return The result of applying the operation.
          */
-        virtual Array operator()(const String& alpha, const Array& omega);
+        virtual Array operator()(const Char& alpha, const Array& omega);
 
         /**
-         * Applies an operation to two arguments.
-         * @param alpha The Char left argument.
-         * @param omega The Char right argument.
-         * @return The result of applying the operation.
+         * Returns the scalar definition of the operation, if it has one.
+         * @return The ScalarKernel of the operation, or nullptr if it is not a scalar primitive.
          */
-        virtual Array operator()(const Char& alpha, const Char& omega);
+        virtual const ScalarKernel* kernel() const;
     };
 };
\ No newline at end of file
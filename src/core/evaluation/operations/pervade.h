@@ -61,21 +61,6 @@ namespace kepler {
          */
         virtual Array operator()(const Array& alpha, const Array& omega);
 
-        /**
-         * Pervade over two Strings.
-         *
-         * This applies itself (this) between each pair of Chars of alpha and omega.
-         *
-         * If the Strings are equally sized, the operation is applied to each pair of Chars.
-         * If alpha is scalar, the operation is applied between alpha and every Char of omega.
-         * If omega is scalar, the operation is applied between every Char of alpha and omega.
-         *
-         * @param alpha The left String.
-         * @param omega The right String.
-         * @return A new Array with the result.
-         */
-        virtual Array operator()(const String& alpha, const String& omega);
-
     private:
         /**
          * Apply the operation to the single element in the Array.
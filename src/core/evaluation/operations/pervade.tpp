@@ -25,7 +25,7 @@ namespace kepler {
     Array PervadeMixin<BASE>::operator()(const Array& omega) {
         if (!omega.is_simple_scalar()) {
             Array tmp = omega;
-            for (auto &element: tmp.data) {
+            for (auto &element: tmp.data.mutate()) {
                 element = apply(element);
             }
             return tmp;
@@ -46,8 +46,9 @@ namespace kepler {
 
             tmp.data.resize(alpha.data.size());
             tmp.shape = alpha.shape;
+            auto& elements = tmp.data.mutate();
             for (int i = 0; i < alpha.data.size(); ++i) {
-                tmp.data[i] = apply(alpha.data[i], omega.data[i]);
+                elements[i] = apply(alpha.data[i], omega.data[i]);
             }
 
         } else if (alpha.is_scalar() && omega.is_scalar()) {
@@ -56,24 +57,26 @@ namespace kepler {
         } else if (!alpha.is_scalar() && omega.is_scalar()) {
             tmp.shape = alpha.shape;
             tmp.data.resize(alpha.data.size());
+            auto& elements = tmp.data.mutate();
 
             for (int i = 0; i < alpha.data.size(); ++i) {
                 if(std::holds_alternative<Array>(omega.data[0])) {
-                    tmp.data[i] = (*this)(std::get<Array>(alpha.data[i]), std::get<Array>(omega.data[0]));
+                    elements[i] = (*this)(std::get<Array>(alpha.data[i]), std::get<Array>(omega.data[0]));
                 } else {
-                    tmp.data[i] = (*this)(std::get<Array>(alpha.data[i]), omega);
+                    elements[i] = (*this)(std::get<Array>(alpha.data[i]), omega);
                 }
             }
 
         } else if (alpha.is_scalar() && !omega.is_scalar()) {
             tmp.shape = omega.shape;
             tmp.data.resize(omega.data.size());
+            auto& elements = tmp.data.mutate();
 
             for (int i = 0; i < omega.data.size(); ++i) {
                 if(std::holds_alternative<Array>(alpha.data[0])) {
-                    tmp.data[i] = (*this)(std::get<Array>(alpha.data[0]), std::get<Array>(omega.data[i]));
+                    elements[i] = (*this)(std::get<Array>(alpha.data[0]), std::get<Array>(omega.data[i]));
                 } else {
-                    tmp.data[i] = (*this)(alpha, std::get<Array>(omega.data[i]));
+                    elements[i] = (*this)(alpha, std::get<Array>(omega.data[i]));
                 }
             }
         }
@@ -81,46 +84,6 @@ namespace kepler {
         return tmp;
     }
 
-    template <typename BASE>
-    Array PervadeMixin<BASE>::operator()(const String &alpha, const String &omega) {
-        Array tmp{{}, {}};
-
-        if (alpha.length() != 1 && omega.length() != 1) {
-
-            if (alpha.length() != omega.length()) {
-                throw kepler::Error(LengthError, "Mismatched left and right shapes.");
-            }
-
-            tmp.data.resize(alpha.length());
-            tmp.shape.emplace_back(alpha.length());
-            for (int i = 0; i < alpha.length(); ++i) {
-                tmp.data[i] = (*this)(alpha[i], omega[i]);
-            }
-
-        } else if (alpha.length() == 1 && omega.length() == 1) {
-            tmp = apply(alpha[0], omega[0]);
-
-        } else if (alpha.length() != 1 && omega.length() == 1) {
-            tmp.shape.emplace_back(alpha.length());
-            tmp.data.resize(alpha.length());
-
-            for (int i = 0; i < alpha.length(); ++i) {
-                tmp.data[i] = (*this)(alpha[i], omega[0]);
-            }
-
-        } else if (alpha.length() == 1 && omega.length() != 1) {
-            tmp.shape.emplace_back(omega.length());
-            tmp.data.resize(omega.length());
-
-            for (int i = 0; i < omega.length(); ++i) {
-                tmp.data[i] = (*this)(alpha[0], omega[i]);
-            }
-
-        }
-
-        return tmp;
-    }
-
     template <typename BASE>
     Array PervadeMixin<BASE>::apply(const Array::element_type& omega) {
         return std::visit(*this, omega);
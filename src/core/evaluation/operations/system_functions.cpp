@@ -0,0 +1,193 @@
+//
+// Copyright 2023 Nikolaj Banke Jensen.
+//
+// This file is part of Kepler.
+// 
+// Kepler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Kepler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License 
+// along with Kepler. If not, see <https://www.gnu.org/licenses/>.
+//
+#include "system_functions.h"
+#include "core/error.h"
+#include "core/memory.h"
+#include "core/symbol_table.h"
+#include "interface/binary_file.h"
+#include "interface/csv_reader.h"
+#include "interface/workspace.h"
+#include "core/evaluation/profiler.h"
+#include <cmath>
+#include <limits>
+#include <optional>
+#include "uni_algo/conv.h"
+
+namespace kepler {
+    namespace {
+        // Returns the element of a simple scalar, which is boxed in the elements of a vector.
+        const Array::element_type& scalar_of(const Array::element_type& element) {
+            if(auto boxed = std::get_if<Array>(&element); boxed && boxed->is_scalar()) {
+                return boxed->data[0];
+            }
+            return element;
+        }
+
+        // Returns the value of a non-negative whole number, which must fit in T.
+        template<typename T = unsigned int>
+        T whole_number(const Array::element_type& element) {
+            auto number = std::get_if<Number>(&scalar_of(element));
+            if(!number || number->imag() != 0 || number->real() < 0 || number->real() != std::floor(number->real())
+               || number->real() >= static_cast<double>(std::numeric_limits<T>::max())) {
+                throw kepler::Error(DomainError, "Expected a non-negative whole number.");
+            }
+            return static_cast<T>(number->real());
+        }
+
+        // Returns the text held by a non-empty character vector, or throws an error with the given message.
+        std::string text_of(const Array& omega, const std::string& message) {
+            if(omega.rank() > 1 || omega.data.empty()) {
+                throw kepler::Error(DomainError, message);
+            }
+
+            if(auto text = omega.data.text()) {
+                return uni::utf32to8(text->to_string());
+            }
+
+            String chars;
+            for(auto& element : omega.data) {
+                auto c = std::get_if<Char>(&scalar_of(element));
+                if(!c) {
+                    throw kepler::Error(DomainError, message);
+                }
+                chars.push_back(*c);
+            }
+            return uni::utf32to8(chars);
+        }
+
+        // Returns the path held by a character vector.
+        std::string path_of(const Array& omega) {
+            return text_of(omega, "Expected the path of a file.");
+        }
+    }
+
+    Array SaveWorkspace::operator()(const Array& omega) {
+        auto count = save_workspace(symbol_table->root(), path_of(omega));
+        return Array{Number(static_cast<double>(count))};
+    }
+
+    LoadWorkspace::LoadWorkspace(SymbolTable* symbol_table_, std::ostream& output_stream_)
+            : Operation(symbol_table_), output_stream(output_stream_) {}
+
+    Array LoadWorkspace::operator()(const Array& omega) {
+        auto count = load_workspace(symbol_table->root(), path_of(omega), output_stream);
+        return Array{Number(static_cast<double>(count))};
+    }
+
+    Array ReadBinary::operator()(const Array& alpha, const Array& omega) {
+        if(alpha.rank() > 1 || alpha.data.empty()) {
+            throw kepler::Error(DomainError, "Expected the type of the file, optionally followed by a shape.");
+        }
+
+        std::optional<std::vector<unsigned int>> shape;
+        if(alpha.data.size() > 1) {
+            shape.emplace();
+            for(std::size_t i = 1; i < alpha.data.size(); ++i) {
+                shape->emplace_back(whole_number(alpha.data[i]));
+            }
+        }
+        return read_binary(path_of(omega), static_cast<int>(whole_number(alpha.data[0])), shape);
+    }
+
+    Array WriteBinary::operator()(const Array& alpha, const Array& omega) {
+        if(alpha.rank() != 1 || alpha.data.size() != 2) {
+            throw kepler::Error(DomainError, "Expected the path of the file followed by its type.");
+        }
+
+        auto path = std::get_if<Array>(&alpha.data[0]);
+        if(!path) {
+            throw kepler::Error(DomainError, "Expected the path of a file.");
+        }
+        auto count = write_binary(path_of(*path), static_cast<int>(whole_number(alpha.data[1])), omega);
+        return Array{Number(static_cast<double>(count))};
+    }
+
+    Array ReadCSV::operator()(const Array& omega) {
+        return (*this)(Array{Number(0)}, omega);
+    }
+
+    Array ReadCSV::operator()(const Array& alpha, const Array& omega) {
+        if(alpha.rank() > 1 || alpha.data.empty() || alpha.data.size() > 2) {
+            throw kepler::Error(DomainError, "Expected the form of the result, optionally followed by the number of rows to skip.");
+        }
+
+        auto path = path_of(omega);
+        CsvOptions options;
+        options.delimiter = path.ends_with(".tsv") || path.ends_with(".tab") ? '\t' : ',';
+        options.matrix = whole_number(alpha.data[0]) == 1;
+        if(!options.matrix && whole_number(alpha.data[0]) != 0) {
+            throw kepler::Error(DomainError, "The form of the result must be 0 for columns or 1 for a matrix.");
+        }
+        if(alpha.data.size() == 2) {
+            options.skipped_rows = whole_number(alpha.data[1]);
+        }
+        return read_csv(path, options);
+    }
+
+    Array Profile::operator()(const Array& omega) {
+        auto command = text_of(omega, "Expected a command of the profiler.");
+        profiler::Format format;
+        if(command == "start") {
+            profiler::start();
+        } else if(command == "stop") {
+            profiler::stop();
+        } else if(command == "clear") {
+            profiler::clear();
+        } else if(profiler::parse_format(command, format)) {
+            auto report = uni::utf8to32u(profiler::report(format));
+            return Array(Text(String(report.begin(), report.end())));
+        } else {
+            throw kepler::Error(DomainError, "Unknown command of the profiler: '" + command + "'.");
+        }
+        return {{0}, {}};
+    }
+
+    Array WorkspaceAvailable::operator()(const Array& omega) {
+        auto command = text_of(omega, "Expected a command of the memory counters.");
+        if(command == "usage") {
+            auto usage = memory::usage();
+            return {{4}, {Array{Number(static_cast<double>(usage.live))}, Array{Number(static_cast<double>(usage.peak))},
+                          Array{Number(static_cast<double>(usage.allocations))}, Array{Number(static_cast<double>(usage.allocated))}}};
+        } else if(command == "start") {
+            memory::start();
+        } else if(command == "stop") {
+            memory::stop();
+        } else if(command == "clear") {
+            memory::clear();
+        } else if(command == "limit") {
+            return Array{Number(static_cast<double>(memory::limit()))};
+        } else if(command == "text") {
+            auto report = uni::utf8to32u(memory::report());
+            return Array(Text(String(report.begin(), report.end())));
+        } else {
+            throw kepler::Error(DomainError, "Unknown command of the memory counters: '" + command + "'.");
+        }
+        return {{0}, {}};
+    }
+
+    Array WorkspaceAvailable::operator()(const Array& alpha, const Array& omega) {
+        if(text_of(omega, "Expected a command of the memory counters.") != "limit") {
+            throw kepler::Error(DomainError, "Only the limit of the memory counters can be set.");
+        } else if(alpha.rank() > 1 || alpha.data.size() != 1) {
+            throw kepler::Error(LengthError, "Expected a single number of bytes.");
+        }
+        memory::set_limit(whole_number<std::size_t>(alpha.data[0]));
+        return {{0}, {}};
+    }
+};
@@ -0,0 +1,121 @@
+//
+// Copyright 2023 Nikolaj Banke Jensen.
+//
+// This file is part of Kepler.
+// 
+// Kepler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Kepler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License 
+// along with Kepler. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include <ostream>
+#include "operation.h"
+
+namespace kepler {
+
+    /**
+     * Represents '⎕SAVE', which saves the workspace to the file at the path given as right argument.
+     *
+     * Returns the number of variables and functions saved.
+     */
+    struct SaveWorkspace : Operation {
+        using Operation::Operation;
+
+        Array operator()(const Array& omega) override;
+    };
+
+    /**
+     * Represents '⎕LOAD', which loads the workspace in the file at the path given as right argument.
+     *
+     * Returns the number of variables and functions loaded.
+     */
+    struct LoadWorkspace : Operation {
+    private:
+        std::ostream& output_stream;
+
+    public:
+        LoadWorkspace(SymbolTable* symbol_table, std::ostream& output_stream_);
+
+        Array operator()(const Array& omega) override;
+    };
+
+    /**
+     * Represents '⎕NREAD', which reads an array from the binary file at the path given as right argument.
+     *
+     * The left argument is the code of the type of the elements of the file, optionally followed by
+     * the shape of the array. Without a shape, every element of the file is read into a vector.
+     */
+    struct ReadBinary : Operation {
+        using Operation::Operation;
+
+        Array operator()(const Array& alpha, const Array& omega) override;
+    };
+
+    /**
+     * Represents '⎕NWRITE', which writes the ravel of its right argument to a binary file.
+     *
+     * The left argument is the path of the file followed by the code of the type of its elements.
+     * Returns the number of elements written.
+     */
+    struct WriteBinary : Operation {
+        using Operation::Operation;
+
+        Array operator()(const Array& alpha, const Array& omega) override;
+    };
+
+    /**
+     * Represents '⎕CSV', which reads the delimited text file at the path given as right argument.
+     *
+     * Fields are separated by tabs in '.tsv' and '.tab' files, and by commas otherwise.
+     * Monadically, returns a vector of the columns of the file. The optional left argument
+     * is 1 to instead return a matrix of its fields, or 0 for columns, optionally followed
+     * by the number of rows to skip at the start of the file.
+     */
+    struct ReadCSV : Operation {
+        using Operation::Operation;
+
+        Array operator()(const Array& omega) override;
+        Array operator()(const Array& alpha, const Array& omega) override;
+    };
+
+    /**
+     * Represents '⎕PROFILE', which controls the profiler with the command given as right argument.
+     *
+     * 'start', 'stop' and 'clear' start, stop and clear the recording of calls, and return an empty vector.
+     * 'text', 'json' and 'folded' return a report of the recorded calls in that format.
+     */
+    struct Profile : Operation {
+        using Operation::Operation;
+
+        Array operator()(const Array& omega) override;
+    };
+
+    /**
+     * Represents '⎕WA', which reports the memory held by Arrays, with the command given as right argument.
+     *
+     * In other APLs, '⎕WA' is a niladic function returning the bytes available in the workspace.
+     * Kepler has no fixed workspace size to report, so the name is used for a function taking a command
+     * instead. Code written for other APLs which reads '⎕WA' without an argument fails with a DOMAIN ERROR.
+     *
+     * 'usage' returns the bytes currently held, the peak, and the number and bytes of allocations since last cleared.
+     * 'start', 'stop' and 'clear' start and stop attributing allocations to functions, and clear the counters,
+     * and return an empty vector. 'text' returns a report of the allocations, and 'limit' the most bytes which
+     * can be held, or 0 if there is no limit. Dyadically, 'limit' sets the limit to the left argument.
+     */
+    struct WorkspaceAvailable : Operation {
+        using Operation::Operation;
+
+        Array operator()(const Array& omega) override;
+        Array operator()(const Array& alpha, const Array& omega) override;
+    };
+};
@@ -0,0 +1,406 @@
+//
+// Copyright 2023 Nikolaj Banke Jensen.
+//
+// This file is part of Kepler.
+// 
+// Kepler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Kepler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License 
+// along with Kepler. If not, see <https://www.gnu.org/licenses/>.
+//
+#include "optimizer.h"
+#include <algorithm>
+#include <set>
+#include <sstream>
+#include "core/literals.h"
+#include "core/memory.h"
+#include "core/symbol_table.h"
+#include "core/evaluation/interpreter.h"
+
+namespace kepler {
+    namespace {
+        // The largest value kept as a constant in the AST, measured in elements.
+        constexpr std::size_t max_folded_size = 1 << 16;
+
+        // The most bytes folding an expression may allocate, so a large value is given up on early.
+        constexpr std::size_t max_folding_bytes = 16 * max_folded_size * sizeof(Array::element_type);
+
+        const Array* constant_value(ASTNode<Array>* node) {
+            if(auto scalar = dynamic_cast<Scalar*>(node)) {
+                return &scalar->value;
+            } else if(auto vector = dynamic_cast<Vector*>(node); vector && vector->value) {
+                return &*vector->value;
+            } else if(auto constant = dynamic_cast<Constant*>(node)) {
+                return &constant->value;
+            }
+            return nullptr;
+        }
+
+        bool numeric_leaves(const Array& array) {
+            return std::all_of(array.data.begin(), array.data.end(), [](const Array::element_type& element) {
+                if(auto nested = std::get_if<Array>(&element)) {
+                    return numeric_leaves(*nested);
+                }
+                return std::holds_alternative<Number>(element);
+            });
+        }
+
+        bool is_number(ASTNode<Array>* node, double number) {
+            auto value = constant_value(node);
+            return value && value->is_simple_scalar() && std::holds_alternative<Number>(value->data[0]) && std::get<Number>(value->data[0]) == Number(number);
+        }
+
+        TokenType primitive(ASTNode<Operation_ptr>* node) {
+            if(auto function = dynamic_cast<Function*>(node)) {
+                return function->token.type;
+            }
+            return END;
+        }
+
+        // Returns true if the primitive depends on the index origin.
+        bool uses_index_origin(TokenType type) {
+            return type == IOTA || type == DELTA_STILE || type == DEL_STILE;
+        }
+
+        // Returns true if the primitive only ever returns numbers, or fails.
+        bool returns_numbers(TokenType type) {
+            switch(type) {
+                case PLUS: case MINUS: case TIMES: case DIVIDE: case CEILING: case FLOOR:
+                case AND: case OR: case NAND: case NOR:
+                case LESS: case LESS_EQUAL: case EQUAL: case GREATER_EQUAL: case GREATER: case NOT_EQUAL:
+                case STAR: case LOG: case BAR: case CIRCLE: case EXCLAMATION_MARK:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        bool numeric(ASTNode<Array>* node) {
+            if(auto value = constant_value(node)) {
+                return numeric_leaves(*value);
+            } else if(auto monadic = dynamic_cast<MonadicFunction*>(node)) {
+                auto type = primitive(monadic->function);
+                return returns_numbers(type) || type == IOTA || type == RHO || type == DELTA_STILE || type == DEL_STILE;
+            } else if(auto dyadic = dynamic_cast<DyadicFunction*>(node)) {
+                return returns_numbers(primitive(dyadic->function));
+            }
+            return false;
+        }
+
+        /**
+         * Returns true if the function is built from primitives which depend on nothing but their arguments.
+         * @param node The function.
+         * @param index_origin True if primitives depending on the index origin are allowed.
+         */
+        bool pure(ASTNode<Operation_ptr>* node, bool index_origin) {
+            if(auto function = dynamic_cast<Function*>(node)) {
+                auto type = function->token.type;
+                return type != QUESTION_MARK && (index_origin || !uses_index_origin(type));
+            } else if(auto monadic = dynamic_cast<MonadicOperator*>(node)) {
+                return pure(monadic->child, index_origin);
+            } else if(auto dyadic = dynamic_cast<DyadicOperator*>(node)) {
+                if(auto right = std::get_if<ASTNode<Operation_ptr>*>(&dyadic->right)) {
+                    return pure(dyadic->left, index_origin) && pure(*right, index_origin);
+                }
+                return pure(dyadic->left, index_origin) && constant_value(std::get<ASTNode<Array>*>(dyadic->right));
+            }
+            return false;
+        }
+
+        /**
+         * The names assigned, and whether named functions are called, in a part of the AST.
+         */
+        struct Effects {
+            std::set<String> assigned;
+            bool calls = false;
+
+            void scan(ASTNode<Operation_ptr>* node) {
+                if(auto monadic = dynamic_cast<MonadicOperator*>(node)) {
+                    scan(monadic->child);
+                } else if(auto dyadic = dynamic_cast<DyadicOperator*>(node)) {
+                    scan(dyadic->left);
+                    if(auto right = std::get_if<ASTNode<Operation_ptr>*>(&dyadic->right)) {
+                        scan(*right);
+                    } else {
+                        scan(std::get<ASTNode<Array>*>(dyadic->right));
+                    }
+                } else if(auto dfn = dynamic_cast<AnonymousFunction*>(node)) {
+                    scan(dfn->body);
+                } else if(dynamic_cast<FunctionVariable*>(node)) {
+                    calls = true;
+                }
+            }
+
+            void scan(ASTNode<Array>* node) {
+                if(auto vector = dynamic_cast<Vector*>(node)) {
+                    for(auto child : vector->children) scan(child);
+                } else if(auto monadic = dynamic_cast<MonadicFunction*>(node)) {
+                    scan(monadic->function);
+                    scan(monadic->omega);
+                } else if(auto dyadic = dynamic_cast<DyadicFunction*>(node)) {
+                    scan(dyadic->function);
+                    scan(dyadic->alpha);
+                    scan(dyadic->omega);
+                } else if(auto assignment = dynamic_cast<Assignment*>(node)) {
+                    assigned.insert(assignment->identifier.content());
+                    scan(assignment->value);
+                } else if(auto function_assignment = dynamic_cast<FunctionAssignment*>(node)) {
+                    scan(function_assignment->function);
+                } else if(auto conditional = dynamic_cast<Conditional*>(node)) {
+                    scan(conditional->condition);
+                    scan(conditional->true_case);
+                    scan(conditional->false_case);
+                } else if(auto statements = dynamic_cast<Statements*>(node)) {
+                    for(auto child : statements->children) scan(child);
+                }
+            }
+        };
+
+        /**
+         * Finds the invariant subexpressions of a dfn body, and wraps them in Invariant nodes.
+         */
+        struct Hoister {
+            AnonymousFunction* dfn;
+            const std::set<String>& assigned;
+
+            // True if the body does not assign the index origin, so primitives depending on it are invariant.
+            bool index_origin;
+
+            void wrap(ASTNode<Array>*& node) {
+                if(dynamic_cast<MonadicFunction*>(node) || dynamic_cast<DyadicFunction*>(node) || (dynamic_cast<Vector*>(node) && !constant_value(node))) {
+                    auto invariant = new Invariant(node);
+                    dfn->invariants.emplace_back(invariant);
+                    node = invariant;
+                }
+            }
+
+            // Returns true if the node is invariant. Invariant children of variant nodes are wrapped.
+            bool lift(ASTNode<Array>*& node) {
+                if(constant_value(node)) {
+                    return true;
+                } else if(auto variable = dynamic_cast<Variable*>(node)) {
+                    auto type = variable->token.type;
+                    return type != ALPHA && type != OMEGA && !assigned.contains(variable->token.content());
+                } else if(auto vector = dynamic_cast<Vector*>(node)) {
+                    std::vector<bool> invariant;
+                    for(auto& child : vector->children) {
+                        invariant.push_back(lift(child));
+                    }
+                    if(std::find(invariant.begin(), invariant.end(), false) == invariant.end()) {
+                        return true;
+                    }
+                    for(std::size_t i = 0; i < invariant.size(); ++i) {
+                        if(invariant[i]) wrap(vector->children[i]);
+                    }
+                    return false;
+                } else if(auto monadic = dynamic_cast<MonadicFunction*>(node)) {
+                    bool omega = lift(monadic->omega);
+                    if(omega && pure(monadic->function, index_origin)) {
+                        return true;
+                    }
+                    if(omega) wrap(monadic->omega);
+                    return false;
+                } else if(auto dyadic = dynamic_cast<DyadicFunction*>(node)) {
+                    bool alpha = lift(dyadic->alpha);
+                    bool omega = lift(dyadic->omega);
+                    if(alpha && omega && pure(dyadic->function, index_origin)) {
+                        return true;
+                    }
+                    if(alpha) wrap(dyadic->alpha);
+                    if(omega) wrap(dyadic->omega);
+                    return false;
+                } else if(auto assignment = dynamic_cast<Assignment*>(node)) {
+                    if(lift(assignment->value)) wrap(assignment->value);
+                } else if(auto conditional = dynamic_cast<Conditional*>(node)) {
+                    if(lift(conditional->condition)) wrap(conditional->condition);
+                    if(lift(conditional->true_case)) wrap(conditional->true_case);
+                    if(lift(conditional->false_case)) wrap(conditional->false_case);
+                } else if(auto statements = dynamic_cast<Statements*>(node)) {
+                    for(auto& child : statements->children) {
+                        if(lift(child)) wrap(child);
+                    }
+                }
+                return false;
+            }
+        };
+
+        // Deletes the function application, but not its argument, and returns the argument.
+        ASTNode<Array>* unwrap(MonadicFunction* node) {
+            auto omega = node->omega;
+            node->omega = nullptr;
+            delete node;
+            return omega;
+        }
+
+        // Deletes the function application and the left argument, and returns the right argument.
+        ASTNode<Array>* keep_omega(DyadicFunction* node) {
+            auto omega = node->omega;
+            node->omega = nullptr;
+            delete node;
+            return omega;
+        }
+
+        // Deletes the function application and the right argument, and returns the left argument.
+        ASTNode<Array>* keep_alpha(DyadicFunction* node) {
+            auto alpha = node->alpha;
+            node->alpha = nullptr;
+            delete node;
+            return alpha;
+        }
+    }
+
+    Optimizer::Optimizer(SymbolTable& symbol_table_) : symbol_table(symbol_table_), fixed_index_origin(false) {}
+
+    void Optimizer::optimize(Statements* program) {
+        Effects effects;
+        effects.scan(program);
+        fixed_index_origin = !effects.calls && !effects.assigned.contains(constants::index_origin_id);
+
+        rewrite(program, false);
+    }
+
+    void Optimizer::rewrite(Statements* node, bool in_dfn) {
+        for(auto& child : node->children) {
+            child = rewrite(child, in_dfn);
+        }
+    }
+
+    void Optimizer::rewrite(ASTNode<Operation_ptr>* node, bool in_dfn) {
+        if(auto monadic = dynamic_cast<MonadicOperator*>(node)) {
+            rewrite(monadic->child, in_dfn);
+            if(auto dfn = dynamic_cast<AnonymousFunction*>(monadic->child); dfn && monadic->token.type == DIAERESIS) {
+                hoist(dfn);
+            }
+        } else if(auto dyadic = dynamic_cast<DyadicOperator*>(node)) {
+            rewrite(dyadic->left, in_dfn);
+            if(auto right = std::get_if<ASTNode<Operation_ptr>*>(&dyadic->right)) {
+                rewrite(*right, in_dfn);
+            } else {
+                dyadic->right = rewrite(std::get<ASTNode<Array>*>(dyadic->right), in_dfn);
+            }
+            if(auto dfn = dynamic_cast<AnonymousFunction*>(dyadic->left); dfn && dyadic->token.type == POWER) {
+                hoist(dfn);
+            }
+        } else if(auto dfn = dynamic_cast<AnonymousFunction*>(node)) {
+            rewrite(dfn->body, true);
+        }
+    }
+
+    ASTNode<Array>* Optimizer::rewrite(ASTNode<Array>* node, bool in_dfn) {
+        if(auto vector = dynamic_cast<Vector*>(node)) {
+            for(auto& child : vector->children) {
+                child = rewrite(child, in_dfn);
+            }
+
+            if(!vector->value && std::all_of(vector->children.begin(), vector->children.end(), constant_value)) {
+                Array::buffer_type elements;
+                elements.reserve(vector->children.size());
+                for(auto child : vector->children) {
+                    elements.emplace_back(*constant_value(child));
+                }
+                vector->value = Array{{static_cast<unsigned int>(elements.size())}, std::move(elements)};
+            }
+        } else if(auto monadic = dynamic_cast<MonadicFunction*>(node)) {
+            rewrite(monadic->function, in_dfn);
+            monadic->omega = rewrite(monadic->omega, in_dfn);
+        } else if(auto dyadic = dynamic_cast<DyadicFunction*>(node)) {
+            rewrite(dyadic->function, in_dfn);
+            dyadic->alpha = rewrite(dyadic->alpha, in_dfn);
+            dyadic->omega = rewrite(dyadic->omega, in_dfn);
+        } else if(auto assignment = dynamic_cast<Assignment*>(node)) {
+            assignment->value = rewrite(assignment->value, in_dfn);
+        } else if(auto function_assignment = dynamic_cast<FunctionAssignment*>(node)) {
+            rewrite(function_assignment->function, in_dfn);
+        } else if(auto conditional = dynamic_cast<Conditional*>(node)) {
+            conditional->condition = rewrite(conditional->condition, in_dfn);
+            conditional->true_case = rewrite(conditional->true_case, in_dfn);
+            conditional->false_case = rewrite(conditional->false_case, in_dfn);
+        } else if(auto statements = dynamic_cast<Statements*>(node)) {
+            rewrite(statements, in_dfn);
+        }
+
+        return simplify(fold(node, in_dfn));
+    }
+
+    ASTNode<Array>* Optimizer::fold(ASTNode<Array>* node, bool in_dfn) {
+        bool index_origin = !in_dfn && fixed_index_origin;
+
+        if(auto monadic = dynamic_cast<MonadicFunction*>(node)) {
+            if(!pure(monadic->function, index_origin) || !constant_value(monadic->omega)) {
+                return node;
+            }
+        } else if(auto dyadic = dynamic_cast<DyadicFunction*>(node)) {
+            if(!pure(dyadic->function, index_origin) || !constant_value(dyadic->alpha) || !constant_value(dyadic->omega)) {
+                return node;
+            }
+        } else {
+            return node;
+        }
+
+        std::stringstream discarded;
+        Interpreter interpreter(*node, symbol_table, discarded);
+        try {
+            memory::Budget budget(max_folding_bytes);
+            Array value = interpreter.interpret();
+            if(value.data.size() > max_folded_size) {
+                return node;
+            }
+            return new Constant(std::move(value), node);
+        } catch(kepler::Error&) {
+            // Errors are left to be reported when the expression is evaluated.
+            return node;
+        }
+    }
+
+    ASTNode<Array>* Optimizer::simplify(ASTNode<Array>* node) {
+        if(auto monadic = dynamic_cast<MonadicFunction*>(node)) {
+            auto type = primitive(monadic->function);
+            if(type == RIGHT_TACK || type == LEFT_TACK) {
+                return unwrap(monadic);
+            } else if(type == CIRCLE_STILE || type == CIRCLE_BAR) {
+                if(auto inner = dynamic_cast<MonadicFunction*>(monadic->omega); inner && primitive(inner->function) == type) {
+                    auto omega = unwrap(inner);
+                    monadic->omega = nullptr;
+                    delete monadic;
+                    return omega;
+                }
+            }
+        } else if(auto dyadic = dynamic_cast<DyadicFunction*>(node)) {
+            auto type = primitive(dyadic->function);
+            if(type == PLUS && is_number(dyadic->alpha, 0) && numeric(dyadic->omega)) {
+                return keep_omega(dyadic);
+            } else if((type == PLUS || type == MINUS) && is_number(dyadic->omega, 0) && numeric(dyadic->alpha)) {
+                return keep_alpha(dyadic);
+            } else if(type == TIMES && is_number(dyadic->alpha, 1) && numeric(dyadic->omega)) {
+                return keep_omega(dyadic);
+            } else if((type == TIMES || type == DIVIDE) && is_number(dyadic->omega, 1) && numeric(dyadic->alpha)) {
+                return keep_alpha(dyadic);
+            }
+        }
+        return node;
+    }
+
+    void Optimizer::hoist(AnonymousFunction* dfn) {
+        Effects effects;
+        effects.scan(dfn->body);
+        if(effects.calls) {
+            // A named function may assign any variable, so nothing is known to be invariant.
+            return;
+        }
+
+        Hoister hoister{dfn, effects.assigned, !effects.assigned.contains(constants::index_origin_id)};
+        for(auto& child : dfn->body->children) {
+            if(hoister.lift(child)) {
+                hoister.wrap(child);
+            }
+        }
+    }
+};
@@ -0,0 +1,100 @@
+//
+// Copyright 2023 Nikolaj Banke Jensen.
+//
+// This file is part of Kepler.
+// 
+// Kepler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Kepler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License 
+// along with Kepler. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include "core/datatypes.h"
+#include "core/evaluation/ast.h"
+
+namespace kepler {
+    class SymbolTable;
+
+    /**
+     * Rewrites the AST built by the Parser before it is interpreted.
+     *
+     * Primitive functions applied to constant arguments are evaluated once, and replaced by their values.
+     * Applications which do not change their argument, like '⊢x', 'x+0', '1×x', and '⌽⌽x', are removed.
+     * In a dfn given to '¨' or '⍣', the subexpressions which are the same in every call are marked, so
+     * they are evaluated once per application of the operator instead of once per call.
+     */
+    class Optimizer {
+    private:
+        SymbolTable& symbol_table;
+
+        // True if the index origin cannot change while the top level statements are evaluated.
+        bool fixed_index_origin;
+
+        /**
+         * Rewrites the given node, and returns the node that replaces it.
+         *
+         * The given node is deleted if it is replaced.
+         * @param node The node to rewrite.
+         * @param in_dfn True if the node is inside the body of a dfn.
+         * @return The rewritten node.
+         */
+        ASTNode<Array>* rewrite(ASTNode<Array>* node, bool in_dfn);
+
+        /**
+         * Rewrites the arrays and dfns used by the given function node.
+         * @param node The node to rewrite.
+         * @param in_dfn True if the node is inside the body of a dfn.
+         */
+        void rewrite(ASTNode<Operation_ptr>* node, bool in_dfn);
+
+        /**
+         * Rewrites every statement of the given statements.
+         * @param node The statements to rewrite.
+         * @param in_dfn True if the statements are the body of a dfn.
+         */
+        void rewrite(Statements* node, bool in_dfn);
+
+        /**
+         * Replaces the given node with its value, if it is a pure function applied to constants.
+         * @param node The node to fold.
+         * @param in_dfn True if the node is inside the body of a dfn.
+         * @return The node that replaces the given node.
+         */
+        ASTNode<Array>* fold(ASTNode<Array>* node, bool in_dfn);
+
+        /**
+         * Removes applications of functions which return their argument unchanged.
+         * @param node The node to simplify.
+         * @return The node that replaces the given node.
+         */
+        ASTNode<Array>* simplify(ASTNode<Array>* node);
+
+        /**
+         * Marks the subexpressions of the body of the given dfn which are the same in every call.
+         * @param dfn The dfn, which is the operand of an operator applying it repeatedly.
+         */
+        void hoist(AnonymousFunction* dfn);
+
+    public:
+        /**
+         * Creates a new Optimizer.
+         * @param symbol_table_ The symbol table used when evaluating constant expressions.
+         */
+        explicit Optimizer(SymbolTable& symbol_table_);
+
+        /**
+         * Rewrites the given program.
+         * @param program The program to rewrite.
+         */
+        void optimize(Statements* program);
+    };
+};
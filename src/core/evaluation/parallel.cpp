@@ -0,0 +1,29 @@
+//
+// Copyright 2023 Nikolaj Banke Jensen.
+//
+// This file is part of Kepler.
+// 
+// Kepler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Kepler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License 
+// along with Kepler. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "parallel.h"
+#include <algorithm>
+#include <thread>
+
+namespace kepler::parallel {
+    std::size_t chunk_count(std::size_t size) {
+        static const std::size_t hardware_threads = std::max(1u, std::thread::hardware_concurrency());
+        return std::clamp<std::size_t>(size / grain_size, 1, hardware_threads);
+    }
+};
@@ -0,0 +1,61 @@
+//
+// Copyright 2023 Nikolaj Banke Jensen.
+//
+// This file is part of Kepler.
+// 
+// Kepler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Kepler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License 
+// along with Kepler. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include <cstddef>
+#include <vector>
+
+namespace kepler::parallel {
+    /**
+     * The minimum amount of elements each thread should be given.
+     *
+     * Below this, the cost of spawning a thread outweighs the work it does,
+     * so smaller inputs are processed on the calling thread only.
+     */
+    constexpr std::size_t grain_size = 1 << 15;
+
+    /**
+     * Returns the amount of chunks to split a range of the given size into.
+     *
+     * This is at most the hardware concurrency, and at least 1.
+     *
+     * @param size The size of the range.
+     * @return The amount of chunks.
+     */
+    std::size_t chunk_count(std::size_t size);
+
+    /**
+     * Splits the range [0, size) into contiguous chunks, and calls
+     * f(chunk, begin, end) for each of them, possibly in parallel.
+     *
+     * Chunks are numbered from 0 in order of their position in the range.
+     * The last chunk is processed on the calling thread. If f throws, the
+     * exception of the lowest numbered failing chunk is rethrown once all
+     * chunks have finished.
+     *
+     * @param size The size of the range.
+     * @param f The function to call for each chunk.
+     * @return The amount of chunks the range was split into.
+     */
+    template<typename F>
+    std::size_t for_chunks(std::size_t size, F&& f);
+};
+
+// Include of .tpp file goes at the bottom.
+#include "parallel.tpp"
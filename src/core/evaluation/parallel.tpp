@@ -0,0 +1,60 @@
+//
+// Copyright 2023 Nikolaj Banke Jensen.
+//
+// This file is part of Kepler.
+// 
+// Kepler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Kepler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License 
+// along with Kepler. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <thread>
+#include <exception>
+
+namespace kepler::parallel {
+    template<typename F>
+    std::size_t for_chunks(std::size_t size, F&& f) {
+        std::size_t chunks = chunk_count(size);
+        if(chunks == 1) {
+            f(0, 0, size);
+            return 1;
+        }
+
+        std::vector<std::exception_ptr> errors(chunks);
+        auto work = [&](std::size_t chunk) {
+            std::size_t begin = size * chunk / chunks;
+            std::size_t end = size * (chunk + 1) / chunks;
+            try {
+                f(chunk, begin, end);
+            } catch (...) {
+                errors[chunk] = std::current_exception();
+            }
+        };
+
+        {
+            std::vector<std::jthread> threads;
+            threads.reserve(chunks - 1);
+            for(std::size_t chunk = 0; chunk < chunks - 1; ++chunk) {
+                threads.emplace_back(work, chunk);
+            }
+            work(chunks - 1);
+        }
+
+        for(auto& error : errors) {
+            if(error) {
+                std::rethrow_exception(error);
+            }
+        }
+
+        return chunks;
+    }
+};
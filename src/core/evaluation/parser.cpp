@@ -19,6 +19,7 @@
 
 #include "parser.h"
 #include <algorithm>
+#include <optional>
 #include "core/error.h"
 #include "core/symbol_table.h"
 #include "core/literals.h"
@@ -59,80 +60,112 @@ namespace kepler {
 
 
     bool Parser::identifies_function(const Token& token) const {
-        if(!token.content.has_value()) return false;
-        String id = {token.content->begin(), token.content->end()};
+        if(token.id == no_id) return false;
+        const String& id = token.content();
         if(id == U"∇") return true;
         return symbol_table->contains(id) && symbol_table->get_type(id) == FunctionSymbol;
     }
 
-    TokenType Parser::peek_beyond_parenthesis() const {
-        auto peek_at = cursor - 1;
-        while(peek_at > before_input && peek_at->type == RIGHT_PARENS) {
-            --peek_at;
+    TokenRange Parser::shared_range(std::vector<Token>::const_iterator begin, std::vector<Token>::const_iterator end) const {
+        if(!layout->shared) {
+            auto tokens = std::make_shared<std::vector<Token>>(layout->origin, layout->origin + static_cast<long>(layout->partner.size()));
+            for(auto& token : *tokens) {
+                if(token.type == STRING && token.id == no_id) {
+                    token.id = intern(token.content(layout->input));
+                }
+            }
+            layout->shared = std::move(tokens);
         }
-        return peek_at->type;
-        //if(peek_at >= before_input) return peek_at->type;
-        //return END;
+        return {layout->shared, static_cast<std::size_t>(begin - layout->origin), static_cast<std::size_t>(end - layout->origin)};
     }
 
-    void Parser::assert_matching(const TokenType& left, const TokenType& right, const Char& right_char) const {
-        auto it = before_input + 1;
-        std::vector<std::vector<Token>::const_iterator> stack;
+    TokenType Parser::peek_beyond_parenthesis() const {
+        auto peek_at = cursor - 1;
+        return layout->origin[layout->before_parens[peek_at - layout->origin]].type;
+    }
 
-        while(it != after_input) {
-            if(it->type == left) {
-                stack.emplace_back(it);
-            } else if(it->type == right){
-                if(stack.empty()) {
-                    throw kepler::Error(SyntaxError, "Expected a matching '" + uni::utf32to8(String(1, right_char)) + "'.", position(it));
-                }
+    std::shared_ptr<const Parser::Layout> Parser::analyse(std::vector<Token>::const_iterator begin, std::vector<Token>::const_iterator end, const std::vector<Char>* input) {
+        auto result = std::make_shared<Layout>();
+        result->origin = begin;
+        result->input = input;
+        std::size_t size = end - begin;
+        result->partner.assign(size, size);
+        result->separator.assign(size, size);
+        result->before_parens.assign(size, 0);
+
+        // Match braces and parentheses in one pass, but report mismatched braces first.
+        std::vector<std::size_t> braces;
+        std::vector<std::size_t> parens;
+        std::optional<std::size_t> unmatched_brace;
+        std::optional<std::size_t> unmatched_parens;
+
+        auto match = [&](std::vector<std::size_t>& stack, std::optional<std::size_t>& unmatched, std::size_t i) {
+            if(stack.empty()) {
+                if(!unmatched) unmatched = i;
+            } else {
+                result->partner[i] = stack.back();
+                result->partner[stack.back()] = i;
                 stack.pop_back();
             }
-            ++it;
+        };
+
+        for(std::size_t i = 0; i < size; ++i) {
+            switch(begin[i].type) {
+                case LEFT_BRACE: braces.push_back(i); break;
+                case RIGHT_BRACE: match(braces, unmatched_brace, i); break;
+                case LEFT_PARENS: parens.push_back(i); break;
+                case RIGHT_PARENS: match(parens, unmatched_parens, i); break;
+                default: break;
+            }
+            result->before_parens[i] = (i > 0 && begin[i].type == RIGHT_PARENS) ? result->before_parens[i - 1] : i;
         }
 
-        if(!stack.empty()) {
-            throw kepler::Error(SyntaxError, "Expected a matching '" + uni::utf32to8(String(1, right_char)) + "'.", position(stack.back()));
+        if(!unmatched_brace && !braces.empty()) unmatched_brace = braces.back();
+        if(!unmatched_parens && !parens.empty()) unmatched_parens = parens.back();
+
+        if(unmatched_brace) {
+            throw kepler::Error(SyntaxError, "Expected a matching '}'.", begin[*unmatched_brace].get_position());
+        } else if(unmatched_parens) {
+            throw kepler::Error(SyntaxError, "Expected a matching ')'.", begin[*unmatched_parens].get_position());
         }
-    }
 
+        // Going right to left, the closest separator at the current brace depth is on top of the stack.
+        // A statement inside a dfn ends at the latest at the closing brace of that dfn.
+        std::vector<std::size_t> closest = {size};
+        for(std::size_t i = size; i-- > 0;) {
+            switch(begin[i].type) {
+                case RIGHT_BRACE:
+                    result->separator[i] = closest.back();
+                    closest.push_back(i);
+                    break;
+                case LEFT_BRACE:
+                    closest.pop_back();
+                    result->separator[i] = closest.back();
+                    break;
+                case DIAMOND:
+                    closest.back() = i;
+                    result->separator[i] = i;
+                    break;
+                default:
+                    result->separator[i] = closest.back();
+                    break;
+            }
+        }
+
+        return result;
+    }
 
     Statements* Parser::parse_program() {
-        assert_matching(LEFT_BRACE, RIGHT_BRACE, U'}');
-        assert_matching(LEFT_PARENS, RIGHT_PARENS, U')');
         return parse_statement_list();
     }
 
     std::vector<Token>::const_iterator Parser::next_separator(std::vector<Token>::const_iterator current) const {
-        auto it = current;
-        int level = 0;
-        while(it != after_input) {
-            if(it->type == LEFT_BRACE) {
-                ++level;
-            } else if(it->type == RIGHT_BRACE) {
-                --level;
-            } else if(it->type == DIAMOND && level == 0) {
-                break;
-            }
-            ++it;
-        }
-
-        return it;
+        if(current == after_input) return after_input;
+        return layout->origin + layout->separator[current - layout->origin];
     }
 
     std::vector<Token>::const_iterator Parser::matching_brace(std::vector<Token>::const_iterator index) const {
-        int level = 1;
-        auto it = index - 1;
-        while(it > before_input && level != 0) {
-            if(it->type == LEFT_BRACE) {
-                --level;
-            } else if(it->type == RIGHT_BRACE) {
-                ++level;
-            }
-            --it;
-        }
-
-        return it + 1;
+        return layout->origin + layout->partner[index - layout->origin];
     }
 
 
@@ -160,19 +193,22 @@ namespace kepler {
 
     ASTNode<Array>* Parser::parse_statement() {
         if(current().type == RIGHT_BRACE) {
+            auto definition_end = cursor + 1;
             ASTNode<Operation_ptr>* function = parse_function();
             if(current().type != ASSIGNMENT) {
                 throw kepler::Error(SyntaxError, "Expected an assignment here.", position());
             }
+            auto definition = shared_range(cursor + 1, definition_end);
             eat(ASSIGNMENT);
             if(at_end() || current().type != ID) {
                 throw kepler::Error(SyntaxError, "Expected an identifier here.", position());
             }
             Token identifier = current();
             auto statement = new FunctionAssignment(identifier, function);
+            statement->definition = std::move(definition);
             eat(ID);
 
-            symbol_table->bind_function({identifier.content->begin(), identifier.content->end()});
+            symbol_table->bind_function(identifier.content());
             return statement;
         } else {
             ASTNode<Array>* statement = parse_vector();
@@ -226,7 +262,7 @@ namespace kepler {
         auto dfn_end = cursor + 1;
 
         Parser dfn_parser;
-        auto body = dfn_parser.parse(symbol_table, dfn_start, dfn_end);
+        auto body = dfn_parser.parse(symbol_table, dfn_start, dfn_end, layout);
 
         cursor -= dfn_end - dfn_start;
         // To get back the left brace.
@@ -279,11 +315,11 @@ namespace kepler {
             return new Variable(tok);
         } else if(tok.type == NUMBER) {
             eat(NUMBER);
-            return new Scalar(tok, kepler::from_string({tok.content->begin(), tok.content->end()}));
+            return new Scalar(tok, tok.value);
         } else {
             // Must be string.
             eat(STRING);
-            return new Scalar(tok, String{tok.content->begin(), tok.content->end()});
+            return new Scalar(tok, tok.content(layout->input));
         }
     }
 
@@ -350,24 +386,24 @@ namespace kepler {
         symbol_table = new_table;
     }
 
-    Parser::Parser() : symbol_table(new SymbolTable()), cursor(), flag(), before_input(), after_input() {}
+    Parser::Parser() : symbol_table(new SymbolTable()), layout(), cursor(), flag(), before_input(), after_input() {}
 
-    Statements* Parser::parse(const std::vector<Token>& input_) {
+    Statements* Parser::parse(const std::vector<Token>& input_, const std::vector<Char>* text) {
+        layout = analyse(input_.begin(), input_.end(), text);
         before_input = input_.begin();
         after_input = input_.end();
         flag = before_input;
         cursor = before_input;
-        _tmp = input_;
         return parse_program();
     }
 
-    Statements* Parser::parse(SymbolTable* parent_table, std::vector<Token>::const_iterator begin_, std::vector<Token>::const_iterator end_) {
+    Statements* Parser::parse(SymbolTable* parent_table, std::vector<Token>::const_iterator begin_, std::vector<Token>::const_iterator end_, std::shared_ptr<const Layout> outer) {
         symbol_table->attach_parent(parent_table);
+        layout = std::move(outer);
         before_input = begin_;
         after_input = end_;
         flag = before_input;
         cursor = before_input;
-        _tmp = {begin_, end_};
         return parse_program();
     }
-};
\ No newline at end of file
+};
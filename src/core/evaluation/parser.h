@@ -19,6 +19,7 @@
 
 #pragma once
 #include "core/token.h"
+#include <memory>
 #include <vector>
 #include "core/token_type.h"
 #include "core/evaluation/ast.h"
@@ -32,8 +33,37 @@ namespace kepler {
      */
     class Parser {
     private:
+        /**
+         * The bracket and statement structure of a list of tokens.
+         *
+         * It is computed once, in a single pass over the tokens, and shared with
+         * the parsers of nested dfns, so the parser never has to scan for a bracket
+         * or separator. All indices are relative to 'origin'.
+         */
+        struct Layout {
+            // The first token of the list.
+            std::vector<Token>::const_iterator origin;
+
+            // The input the tokens were read from, holding the contents of strings, or nullptr if they are interned.
+            const std::vector<Char>* input;
+
+            // A copy of the tokens shared by the definitions of the functions assigned in them, made for the first.
+            mutable std::shared_ptr<const std::vector<Token>> shared;
+
+            // For every bracket, the index of its matching bracket.
+            std::vector<std::size_t> partner;
+
+            // For every token, the index of the separator ending a statement starting at that token.
+            std::vector<std::size_t> separator;
+
+            // For every token, the index of the closest token at or before it which is not a ')'.
+            std::vector<std::size_t> before_parens;
+        };
+
         SymbolTable* symbol_table;
 
+        std::shared_ptr<const Layout> layout;
+
         // Points to any token which the cursor is currently at.
         std::vector<Token>::const_iterator cursor;
 
@@ -46,8 +76,6 @@ namespace kepler {
         // Points to the END token after actual input.
         std::vector<Token>::const_iterator after_input;
 
-        std::vector<Token> _tmp;
-
         /**
          * Advances the cursor one step.
          *
@@ -108,6 +136,19 @@ namespace kepler {
          */
         void eat(TokenType type);
 
+        /**
+         * Computes the Layout of the tokens from begin up to end.
+         *
+         * A SyntaxError is thrown if a '{' or '(' has no matching '}' or ')', or the other way around.
+         * The error will have the closest position to where the error occurred.
+         *
+         * @param begin The first token.
+         * @param end The token past the last token.
+         * @param input The input the tokens were read from, or nullptr.
+         * @return The Layout of the tokens.
+         */
+        [[nodiscard]] static std::shared_ptr<const Layout> analyse(std::vector<Token>::const_iterator begin, std::vector<Token>::const_iterator end, const std::vector<Char>* input);
+
         /**
          * Finds the next statement separator in the input, and returns an iterator to it.
          *
@@ -121,23 +162,32 @@ namespace kepler {
         /**
          * Finds the matching brace for the brace at the given position.
          *
-         * If none is found, the begin iterator is returned.
-         *
          * @param begin The position of the brace.
          * @return The position of the matching brace.
          */
         [[nodiscard]] std::vector<Token>::const_iterator matching_brace(std::vector<Token>::const_iterator begin) const;
 
         /**
-         * Asserts that every Token of the 'left' type has a matching Token of the 'right' type.
+         * Returns the tokens from begin up to end as a range of the shared copy of the tokens in the Layout.
          *
-         * A SyntaxError is thrown if this is not the case. The error will have the closest position to
-         * where the error occurred, and right_char will be describing the expected Token.
-         * @param left The left Token type.
-         * @param right The right Token type.
-         * @param right_char The character describing the right Token type.
+         * The copy is made once, so functions defined inside one another do not copy their tokens.
+         * Definitions outlive the input, so the contents of the strings in the copy are interned.
+         *
+         * @param begin The first token.
+         * @param end The token past the last token.
+         * @return The range of the tokens.
          */
-        void assert_matching(const TokenType& left, const TokenType& right, const Char& right_char) const;
+        [[nodiscard]] TokenRange shared_range(std::vector<Token>::const_iterator begin, std::vector<Token>::const_iterator end) const;
+
+        /**
+         * Parses the tokens from begin up to end, using the Layout of an enclosing list of tokens.
+         * @param parent_table The parent table to use.
+         * @param begin The beginning of the list of tokens to parse.
+         * @param end The end of the list of tokens to parse.
+         * @param outer The Layout of a list of tokens containing begin and end.
+         * @return The AST.
+         */
+        Statements* parse(SymbolTable* parent_table, std::vector<Token>::const_iterator begin, std::vector<Token>::const_iterator end, std::shared_ptr<const Layout> outer);
 
         /**
          * Parses user defined functions.
@@ -198,18 +248,12 @@ namespace kepler {
 
         /**
          * Parses the input list of tokens and returns an AST.
+         *
+         * Strings are not interned when tokenized, so their contents are read from the input the tokens were read from.
          * @param input_ The list of tokens to parse.
+         * @param text The input the tokens were read from, or nullptr if the contents of every string are interned.
          * @return The AST.
          */
-        Statements* parse(const std::vector<Token>& input_);
-
-        /**
-         * Parses the input list of tokens and returns an AST.
-         * @param parent_table The parent table to use.
-         * @param begin The beginning of the list of tokens to parse.
-         * @param end The end of the list of tokens to parse.
-         * @return The AST.
-         */
-        Statements* parse(SymbolTable* parent_table, std::vector<Token>::const_iterator begin, std::vector<Token>::const_iterator end);
+        Statements* parse(const std::vector<Token>& input_, const std::vector<Char>* text = nullptr);
     };
 };
\ No newline at end of file
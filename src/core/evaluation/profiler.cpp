@@ -0,0 +1,201 @@
+//
+// Copyright 2023 Nikolaj Banke Jensen.
+//
+// This file is part of Kepler.
+// 
+// Kepler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Kepler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License 
+// along with Kepler. If not, see <https://www.gnu.org/licenses/>.
+//
+#include "profiler.h"
+#include "core/memory.h"
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace kepler::profiler {
+    namespace {
+        struct Entry {
+            std::uint64_t calls = 0;
+            std::chrono::nanoseconds inclusive{0};
+            std::chrono::nanoseconds exclusive{0};
+            std::uint64_t elements = 0;
+            std::uint64_t bytes = 0;
+        };
+
+        struct Frame {
+            std::string name;
+
+            // The time spent in the calls made by this call.
+            std::chrono::nanoseconds children{0};
+
+            // The bytes allocated by the calls made by this call.
+            std::uint64_t children_bytes = 0;
+        };
+
+        /**
+         * Everything recorded, which is only accessed from the thread that started profiling.
+         */
+        struct State {
+            bool active = false;
+            std::thread::id thread;
+            std::vector<Frame> stack;
+            std::map<std::string, Entry> functions;
+
+            // The exclusive time of every call stack, named by its functions separated by ';'.
+            std::map<std::string, std::chrono::nanoseconds> stacks;
+        };
+
+        State state;
+
+        double milliseconds(std::chrono::nanoseconds time) {
+            return std::chrono::duration<double, std::milli>(time).count();
+        }
+
+        std::string json_string(const std::string& text) {
+            std::ostringstream out;
+            out << '"';
+            for(unsigned char c : text) {
+                if(c == '"' || c == '\\') {
+                    out << '\\' << c;
+                } else if(c < 0x20) {
+                    out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+                } else {
+                    out << c;
+                }
+            }
+            out << '"';
+            return out.str();
+        }
+
+        // The recorded functions, most exclusive time first.
+        std::vector<std::pair<std::string, Entry>> sorted_functions() {
+            std::vector<std::pair<std::string, Entry>> result(state.functions.begin(), state.functions.end());
+            std::stable_sort(result.begin(), result.end(), [](auto& lhs, auto& rhs) {
+                return lhs.second.exclusive > rhs.second.exclusive;
+            });
+            return result;
+        }
+    }
+
+    void start() {
+        state.active = true;
+        state.thread = std::this_thread::get_id();
+    }
+
+    void stop() {
+        state.active = false;
+    }
+
+    void clear() {
+        state.functions.clear();
+        state.stacks.clear();
+    }
+
+    bool enabled() {
+        return state.active && state.thread == std::this_thread::get_id();
+    }
+
+    std::string report(Format format) {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(3);
+
+        if(format == TextFormat) {
+            // The name goes last, as names are not all as wide as their number of bytes.
+            out << std::setw(10) << "calls" << std::setw(15) << "inclusive ms" << std::setw(15) << "exclusive ms"
+                << std::setw(14) << "elements" << std::setw(14) << "bytes" << "  function";
+            for(auto& [name, entry] : sorted_functions()) {
+                out << '\n' << std::setw(10) << entry.calls << std::setw(15) << milliseconds(entry.inclusive)
+                    << std::setw(15) << milliseconds(entry.exclusive) << std::setw(14) << entry.elements
+                    << std::setw(14) << entry.bytes << "  " << name;
+            }
+        } else if(format == JsonFormat) {
+            out << "{\"functions\":[";
+            bool first = true;
+            for(auto& [name, entry] : sorted_functions()) {
+                out << (first ? "" : ",") << "{\"name\":" << json_string(name) << ",\"calls\":" << entry.calls
+                    << ",\"inclusive_ms\":" << milliseconds(entry.inclusive) << ",\"exclusive_ms\":" << milliseconds(entry.exclusive)
+                    << ",\"elements\":" << entry.elements << ",\"bytes\":" << entry.bytes << "}";
+                first = false;
+            }
+            out << "]}";
+        } else {
+            // Flame graph tools expect whole numbers, so times are given in microseconds.
+            bool first = true;
+            for(auto& [stack, time] : state.stacks) {
+                out << (first ? "" : "\n") << stack << ' ' << std::chrono::duration_cast<std::chrono::microseconds>(time).count();
+                first = false;
+            }
+        }
+        return out.str();
+    }
+
+    bool parse_format(const std::string& name, Format& format) {
+        if(name == "text") {
+            format = TextFormat;
+        } else if(name == "json") {
+            format = JsonFormat;
+        } else if(name == "folded") {
+            format = FoldedFormat;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    Scope::Scope(std::string name) : started(std::chrono::steady_clock::now()), allocated(memory::usage().allocated) {
+        state.stack.push_back({std::move(name)});
+    }
+
+    Scope::~Scope() {
+        auto inclusive = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - started);
+
+        // The counter starts again from zero if it is cleared during the call.
+        std::size_t now = memory::usage().allocated;
+        std::uint64_t bytes = now >= allocated ? now - allocated : now;
+        Frame frame = std::move(state.stack.back());
+        state.stack.pop_back();
+
+        auto exclusive = std::max(inclusive - frame.children, std::chrono::nanoseconds(0));
+        if(!state.stack.empty()) {
+            state.stack.back().children += inclusive;
+            state.stack.back().children_bytes += bytes;
+        }
+
+        auto& entry = state.functions[frame.name];
+        ++entry.calls;
+        entry.exclusive += exclusive;
+        entry.elements += elements;
+        entry.bytes += bytes - std::min(bytes, frame.children_bytes);
+
+        // The inclusive time of a recursive call is already part of that of the outermost call.
+        bool recursive = std::any_of(state.stack.begin(), state.stack.end(), [&](const Frame& outer) {
+            return outer.name == frame.name;
+        });
+        if(!recursive) {
+            entry.inclusive += inclusive;
+        }
+
+        std::string stack;
+        for(auto& outer : state.stack) {
+            stack += outer.name + ";";
+        }
+        state.stacks[stack + frame.name] += exclusive;
+    }
+
+    void Scope::record(std::size_t elements_) {
+        elements = elements_;
+    }
+};
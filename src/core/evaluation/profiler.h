@@ -0,0 +1,117 @@
+//
+// Copyright 2023 Nikolaj Banke Jensen.
+//
+// This file is part of Kepler.
+// 
+// Kepler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Kepler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License 
+// along with Kepler. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace kepler::profiler {
+
+    /**
+     * The formats in which a profile can be reported.
+     */
+    enum Format {
+        // A table of the functions, most expensive first.
+        TextFormat,
+
+        // An object holding an array of the functions.
+        JsonFormat,
+
+        // A line per call stack, with the time spent in its innermost function, as read by flame graph tools.
+        FoldedFormat,
+    };
+
+    /**
+     * Starts recording the calls of functions made on the calling thread.
+     *
+     * Recordings of earlier runs are kept, so profiling can be stopped and started again.
+     */
+    void start();
+
+    /**
+     * Stops recording calls.
+     */
+    void stop();
+
+    /**
+     * Discards everything recorded.
+     */
+    void clear();
+
+    /**
+     * Returns true if calls made on the calling thread are being recorded.
+     */
+    bool enabled();
+
+    /**
+     * Reports what has been recorded.
+     *
+     * @param format The format of the report.
+     * @return The report.
+     */
+    std::string report(Format format);
+
+    /**
+     * Parses the name of a format, as given on the command line or to '⎕PROFILE'.
+     *
+     * @param name The name: 'text', 'json' or 'folded'.
+     * @param format Set to the format, if the name is known.
+     * @return True if the name is known.
+     */
+    bool parse_format(const std::string& name, Format& format);
+
+    /**
+     * Records a single call of a function, from construction to destruction.
+     *
+     * Calls made while the Scope exists are its children: their time is part of the
+     * inclusive time of this call, but not of its exclusive time. The bytes of a call are
+     * those counted by memory as allocated while it ran, less those of its children.
+     */
+    class Scope {
+    private:
+        std::chrono::steady_clock::time_point started;
+        std::size_t elements = 0;
+        std::size_t allocated;
+
+    public:
+        /**
+         * Starts recording a call, which must be made while profiling is enabled.
+         *
+         * @param name The name of the function.
+         */
+        explicit Scope(std::string name);
+
+        /**
+         * Finishes recording the call.
+         */
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        /**
+         * Records the size of the arguments and result of the call.
+         *
+         * @param elements_ The number of elements of the arguments and the result.
+         */
+        void record(std::size_t elements_);
+    };
+};
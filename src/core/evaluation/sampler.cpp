@@ -0,0 +1,174 @@
+//
+// Copyright 2023 Nikolaj Banke Jensen.
+//
+// This file is part of Kepler.
+// 
+// Kepler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Kepler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License 
+// along with Kepler. If not, see <https://www.gnu.org/licenses/>.
+//
+#include "sampler.h"
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "uni_algo/conv.h"
+
+namespace kepler::sampler {
+    namespace detail {
+        thread_local bool tracking = false;
+    }
+
+    namespace {
+        /**
+         * The positions of the calls being made on the sampled thread.
+         *
+         * The sampled thread is the only one writing to it, and the sampling thread only reads it.
+         * A sample may thus see a call stack which is being changed, which only ever misplaces that one sample.
+         */
+        std::array<std::atomic<long>, max_depth> frames;
+        std::atomic<std::size_t> depth = 0;
+
+        std::jthread sampling_thread;
+        std::mutex mutex;
+        std::condition_variable_any wake;
+        std::chrono::microseconds sampling_interval = default_interval;
+
+        // The number of samples of every call stack, listed from the outermost call.
+        std::map<std::vector<long>, std::size_t> samples;
+
+        void sample(std::stop_token stop) {
+            std::vector<long> stack;
+            std::unique_lock lock(mutex);
+            while(true) {
+                // Waits out the interval, unless asked to stop.
+                wake.wait_for(lock, stop, sampling_interval, [] { return false; });
+                if(stop.stop_requested()) {
+                    break;
+                }
+                auto size = std::min(depth.load(std::memory_order_acquire), max_depth);
+                stack.resize(size);
+                for(std::size_t i = 0; i < size; ++i) {
+                    stack[i] = frames[i].load(std::memory_order_relaxed);
+                }
+                ++samples[stack];
+            }
+        }
+
+        // The line and column of a position, both counted from 1.
+        std::pair<std::size_t, long> locate(const Source& source, long position) {
+            auto line = source.line_of(position);
+            return {line + 1, std::max(position - static_cast<long>(source.line_starts[line]), 1L)};
+        }
+    }
+
+    void detail::push(long position) {
+        auto current = depth.load(std::memory_order_relaxed);
+        if(current < max_depth) {
+            frames[current].store(position, std::memory_order_relaxed);
+        }
+        depth.store(current + 1, std::memory_order_release);
+    }
+
+    void detail::pop() {
+        depth.store(depth.load(std::memory_order_relaxed) - 1, std::memory_order_release);
+    }
+
+    void start(std::chrono::microseconds interval) {
+        stop();
+        samples.clear();
+        depth.store(0);
+        sampling_interval = interval;
+        detail::tracking = true;
+        sampling_thread = std::jthread(sample);
+    }
+
+    void stop() {
+        detail::tracking = false;
+        if(sampling_thread.joinable()) {
+            sampling_thread.request_stop();
+            sampling_thread.join();
+        }
+    }
+
+    std::string report(Format format, const Source& source) {
+        std::ostringstream out;
+
+        if(format == CollapsedFormat) {
+            bool first = true;
+            for(auto& [stack, count] : samples) {
+                if(stack.empty()) {
+                    // Samples taken outside of calls, such as while parsing.
+                    continue;
+                }
+                out << (first ? "" : "\n");
+                for(std::size_t i = 0; i < stack.size(); ++i) {
+                    auto [line, column] = locate(source, stack[i]);
+                    out << (i == 0 ? "" : ";") << line << ':' << column;
+                }
+                out << ' ' << count;
+                first = false;
+            }
+            return out.str();
+        }
+
+        // Samples are attributed to the line of the innermost call (self), and to every line on the stack (total).
+        std::size_t count = 0;
+        std::size_t lines = source.line_starts.size();
+        std::vector<std::size_t> self(lines);
+        std::vector<std::size_t> total(lines);
+        for(auto& [stack, taken] : samples) {
+            count += taken;
+            std::vector<std::size_t> seen;
+            for(auto position : stack) {
+                auto line = source.line_of(position);
+                if(std::find(seen.begin(), seen.end(), line) == seen.end()) {
+                    total[line] += taken;
+                    seen.push_back(line);
+                }
+            }
+            if(!stack.empty()) {
+                self[source.line_of(stack.back())] += taken;
+            }
+        }
+
+        out << count << " samples, one every " << sampling_interval.count() << " µs\n";
+        out << std::setw(8) << "self" << std::setw(8) << "total" << std::setw(7) << "line";
+        for(std::size_t line = 0; line < lines; ++line) {
+            out << '\n';
+            if(total[line] > 0) {
+                out << std::setw(8) << self[line] << std::setw(8) << total[line];
+            } else {
+                out << std::setw(16) << "";
+            }
+            auto text = source.line(line);
+            out << std::setw(7) << line + 1 << "  " << uni::utf32to8(std::u32string(text.begin(), text.end()));
+        }
+        return out.str();
+    }
+
+    bool parse_format(const std::string& name, Format& format) {
+        if(name == "annotated") {
+            format = AnnotatedFormat;
+        } else if(name == "collapsed") {
+            format = CollapsedFormat;
+        } else {
+            return false;
+        }
+        return true;
+    }
+};
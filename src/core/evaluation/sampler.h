@@ -0,0 +1,120 @@
+//
+// Copyright 2023 Nikolaj Banke Jensen.
+//
+// This file is part of Kepler.
+// 
+// Kepler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Kepler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License 
+// along with Kepler. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include "interface/file_reader.h"
+
+namespace kepler::sampler {
+
+    /**
+     * The time between two samples, unless another is given when sampling starts.
+     */
+    constexpr std::chrono::microseconds default_interval{1000};
+
+    /**
+     * The deepest call stack which is sampled in full. Deeper calls are attributed to their caller at this depth.
+     */
+    constexpr std::size_t max_depth = 256;
+
+    /**
+     * The formats in which samples can be reported.
+     */
+    enum Format {
+        // The source, with the samples taken on each of its lines.
+        AnnotatedFormat,
+
+        // A line per sampled call stack, as read by flame graph tools.
+        CollapsedFormat,
+    };
+
+    /**
+     * Starts sampling the calls made on the calling thread.
+     *
+     * A separate thread wakes up at every interval, and records the position in the source of
+     * every call currently being made. Samples of earlier runs are discarded.
+     *
+     * @param interval The time between two samples.
+     */
+    void start(std::chrono::microseconds interval = default_interval);
+
+    /**
+     * Stops sampling, keeping the samples taken for reporting.
+     */
+    void stop();
+
+    /**
+     * Reports the samples taken, attributing them to the lines of the given source.
+     *
+     * @param format The format of the report.
+     * @param source The source the positions of calls refer to.
+     * @return The report.
+     */
+    std::string report(Format format, const Source& source);
+
+    /**
+     * Parses the name of a format, as given on the command line.
+     *
+     * @param name The name: 'annotated' or 'collapsed'.
+     * @param format Set to the format, if the name is known.
+     * @return True if the name is known.
+     */
+    bool parse_format(const std::string& name, Format& format);
+
+    namespace detail {
+        // Whether calls made on this thread are being sampled.
+        extern thread_local bool tracking;
+
+        void push(long position);
+        void pop();
+    }
+
+    /**
+     * Marks a call as being made at the given position in the source, from construction to destruction.
+     *
+     * This costs a check of a thread local flag when sampling is off, so it can be used on every call.
+     */
+    class Frame {
+    private:
+        bool pushed;
+
+    public:
+        /**
+         * Marks the call, if the calls on this thread are being sampled.
+         * @param position The position of the function in the source.
+         */
+        explicit Frame(long position) : pushed(detail::tracking) {
+            if(pushed) {
+                detail::push(position);
+            }
+        }
+
+        ~Frame() {
+            if(pushed) {
+                detail::pop();
+            }
+        }
+
+        Frame(const Frame&) = delete;
+        Frame& operator=(const Frame&) = delete;
+    };
+};
@@ -0,0 +1,116 @@
+//
+// Copyright 2023 Nikolaj Banke Jensen.
+//
+// This file is part of Kepler.
+// 
+// Kepler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Kepler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License 
+// along with Kepler. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "sorting.h"
+#include "core/evaluation/parallel.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+#include <thread>
+
+namespace kepler {
+    namespace {
+        /**
+         * Sorts positions stably by their (unsigned) radix keys, one byte at a time,
+         * starting from the least significant byte.
+         */
+        template<typename Key>
+        std::vector<std::size_t> radix_grade(const std::vector<Key>& keys) {
+            std::vector<std::size_t> order(keys.size());
+            std::iota(order.begin(), order.end(), 0);
+            std::vector<std::size_t> buffer(keys.size());
+
+            for(unsigned int shift = 0; shift < sizeof(Key) * 8; shift += 8) {
+                std::array<std::size_t, 257> offsets{};
+                for(auto key : keys) {
+                    ++offsets[((key >> shift) & 0xFF) + 1];
+                }
+
+                // A pass where every key has the same byte would not move anything.
+                if(std::any_of(offsets.begin(), offsets.end(), [&](std::size_t count) { return count == keys.size(); })) {
+                    continue;
+                }
+
+                std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+                for(auto position : order) {
+                    buffer[offsets[(keys[position] >> shift) & 0xFF]++] = position;
+                }
+                std::swap(order, buffer);
+            }
+
+            return order;
+        }
+    }
+
+    std::vector<std::size_t> grade(std::span<const std::int64_t> keys, bool descending) {
+        std::vector<std::uint64_t> radix_keys(keys.size());
+        for(std::size_t i = 0; i < keys.size(); ++i) {
+            // Flipping the sign bit makes the unsigned order match the signed order,
+            // and complementing the key reverses it while keeping equal keys in order.
+            auto key = static_cast<std::uint64_t>(keys[i]) ^ (std::uint64_t{1} << 63);
+            radix_keys[i] = descending ? ~key : key;
+        }
+        return radix_grade(radix_keys);
+    }
+
+    std::vector<std::size_t> grade(std::span<const Char> keys, bool descending) {
+        std::vector<std::uint32_t> radix_keys(keys.size());
+        for(std::size_t i = 0; i < keys.size(); ++i) {
+            auto key = static_cast<std::uint32_t>(keys[i]);
+            radix_keys[i] = descending ? ~key : key;
+        }
+        return radix_grade(radix_keys);
+    }
+
+    std::vector<std::size_t> grade(std::span<const double> keys, bool descending) {
+        std::vector<std::size_t> order(keys.size());
+        std::iota(order.begin(), order.end(), 0);
+
+        // NaN is ordered after every number, and NaNs are equal to each other, so the order is a strict weak ordering.
+        auto less = [](double lhs, double rhs) {
+            return !std::isnan(lhs) && (std::isnan(rhs) || lhs < rhs);
+        };
+        auto compare = [&](std::size_t lhs, std::size_t rhs) {
+            return descending ? less(keys[rhs], keys[lhs]) : less(keys[lhs], keys[rhs]);
+        };
+
+        // Sort chunks in parallel, remembering where each chunk ends.
+        std::vector<std::size_t> bounds(parallel::chunk_count(keys.size()) + 1, 0);
+        parallel::for_chunks(keys.size(), [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+            std::stable_sort(order.begin() + begin, order.begin() + end, compare);
+            bounds[chunk + 1] = end;
+        });
+
+        // Merge neighbouring chunks until a single one remains. Since the left chunk
+        // precedes the right one, std::inplace_merge keeps equal keys in order.
+        // The merges of each round are independent, so they run in parallel as well.
+        for(std::size_t width = 1; width + 1 < bounds.size(); width *= 2) {
+            std::vector<std::jthread> merges;
+            for(std::size_t i = 0; i + width + 1 < bounds.size(); i += 2 * width) {
+                std::size_t last = std::min(i + 2 * width, bounds.size() - 1);
+                merges.emplace_back([&, i, width, last]() {
+                    std::inplace_merge(order.begin() + bounds[i], order.begin() + bounds[i + width], order.begin() + bounds[last], compare);
+                });
+            }
+        }
+
+        return order;
+    }
+};
@@ -0,0 +1,65 @@
+//
+// Copyright 2023 Nikolaj Banke Jensen.
+//
+// This file is part of Kepler.
+// 
+// Kepler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Kepler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License 
+// along with Kepler. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "core/datatypes.h"
+
+namespace kepler {
+    /**
+     * Returns the permutation which sorts the keys, i.e. the grade of the keys.
+     *
+     * Integer keys are sorted with an LSD radix sort, skipping the passes over
+     * bytes which are equal for every key.
+     * The sort is stable, also when sorting descending.
+     *
+     * @param keys The keys to grade.
+     * @param descending Whether to sort descending rather than ascending.
+     * @return The permutation, as positions in keys.
+     */
+    std::vector<std::size_t> grade(std::span<const std::int64_t> keys, bool descending);
+
+    /**
+     * Returns the permutation which sorts the keys, i.e. the grade of the keys.
+     *
+     * Chars are sorted by code point, with an LSD radix sort.
+     *
+     * @param keys The keys to grade.
+     * @param descending Whether to sort descending rather than ascending.
+     * @return The permutation, as positions in keys.
+     */
+    std::vector<std::size_t> grade(std::span<const Char> keys, bool descending);
+
+    /**
+     * Returns the permutation which sorts the keys, i.e. the grade of the keys.
+     *
+     * Floating point keys are sorted with a merge sort, where large inputs are
+     * split into chunks which are sorted in parallel, and then merged.
+     * The sort is stable, also when sorting descending. NaN is ordered after
+     * every number, so NaNs come last when ascending and first when descending.
+     *
+     * @param keys The keys to grade.
+     * @param descending Whether to sort descending rather than ascending.
+     * @return The permutation, as positions in keys.
+     */
+    std::vector<std::size_t> grade(std::span<const double> keys, bool descending);
+};
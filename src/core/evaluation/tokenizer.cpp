@@ -18,11 +18,83 @@
 //
 
 #include <algorithm>
+#include <array>
 #include "tokenizer.h"
 #include "core/literals.h"
 #include "core/error.h"
 
 namespace kepler {
+    namespace {
+        // Classes a character can belong to, as bit flags.
+        enum CharClass : std::uint8_t {
+            DIGIT = 1,
+            IDENTIFIER = 2,
+            SYMBOL = 4,
+        };
+
+        struct CharInfo {
+            std::uint8_t classes = 0;
+            TokenType symbol = END;
+        };
+
+        /**
+         * Classification of every character the tokenizer distinguishes.
+         *
+         * All characters of the language lie in Latin-1 or in the block of
+         * arrows, mathematical operators, technical symbols and shapes used by APL,
+         * so two flat arrays classify any character with a single lookup.
+         */
+        class CharTable {
+        public:
+            CharTable() {
+                for(auto c : constants::digit) {
+                    info(c).classes |= DIGIT;
+                }
+                for(auto c : constants::identifier_chars) {
+                    info(c).classes |= IDENTIFIER;
+                }
+                for(auto c : constants::symbols) {
+                    info(c).classes |= SYMBOL;
+                    info(c).symbol = constants::symbol_mapping.at(c);
+                }
+            }
+
+            [[nodiscard]] const CharInfo& operator[](Char c) const {
+                static const CharInfo none;
+                if(c < latin.size()) {
+                    return latin[c];
+                } else if(c >= apl_begin && c - apl_begin < apl.size()) {
+                    return apl[c - apl_begin];
+                }
+                return none;
+            }
+
+        private:
+            static constexpr Char apl_begin = 0x2190;
+            static constexpr Char apl_end = 0x2600;
+
+            std::array<CharInfo, 0x100> latin{};
+            std::array<CharInfo, apl_end - apl_begin> apl{};
+
+            CharInfo& info(Char c) {
+                if(c < latin.size()) {
+                    return latin[c];
+                } else if(c >= apl_begin && c < apl_end) {
+                    return apl[c - apl_begin];
+                }
+                throw kepler::Error(InternalError, "Character of the language is outside the classification table.");
+            }
+        };
+
+        const CharTable& char_table() {
+            static const CharTable table;
+            return table;
+        }
+
+        bool is(Char c, CharClass char_class) {
+            return char_table()[c].classes & char_class;
+        }
+    }
 
     void Tokenizer::advance() {
         if(!at_end()) cursor++;
@@ -40,12 +112,6 @@ namespace kepler {
         return cursor >= input->size();
     }
 
-
-    bool Tokenizer::one_of(const Char& ch, const String& elements) const {
-        return std::any_of(elements.begin(), elements.end(), [&](const Char& element) { return ch == element; });
-    }
-
-
     void Tokenizer::skip_blanks() {
         while(!at_end() && current() == U' ') {
             advance();
@@ -60,87 +126,88 @@ namespace kepler {
         }
     }
 
-    String Tokenizer::get_integer() {
+    int Tokenizer::scan_integer() {
         int start = cursor;
-        while(!at_end() && one_of(current(), constants::digit)) {
+        while(!at_end() && is(current(), DIGIT)) {
             advance();
         }
-        return {input->begin() + start, input->begin() + cursor};
+        return cursor - start;
     }
 
-    String Tokenizer::get_exponent() {
-        String exponent;
-
+    void Tokenizer::scan_exponent() {
         if(!at_end() && current() == constants::exponent_marker) {
             advance();
-            exponent += constants::exponent_marker;
             if(!at_end() && current() == U'¯') {
                 advance();
-                exponent += U'-';
             }
-            String integer = get_integer();
-            if(integer.empty()) {
+            if(scan_integer() == 0) {
                 throw kepler::Error(SyntaxError, "Expected a digit here.", cursor + 1);
             }
-            exponent += integer;
         }
-
-        return exponent;
     }
 
-    String Tokenizer::get_real_number() {
-        String number;
-
-        if(!at_end() && current() == U'¯') {
+    void Tokenizer::scan_real_number() {
+        bool negative = !at_end() && current() == U'¯';
+        if(negative) {
             advance();
-            number += '-';
         }
-        number += get_integer();
 
-        if(!at_end() && current() == U'.') {
+        int digits = scan_integer();
+
+        bool point = !at_end() && current() == U'.';
+        if(point) {
             advance();
-            number += '.';
         }
 
-        number += get_integer();
+        digits += scan_integer();
 
-        if(number.empty()) {
+        if(digits == 0 && !negative && !point) {
             throw kepler::Error(SyntaxError, "Expected at least one digit here.", cursor);
-        } else if(number == U".") {
+        } else if(digits == 0 && !negative) {
             throw kepler::Error(SyntaxError, "Expected at least one digit on either side.", cursor);
-        } else if(number == U"-") {
+        } else if(digits == 0 && !point) {
             throw kepler::Error(SyntaxError, "Expected at least one digit here.", cursor + 1);
         }
 
-        number += get_exponent();
-        return number;
+        scan_exponent();
+    }
+
+    std::u32string_view Tokenizer::span(int start) const {
+        return {input->data() + start, static_cast<std::size_t>(cursor - start)};
     }
 
     Token Tokenizer::number_token() {
-        String number = get_real_number();
+        int start = cursor;
+        scan_real_number();
 
         if(!at_end() && current() == constants::complex_marker) {
             advance();
-            number += constants::complex_marker;
+            scan_real_number();
+        }
 
-            String real = get_real_number();
-            number += real;
+        // Only the value of the number is kept, so its text is not interned.
+        Number value;
+        try {
+            value = kepler::from_string(span(start));
+        } catch(kepler::Error& err) {
+            err.position = start + 1;
+            throw;
         }
 
-        return {cursor, NUMBER, number};
+        return {NUMBER, start, cursor - start, no_id, value};
     }
 
     Token Tokenizer::identifier_token() {
         int start = cursor;
-        while(!at_end() && one_of(current(), constants::identifier_chars)) {
+        while(!at_end() && is(current(), IDENTIFIER)) {
             advance();
         }
-        return {cursor, ID, {input->begin() + start, input->begin() + cursor}};
+        return {ID, start, cursor - start, intern(span(start))};
     }
 
     Token Tokenizer::string_token() {
-        advance();
         int start = cursor;
+        advance();
 
         while(!at_end() && current() != U'\'') {
             advance();
@@ -150,17 +217,16 @@ namespace kepler {
             throw kepler::Error(SyntaxError, "Expected a matching quote.", cursor + 1);
         }
 
-        String result = {input->begin() + start, input->begin() + cursor};
-
-        // Go past quote.
+        // Go past quote. The content is read from the input when the string is parsed, so it is not interned.
         advance();
-        return {cursor, STRING, result};
+        return {STRING, start, cursor - start};
     }
 
     Token Tokenizer::primitive_token() {
-        char32_t character = current();
+        int start = cursor;
+        TokenType type = char_table()[current()].symbol;
         advance();
-        return {cursor, constants::symbol_mapping.at(character), character};
+        return {type, start, 1, intern(span(start))};
     }
 
     Token Tokenizer::next_token() {
@@ -168,14 +234,17 @@ namespace kepler {
         skip_comment();
 
         if(at_end()) {
-            return {cursor, END};
-        } else if(one_of(current(), U"¯0123456789") || (current() == U'.' && !one_of(peek(), constants::symbols))) {
+            return {END, cursor, 0};
+        }
+
+        Char c = current();
+        if(is(c, DIGIT) || c == U'¯' || (c == U'.' && (static_cast<std::size_t>(cursor) + 1 >= input->size() || !is(peek(), SYMBOL)))) {
             return number_token();
-        } else if(one_of(current(), constants::identifier_chars)) {
+        } else if(is(c, IDENTIFIER)) {
             return identifier_token();
-        } else if(one_of(current(), constants::symbols)) {
+        } else if(is(c, SYMBOL)) {
             return primitive_token();
-        } else if(current() == U'\'') {
+        } else if(c == U'\'') {
             return string_token();
         } else {
             throw kepler::Error(SyntaxError, "Unexpected symbol.", cursor + 1);
@@ -188,15 +257,44 @@ namespace kepler {
         cursor = 0;
         input = input_;
 
-        std::vector<Token> result = {next_token()};
+        std::vector<Token> result = {Token(END, -1, 0), next_token()};
 
         while(result.back().type != END) {
-            result.emplace_back(std::move(next_token()));
+            result.emplace_back(next_token());
         }
 
         result.pop_back();
-        result.insert(result.begin(), Token(-1, END));
 
         return result;
     }
-};
\ No newline at end of file
+
+    std::size_t Tokenizer::statement_end(const std::vector<Char>& input, std::size_t start) {
+        int depth = 0;
+        bool guarded = false;
+
+        for(std::size_t i = start; i < input.size(); ++i) {
+            Char c = input[i];
+            if(c == U'\'') {
+                while(i + 1 < input.size() && input[i + 1] != U'\'') {
+                    ++i;
+                }
+                ++i;
+            } else if(c == U'⍝') {
+                while(i + 1 < input.size() && input[i + 1] != U'\n') {
+                    ++i;
+                }
+            } else if(c == U'{') {
+                ++depth;
+            } else if(c == U'}') {
+                // A stray brace is left for the parser to report.
+                depth = std::max(depth - 1, 0);
+            } else if(depth == 0 && c == U':') {
+                guarded = true;
+            } else if(depth == 0 && !guarded && char_table()[c].symbol == DIAMOND) {
+                return i;
+            }
+        }
+
+        return input.size();
+    }
+};
@@ -64,14 +64,6 @@ namespace kepler {
          */
         [[nodiscard]] bool at_end() const;
 
-        /**
-         * Checks if the given character is one of the characters in the string.
-         * @param ch The character to check.
-         * @param elements The elements to check against.
-         * @return True if the character is one of the elements, false otherwise.
-         */
-        [[nodiscard]] bool one_of(const Char& ch, const String& elements) const;
-
         /**
          * Skips all blanks.
          */
@@ -85,27 +77,36 @@ namespace kepler {
         void skip_comment();
 
         /**
-         * Returns a string of characters which denote a contiguous
-         * segment of the input that forms a valid integer.
+         * Advances the cursor past a contiguous segment
+         * of the input that forms a valid integer.
+         *
+         * @return The number of digits in the integer.
+         */
+        int scan_integer();
+
+        /**
+         * Advances the cursor past a contiguous segment of the
+         * input that forms a valid exponent of a number, if any.
          */
-        String get_integer();
+        void scan_exponent();
 
         /**
-         * Returns a string of characters which denote a contiguous
-         * segment of the input that forms a valid exponent of a number.
+         * Advances the cursor past a contiguous segment
+         * of the input that forms a valid real number.
          */
-        String get_exponent();
+        void scan_real_number();
 
         /**
-         * Returns a string of characters which denote a contiguous
-         * segment of the input that forms a valid real number.
+         * Returns the input from start up to the cursor.
+         * @param start The position of the first character.
+         * @return A view of the input.
          */
-        String get_real_number();
+        [[nodiscard]] std::u32string_view span(int start) const;
 
         /**
          * Returns a number token identifier.
          *
-         * The token contains the numbers as content.
+         * The token contains the number as content, and its parsed value.
          * The cursor is advanced.
          *
          * @return The identifier token.
@@ -163,5 +164,18 @@ namespace kepler {
          * @return A list of tokens.
          */
         std::vector<Token> tokenize(const std::vector<Char>* input_);
+
+        /**
+         * Finds the end of the top-level statement starting at the given offset, without tokenizing it.
+         *
+         * A statement ends at the first separator outside of braces, strings and comments.
+         * A guarded statement at the top level applies to all the statements after it, so it
+         * extends to the end of the input.
+         *
+         * @param input The input to search.
+         * @param start The offset of the first character of the statement.
+         * @return The offset of the separator ending the statement, or the size of the input.
+         */
+        static std::size_t statement_end(const std::vector<Char>& input, std::size_t start);
     };
 };
@@ -19,7 +19,10 @@
 
 #include "helpers.h"
 #include "literals.h"
-#include <iomanip>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <string_view>
 #include "error.h"
 
 bool kepler::helpers::is_function(TokenType type) {
@@ -29,7 +32,8 @@ bool kepler::helpers::is_function(TokenType type) {
            || type == WITHOUT || type == LEFT_SHOE || type == RHO || type == AND || type == OR
            || type == NAND || type == NOR || type == CIRCLE_BAR || type == CIRCLE_STILE || type == QUESTION_MARK
            || type == CIRCLE || type == STAR || type == LOG || type == BAR || type == EXCLAMATION_MARK
-           || type == COMMA || type == ARROW_UP;
+           || type == COMMA || type == ARROW_UP || type == EPSILON || type == DOWN_SHOE || type == UP_SHOE
+           || type == DELTA_STILE || type == DEL_STILE;
 }
 
 bool kepler::helpers::is_monadic_function(TokenType type) {
@@ -65,58 +69,76 @@ void kepler::helpers::check_valid_system_param_value(const String &id, const Num
         if(value.real() < 1 || value.real() > 30) {
             throw kepler::Error(LimitError, "Print precision must be between 1 and 30.");
         }
+    } else if(id == constants::print_width_id) {
+        if(value.real() < 30 || value.real() > 32767 || value.real() != std::floor(value.real())) {
+            throw kepler::Error(LimitError, "Print width must be a whole number between 30 and 32767.");
+        }
     }
 }
 
-std::string kepler::helpers::double_to_string(const double& num, int precision) {
-    std::stringstream ss;
-    ss << std::setprecision(precision);
-    ss << num;
-
-    std::string raw = ss.str();
-
-    if(!raw.empty() && raw.front() == '-') {
-        raw.erase(0, 1);
-        if(raw != "0") {
-            raw.insert(0, "¯");
+namespace {
+    // Writes a double into the buffer as in APL, returning a pointer just past it.
+    char* format_double(char* out, double num, int precision) {
+        char digits[64];
+        auto end = std::to_chars(digits, digits + sizeof(digits), num, std::chars_format::general, precision).ptr;
+        std::string_view raw(digits, end - digits);
+
+        if(raw.front() == '-') {
+            raw.remove_prefix(1);
+            if(raw != "0") {
+                out = std::copy_n("¯", 2, out);
+            }
         }
-    }
-
-    auto e_index = raw.find_first_of('e');
-    if(e_index != std::string::npos) {
-        auto mantissa_string = raw.substr(e_index + 1);
-        raw.erase(e_index);
-
-        int mantissa = std::stoi(mantissa_string);
 
-        if(mantissa > 0 && mantissa < precision) {
-            raw += std::string(mantissa, '0');
-        } else if(mantissa < 0 && -mantissa < precision - 3) {
-            raw = "0." + std::string(abs(mantissa) - 1, '0') + raw;
-        } else {
-            bool negative_mantissa = mantissa_string.front() == '-';
-            mantissa_string.erase(0, 1);
-
-            mantissa_string.erase(0, std::min(mantissa_string.find_first_not_of('0'), mantissa_string.size()-1));
+        auto e_index = raw.find('e');
+        if(e_index == std::string_view::npos) {
+            return std::copy(raw.begin(), raw.end(), out);
+        }
 
-            if(negative_mantissa && mantissa_string != "0") {
-                mantissa_string.insert(0, "¯");
+        auto significand = raw.substr(0, e_index);
+        auto exponent_string = raw.substr(e_index + 1);
+        bool negative_exponent = exponent_string.front() == '-';
+        int exponent = 0;
+        std::from_chars(exponent_string.data() + 1, exponent_string.data() + exponent_string.size(), exponent);
+
+        if(negative_exponent && exponent < precision - 3) {
+            // Small numbers are written in full while they have few enough leading zeros.
+            out = std::copy_n("0.", 2, out);
+            out = std::fill_n(out, exponent - 1, '0');
+            for(char c : significand) {
+                if(c != '.') {
+                    *out++ = c;
+                }
             }
+            return out;
+        }
 
-            raw += "E" + mantissa_string;
+        out = std::copy(significand.begin(), significand.end(), out);
+        *out++ = static_cast<char>(kepler::constants::exponent_marker);
+        if(negative_exponent) {
+            out = std::copy_n("¯", 2, out);
         }
+        return std::to_chars(out, out + 8, exponent).ptr;
     }
-
-    return raw;
 }
 
-std::string kepler::helpers::number_to_string(const kepler::Number& num, int precision) {
-    String result = uni::utf8to32u(kepler::helpers::double_to_string(num.real(), precision));
+char* kepler::helpers::format_number(char* out, const Number& num, int precision) {
+    out = format_double(out, num.real(), precision);
 
-    if (num.imag() != 0) {
-        result = result + String(1, constants::complex_marker) +
-                 uni::utf8to32u(kepler::helpers::double_to_string(num.imag(), precision));
+    if(num.imag() != 0) {
+        *out++ = static_cast<char>(constants::complex_marker);
+        out = format_double(out, num.imag(), precision);
     }
 
-    return uni::utf32to8(result);
-}
\ No newline at end of file
+    return out;
+}
+
+std::string kepler::helpers::double_to_string(const double& num, int precision) {
+    char buffer[number_buffer_size];
+    return {buffer, format_double(buffer, num, precision)};
+}
+
+std::string kepler::helpers::number_to_string(const kepler::Number& num, int precision) {
+    char buffer[number_buffer_size];
+    return {buffer, format_number(buffer, num, precision)};
+}
@@ -19,6 +19,7 @@
 
 #pragma once
 #include "core/token.h"
+#include "core/array.h"
 
 namespace kepler::helpers {
 
@@ -65,6 +66,21 @@ namespace kepler::helpers {
      */
     void check_valid_system_param_value(const String& id, const Number& value);
 
+    // The size of a buffer which can hold any Number written by format_number.
+    constexpr std::size_t number_buffer_size = 128;
+
+    /**
+     * Writes a Number into the given buffer, with the given precision.
+     *
+     * Numbers are written as in APL: negative numbers with '¯', exponents with 'E',
+     * and the imaginary part, if any, after a 'J'.
+     * @param out The buffer to write to, which must hold at least number_buffer_size bytes.
+     * @param num The Number to write.
+     * @param precision The number of significant digits to write.
+     * @return A pointer just past the last byte written.
+     */
+    char* format_number(char* out, const Number& num, int precision);
+
     /**
      * Converts a Number to a string, with the given precision.
      * @param num The Number to convert.
@@ -76,9 +92,9 @@ namespace kepler::helpers {
     /**
      * Converts a double to a string, with the given precision.
      *
-     * @param num
-     * @param precision
-     * @return
+     * @param num The double to convert.
+     * @param precision The number of significant digits to use.
+     * @return The string representation of the double.
      */
     std::string double_to_string(const double& num, int precision);
 };
\ No newline at end of file
@@ -0,0 +1,87 @@
+//
+// Copyright 2023 Nikolaj Banke Jensen.
+//
+// This file is part of Kepler.
+// 
+// Kepler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Kepler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License 
+// along with Kepler. If not, see <https://www.gnu.org/licenses/>.
+//
+#include "interner.h"
+#include <array>
+#include <atomic>
+#include <bit>
+#include <mutex>
+#include <unordered_map>
+
+namespace kepler {
+    namespace {
+        // The texts are kept in segments which double in size, so every id fits in one of them.
+        constexpr std::size_t first_segment_size = 64;
+        constexpr std::size_t segment_count = std::bit_width(std::size_t{no_id} / first_segment_size + 1);
+
+        struct InternTable {
+            // Guards the adding of texts. Looking up a text by its id does not lock,
+            // because a segment never moves once it is published.
+            std::mutex mutex;
+            InternId count = 0;
+
+            std::array<std::atomic<String*>, segment_count> segments{};
+            std::unordered_map<std::u32string_view, InternId> ids;
+
+            ~InternTable() {
+                for(auto& segment : segments) {
+                    delete[] segment.load(std::memory_order_relaxed);
+                }
+            }
+        };
+
+        InternTable& table() {
+            static InternTable instance;
+            return instance;
+        }
+
+        // The segment holding a given id, and the place of the id within it.
+        std::pair<std::size_t, std::size_t> locate(InternId id) {
+            std::size_t segment = std::bit_width(id / first_segment_size + 1) - 1;
+            std::size_t index = id - first_segment_size * ((std::size_t{1} << segment) - 1);
+            return {segment, index};
+        }
+    }
+
+    InternId intern(std::u32string_view text) {
+        auto& t = table();
+        std::lock_guard lock(t.mutex);
+
+        if(auto it = t.ids.find(text); it != t.ids.end()) {
+            return it->second;
+        }
+
+        InternId id = t.count;
+        auto [segment, index] = locate(id);
+        String* texts = t.segments[segment].load(std::memory_order_relaxed);
+        if(texts == nullptr) {
+            texts = new String[first_segment_size << segment];
+            t.segments[segment].store(texts, std::memory_order_release);
+        }
+
+        auto& stored = texts[index] = String(text);
+        t.ids.emplace(stored, id);
+        ++t.count;
+        return id;
+    }
+
+    const String& interned(InternId id) {
+        auto [segment, index] = locate(id);
+        return table().segments[segment].load(std::memory_order_acquire)[index];
+    }
+};
@@ -0,0 +1,53 @@
+//
+// Copyright 2023 Nikolaj Banke Jensen.
+//
+// This file is part of Kepler.
+// 
+// Kepler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Kepler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License 
+// along with Kepler. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include "datatypes.h"
+
+namespace kepler {
+    // Identifies a text in the intern table.
+    using InternId = std::uint32_t;
+
+    // The id of no text at all.
+    constexpr InternId no_id = std::numeric_limits<InternId>::max();
+
+    /**
+     * Returns the id of the given text in the intern table, adding the text if it is not there yet.
+     *
+     * Equal texts always have the same id, and the id of a text never changes.
+     * Looking up a text which is already interned does not allocate.
+     *
+     * @param text The text to intern.
+     * @return The id of the text.
+     */
+    InternId intern(std::u32string_view text);
+
+    /**
+     * Returns the text with the given id.
+     *
+     * The reference stays valid for the lifetime of the program.
+     *
+     * @param id The id of an interned text.
+     * @return The interned text.
+     */
+    const String& interned(InternId id);
+};
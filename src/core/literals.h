@@ -59,6 +59,11 @@ namespace kepler::constants {
             {U'⍟', LOG},
             {U'|', BAR},
             {U'⊂', LEFT_SHOE},
+            {U'∊', EPSILON},
+            {U'∪', DOWN_SHOE},
+            {U'∩', UP_SHOE},
+            {U'⍋', DELTA_STILE},
+            {U'⍒', DEL_STILE},
             {U'↑', ARROW_UP},
             {U'.', PRODUCT},
             {U'⍴', RHO},
@@ -93,9 +98,19 @@ namespace kepler::constants {
     const Number initial_index_origin = 1;
     const String print_precision_id = U"⎕PP";
     const Number initial_print_precision = 10;
+    const String print_width_id = U"⎕PW";
+    const Number initial_print_width = 1000;
+    const unsigned int max_print_rows = 1000;
+    const String save_workspace_id = U"⎕SAVE";
+    const String load_workspace_id = U"⎕LOAD";
+    const String read_binary_id = U"⎕NREAD";
+    const String write_binary_id = U"⎕NWRITE";
+    const String read_csv_id = U"⎕CSV";
+    const String profile_id = U"⎕PROFILE";
+    const String workspace_available_id = U"⎕WA";
     const String recursive_call_id = U"∇";
 
-    const String symbols = U"\n!()*+,-./:<=>?{|}~¨×÷←↑∘∧∨≠≤≥⊂⊖⊢⊣⋄⌈⌊⌽⍟⍣⍤⍥⍨⍱⍲⍳⍴⍵⍺◊○";
+    const String symbols = U"\n!()*+,-./:<=>?{|}~¨×÷←↑∊∘∧∨∩∪≠≤≥⊂⊖⊢⊣⋄⌈⌊⌽⍋⍒⍟⍣⍤⍥⍨⍱⍲⍳⍴⍵⍺◊○";
     const String identifier_chars = U"_abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789⎕∇";
     const String digit = U"0123456789";
 };
\ No newline at end of file
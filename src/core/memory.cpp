@@ -0,0 +1,411 @@
+//
+// Copyright 2023 Nikolaj Banke Jensen.
+//
+// This file is part of Kepler.
+// 
+// Kepler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Kepler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License 
+// along with Kepler. If not, see <https://www.gnu.org/licenses/>.
+//
+#include "memory.h"
+#include "error.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <vector>
+
+namespace kepler::memory {
+    // The allocations attributed to a function.
+    struct Producer {
+        std::atomic<std::size_t> allocations = 0;
+        std::atomic<std::size_t> bytes = 0;
+    };
+
+    namespace {
+        // Allocations are counted by size class: the number of bits needed for their size.
+        constexpr std::size_t size_classes = 65;
+
+        std::atomic<std::size_t> live = 0;
+        std::atomic<std::size_t> quota = 0;
+        std::atomic<std::size_t> peak = 0;
+        std::atomic<std::size_t> allocations = 0;
+        std::atomic<std::size_t> allocated = 0;
+        std::array<std::atomic<std::size_t>, size_classes> by_size{};
+
+        std::atomic<bool> attributing_allocations = false;
+        std::mutex producers_mutex;
+
+        // Producers are never removed, so the ones being attributed to stay valid.
+        std::map<std::string, Producer> producers;
+
+        // The function the allocations on this thread are attributed to, if any.
+        thread_local Producer* current = nullptr;
+
+        // The bytes this thread may still allocate under its budget.
+        constexpr std::size_t unbudgeted = std::numeric_limits<std::size_t>::max();
+        thread_local std::size_t budget = unbudgeted;
+
+        // The function which made the allocation that last raised the peak, if any.
+        std::atomic<Producer*> peak_producer = nullptr;
+
+        const std::string* name_of(const Producer* producer) {
+            for(auto& [name, entry] : producers) {
+                if(&entry == producer) {
+                    return &name;
+                }
+            }
+            return nullptr;
+        }
+
+        // Allocations of up to this many bytes, such as the buffers of scalars, are served from pools.
+        constexpr std::size_t pooled_size = 256;
+        constexpr std::size_t granularity = 16;
+        constexpr std::size_t pool_count = pooled_size / granularity;
+
+        // Pools are filled from slabs, which are kept until the process exits.
+        constexpr std::size_t slab_size = 64 * 1024;
+        std::atomic<std::size_t> slab_bytes = 0;
+
+        // A free block in a pool, linking to the next one.
+        struct Block {
+            Block* next;
+        };
+
+        // The pool serving allocations of the given size.
+        std::size_t pool_of(std::size_t bytes) {
+            return bytes == 0 ? 0 : (bytes - 1) / granularity;
+        }
+
+        // The number of blocks a thread frees into a pool before handing them to the shared pool, so
+        // blocks freed by one thread and allocated by another flow back to the allocating thread.
+        std::size_t handover_count(std::size_t pool) {
+            return slab_size / ((pool + 1) * granularity);
+        }
+
+        /**
+         * The pools of a thread: a list of free blocks per size, and the part of a slab not yet handed out.
+         *
+         * Blocks can be freed by another thread than the one allocating them, and go to the pools of the freeing thread,
+         * which hands them to the shared pools once it has freed a slab's worth of them or exits.
+         * This is trivially destructible, so blocks freed while other thread locals are destroyed can still be taken in.
+         */
+        struct Pools {
+            std::array<Block*, pool_count> free;
+            std::array<std::size_t, pool_count> freed;
+            char* slab;
+            char* slab_end;
+            bool exited;
+        };
+
+        thread_local Pools pools{};
+
+        // Blocks handed over by threads, as one list per size. Whole lists are pushed and taken at once,
+        // so the lists never suffer from blocks being taken and pushed again while they are read.
+        std::array<std::atomic<Block*>, pool_count> shared{};
+
+        void hand_over(std::size_t pool, Block* first) {
+            auto last = first;
+            while(last->next) {
+                last = last->next;
+            }
+            auto head = shared[pool].load(std::memory_order_relaxed);
+            do {
+                last->next = head;
+            } while(!shared[pool].compare_exchange_weak(head, first, std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        // The unused parts of the slabs of threads which have exited, taken by the next thread to run out of its slab.
+        struct Spare {
+            Spare* next;
+            char* end;
+        };
+
+        std::atomic_flag spares_lock;
+        Spare* spares = nullptr;
+
+        template<typename F>
+        void with_spares(F&& f) {
+            while(spares_lock.test_and_set(std::memory_order_acquire)) {
+                spares_lock.wait(true, std::memory_order_relaxed);
+            }
+            f();
+            spares_lock.clear(std::memory_order_release);
+            spares_lock.notify_one();
+        }
+
+        // Hands the pools of an exiting thread over to the shared pools, and the rest of its slab to the spares.
+        struct PoolsOwner {
+            ~PoolsOwner() {
+                pools.exited = true;
+                for(std::size_t pool = 0; pool < pool_count; ++pool) {
+                    if(auto first = pools.free[pool]) {
+                        hand_over(pool, first);
+                        pools.free[pool] = nullptr;
+                    }
+                }
+
+                // Only parts which can serve any pool are kept, so the first spare always fits.
+                if(static_cast<std::size_t>(pools.slab_end - pools.slab) >= pooled_size) {
+                    auto spare = new (pools.slab) Spare{nullptr, pools.slab_end};
+                    with_spares([spare] {
+                        spare->next = spares;
+                        spares = spare;
+                    });
+                }
+                pools.slab = pools.slab_end = nullptr;
+            }
+        };
+
+        thread_local PoolsOwner pools_owner;
+
+        void* take(std::size_t bytes) {
+            auto pool = pool_of(bytes);
+            auto size = (pool + 1) * granularity;
+            if(pools.exited) {
+                // An exiting thread keeps no pools, so it takes single blocks from the shared pool or the heap.
+                if(auto block = shared[pool].exchange(nullptr, std::memory_order_acquire)) {
+                    if(block->next) {
+                        hand_over(pool, block->next);
+                    }
+                    return block;
+                }
+                slab_bytes.fetch_add(size, std::memory_order_relaxed);
+                return ::operator new(size);
+            }
+
+            if(!pools.free[pool]) {
+                // Using the owner makes sure the pools of this thread are handed over when it exits.
+                (void) &pools_owner;
+                if(shared[pool].load(std::memory_order_relaxed)) {
+                    pools.free[pool] = shared[pool].exchange(nullptr, std::memory_order_acquire);
+                }
+            }
+
+            if(auto block = pools.free[pool]) {
+                pools.free[pool] = block->next;
+                return block;
+            }
+
+            if(static_cast<std::size_t>(pools.slab_end - pools.slab) < size) {
+                // The rest of the old slab is too small for this pool, and is left unused.
+                Spare* spare = nullptr;
+                with_spares([&] {
+                    if(spares) {
+                        spare = spares;
+                        spares = spare->next;
+                    }
+                });
+                if(spare) {
+                    pools.slab_end = spare->end;
+                    pools.slab = reinterpret_cast<char*>(spare);
+                } else {
+                    pools.slab = static_cast<char*>(::operator new(slab_size));
+                    pools.slab_end = pools.slab + slab_size;
+                    slab_bytes.fetch_add(slab_size, std::memory_order_relaxed);
+                }
+            }
+            auto block = pools.slab;
+            pools.slab += size;
+            return block;
+        }
+
+        void give(void* pointer, std::size_t bytes) {
+            auto pool = pool_of(bytes);
+            auto block = static_cast<Block*>(pointer);
+            block->next = nullptr;
+            if(pools.exited) {
+                hand_over(pool, block);
+                return;
+            }
+
+            if(!pools.free[pool]) {
+                // A thread which only frees blocks must hand them over when it exits, too.
+                (void) &pools_owner;
+            }
+            block->next = pools.free[pool];
+            pools.free[pool] = block;
+            if(++pools.freed[pool] >= handover_count(pool)) {
+                hand_over(pool, pools.free[pool]);
+                pools.free[pool] = nullptr;
+                pools.freed[pool] = 0;
+            }
+        }
+
+        // Formats a number of bytes with a binary unit.
+        std::string format_bytes(std::size_t bytes) {
+            const char* units[] = {"B", "KiB", "MiB", "GiB", "TiB"};
+            std::size_t unit = 0;
+            auto value = static_cast<double>(bytes);
+            while(value >= 1024 && unit + 1 < std::size(units)) {
+                value /= 1024;
+                ++unit;
+            }
+            std::ostringstream out;
+            out << std::fixed << std::setprecision(unit == 0 ? 0 : 1) << value << ' ' << units[unit];
+            return out.str();
+        }
+    }
+
+    Usage usage() {
+        return {live.load(), peak.load(), allocations.load(), allocated.load(), slab_bytes.load()};
+    }
+
+    void set_limit(std::size_t bytes) {
+        quota = bytes;
+    }
+
+    std::size_t limit() {
+        return quota.load();
+    }
+
+    void* allocate(std::size_t bytes) {
+        if(budget != unbudgeted) {
+            if(bytes > budget) {
+                throw kepler::Error(WSFullError, "Allocating " + format_bytes(bytes) + " would exceed the budget of this computation.");
+            }
+            budget -= bytes;
+        }
+
+        auto now = live.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        auto most = quota.load(std::memory_order_relaxed);
+        if(most != 0 && now > most) {
+            live.fetch_sub(bytes, std::memory_order_relaxed);
+            throw kepler::Error(WSFullError, "Allocating " + format_bytes(bytes) + " would exceed the workspace limit of " + format_bytes(most) + ".");
+        }
+
+        void* pointer;
+        try {
+            pointer = bytes <= pooled_size ? take(bytes) : ::operator new(bytes);
+        } catch (std::bad_alloc&) {
+            live.fetch_sub(bytes, std::memory_order_relaxed);
+            throw kepler::Error(WSFullError, "Could not allocate " + format_bytes(bytes) + ".");
+        }
+
+        auto highest = peak.load(std::memory_order_relaxed);
+        while(now > highest) {
+            if(peak.compare_exchange_weak(highest, now, std::memory_order_relaxed)) {
+                peak_producer.store(current, std::memory_order_relaxed);
+                break;
+            }
+        }
+
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        allocated.fetch_add(bytes, std::memory_order_relaxed);
+        by_size[std::bit_width(bytes)].fetch_add(1, std::memory_order_relaxed);
+        if(current) {
+            current->allocations.fetch_add(1, std::memory_order_relaxed);
+            current->bytes.fetch_add(bytes, std::memory_order_relaxed);
+        }
+        return pointer;
+    }
+
+    void deallocate(void* pointer, std::size_t bytes) noexcept {
+        live.fetch_sub(bytes, std::memory_order_relaxed);
+        if(bytes <= pooled_size) {
+            give(pointer, bytes);
+        } else {
+            ::operator delete(pointer);
+        }
+    }
+
+    void start() {
+        attributing_allocations = true;
+    }
+
+    void stop() {
+        attributing_allocations = false;
+    }
+
+    void clear() {
+        peak = live.load();
+        peak_producer = nullptr;
+        allocations = 0;
+        allocated = 0;
+        for(auto& count : by_size) {
+            count = 0;
+        }
+
+        std::lock_guard lock(producers_mutex);
+        for(auto& [name, producer] : producers) {
+            producer.allocations = 0;
+            producer.bytes = 0;
+        }
+    }
+
+    bool attributing() {
+        return attributing_allocations.load(std::memory_order_relaxed);
+    }
+
+    std::string report() {
+        std::ostringstream out;
+        auto counts = usage();
+        out << "live " << format_bytes(counts.live) << ", peak " << format_bytes(counts.peak);
+
+        std::lock_guard lock(producers_mutex);
+        if(auto name = name_of(peak_producer.load())) {
+            out << " (reached in " << *name << ")";
+        }
+        out << ", " << counts.allocations << " allocations of " << format_bytes(counts.allocated);
+        out << ", pools " << format_bytes(counts.pooled) << "\n";
+
+        out << std::setw(12) << "allocations" << "  size";
+        for(std::size_t i = 0; i < size_classes; ++i) {
+            if(auto count = by_size[i].load()) {
+                // Size class i holds the allocations of fewer than 2^i bytes.
+                out << "\n" << std::setw(12) << count << "  < " << format_bytes(std::size_t(1) << std::min<std::size_t>(i, 63));
+            }
+        }
+
+        std::vector<std::pair<std::string, const Producer*>> sorted;
+        for(auto& [name, producer] : producers) {
+            if(producer.allocations > 0) {
+                sorted.emplace_back(name, &producer);
+            }
+        }
+        std::stable_sort(sorted.begin(), sorted.end(), [](auto& a, auto& b) {
+            return a.second->bytes > b.second->bytes;
+        });
+        if(!sorted.empty()) {
+            out << "\n" << std::setw(12) << "allocations" << std::setw(14) << "bytes" << "  function";
+            for(auto& [name, producer] : sorted) {
+                out << "\n" << std::setw(12) << producer->allocations << std::setw(14) << producer->bytes << "  " << name;
+            }
+        }
+        return out.str();
+    }
+
+    Attribution::Attribution(const std::string& name) : previous(current) {
+        std::lock_guard lock(producers_mutex);
+        current = &producers[name];
+    }
+
+    Attribution::~Attribution() {
+        current = previous;
+    }
+
+    Budget::Budget(std::size_t bytes) : previous(budget), granted(std::min(bytes, budget)) {
+        budget = granted;
+    }
+
+    Budget::~Budget() {
+        // What was spent under this budget is spent from the enclosing one too.
+        auto spent = granted - budget;
+        budget = previous == unbudgeted ? unbudgeted : previous - spent;
+    }
+};
@@ -0,0 +1,184 @@
+//
+// Copyright 2023 Nikolaj Banke Jensen.
+//
+// This file is part of Kepler.
+// 
+// Kepler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Kepler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License 
+// along with Kepler. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include <cstddef>
+#include <string>
+
+namespace kepler::memory {
+
+    /**
+     * The memory held by the elements of Arrays.
+     */
+    struct Usage {
+        // The bytes currently allocated.
+        std::size_t live = 0;
+
+        // The most bytes allocated at once since the counters were last cleared.
+        std::size_t peak = 0;
+
+        // The number of allocations since the counters were last cleared.
+        std::size_t allocations = 0;
+
+        // The bytes allocated since the counters were last cleared, including those since freed.
+        std::size_t allocated = 0;
+
+        // The bytes of the slabs small allocations are served from, which are kept until the process exits.
+        std::size_t pooled = 0;
+    };
+
+    /**
+     * Returns the current usage of memory.
+     */
+    Usage usage();
+
+    /**
+     * Limits the bytes which can be allocated at once.
+     *
+     * @param bytes The most bytes which can be allocated, or 0 for no limit.
+     */
+    void set_limit(std::size_t bytes);
+
+    /**
+     * Returns the most bytes which can be allocated at once, or 0 if there is no limit.
+     */
+    std::size_t limit();
+
+    /**
+     * Allocates memory, and counts it.
+     *
+     * Small allocations are recycled through pools kept by each thread, so the many
+     * short-lived buffers of scalars rarely reach the general heap.
+     *
+     * @param bytes The number of bytes to allocate.
+     * @return The allocated memory, aligned for any type.
+     * @throws Error if the allocation would exceed the limit, or the memory could not be allocated.
+     */
+    void* allocate(std::size_t bytes);
+
+    /**
+     * Frees memory allocated by 'allocate'.
+     *
+     * @param pointer The memory to free.
+     * @param bytes The number of bytes it was allocated with.
+     */
+    void deallocate(void* pointer, std::size_t bytes) noexcept;
+
+    /**
+     * Starts attributing allocations to the functions making them.
+     */
+    void start();
+
+    /**
+     * Stops attributing allocations to functions.
+     */
+    void stop();
+
+    /**
+     * Resets the counters of allocations, and lowers the peak to the bytes currently allocated.
+     */
+    void clear();
+
+    /**
+     * Returns true if allocations are being attributed to the functions making them.
+     */
+    bool attributing();
+
+    /**
+     * Reports the usage of memory, the allocations by size, and the allocations by function.
+     *
+     * @return The report, as a table.
+     */
+    std::string report();
+
+    /**
+     * Allocator of the elements of Arrays, which counts the memory it holds.
+     *
+     * @tparam T The type of elements.
+     */
+    template<typename T>
+    struct Allocator {
+        using value_type = T;
+
+        Allocator() = default;
+
+        template<typename U>
+        Allocator(const Allocator<U>&) noexcept {}
+
+        T* allocate(std::size_t count) {
+            return static_cast<T*>(memory::allocate(count * sizeof(T)));
+        }
+
+        void deallocate(T* pointer, std::size_t count) noexcept {
+            memory::deallocate(pointer, count * sizeof(T));
+        }
+
+        template<typename U>
+        friend bool operator==(const Allocator&, const Allocator<U>&) noexcept {
+            return true;
+        }
+    };
+
+    struct Producer;
+
+    /**
+     * Attributes the allocations made on the calling thread to a function, from construction to destruction.
+     *
+     * Allocations are attributed to the innermost function being called only.
+     */
+    class Attribution {
+    private:
+        Producer* previous;
+
+    public:
+        /**
+         * Attributes allocations to the named function.
+         * @param name The name of the function, as it is written in the source.
+         */
+        explicit Attribution(const std::string& name);
+        ~Attribution();
+
+        Attribution(const Attribution&) = delete;
+        Attribution& operator=(const Attribution&) = delete;
+    };
+
+    /**
+     * Limits the bytes the calling thread can allocate, from construction to destruction.
+     *
+     * Unlike the limit, which bounds the bytes held at once, a budget counts every allocation,
+     * including those since freed, so it bounds the work done under it. An allocation which
+     * would exceed the budget fails with the same error as one exceeding the limit.
+     */
+    class Budget {
+    private:
+        std::size_t previous;
+        std::size_t granted;
+
+    public:
+        /**
+         * Limits the allocations of the calling thread to the given bytes.
+         * @param bytes The most bytes which can be allocated, in total.
+         */
+        explicit Budget(std::size_t bytes);
+        ~Budget();
+
+        Budget(const Budget&) = delete;
+        Budget& operator=(const Budget&) = delete;
+    };
+};
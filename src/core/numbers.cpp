@@ -0,0 +1,41 @@
+//
+// Copyright 2023 Nikolaj Banke Jensen.
+//
+// This file is part of Kepler.
+// 
+// Kepler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Kepler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License 
+// along with Kepler. If not, see <https://www.gnu.org/licenses/>.
+//
+#include "numbers.h"
+#include <utility>
+
+namespace kepler {
+    Numbers::Numbers(std::shared_ptr<const void> owner_, const double* data_, std::size_t count_, bool complex_)
+        : owner(std::move(owner_)), data(data_), count(count_), complex(complex_) {}
+
+    std::size_t Numbers::size() const {
+        return count;
+    }
+
+    Number Numbers::operator[](std::size_t i) const {
+        return complex ? Number(data[2 * i], data[2 * i + 1]) : Number(data[i]);
+    }
+
+    const double* Numbers::doubles() const {
+        return data;
+    }
+
+    bool Numbers::is_complex() const {
+        return complex;
+    }
+};
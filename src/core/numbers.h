@@ -0,0 +1,77 @@
+//
+// Copyright 2023 Nikolaj Banke Jensen.
+//
+// This file is part of Kepler.
+// 
+// Kepler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Kepler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License 
+// along with Kepler. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include <cstddef>
+#include <memory>
+#include "datatypes.h"
+
+namespace kepler {
+    /**
+     * Read-only buffer of numbers, held in memory owned by something else.
+     *
+     * The numbers are stored as doubles: one per number if they are real, and
+     * two per number (the real and imaginary parts) if they are complex.
+     * This is the layout of numbers in a saved workspace, so its numbers can be
+     * used directly from the mapped file, which the owner keeps alive.
+     */
+    class Numbers {
+    public:
+        Numbers() = default;
+
+        /**
+         * Creates a Numbers viewing the given doubles.
+         *
+         * @param owner Keeps the memory holding the doubles alive.
+         * @param data The doubles, which must be aligned for double.
+         * @param count The number of numbers.
+         * @param complex Whether every number takes up two doubles.
+         */
+        Numbers(std::shared_ptr<const void> owner, const double* data, std::size_t count, bool complex);
+
+        /**
+         * Returns the number of numbers.
+         */
+        [[nodiscard]] std::size_t size() const;
+
+        /**
+         * Returns the number at the given position.
+         *
+         * @param i The position of the number.
+         * @return The number.
+         */
+        Number operator[](std::size_t i) const;
+
+        /**
+         * Returns the doubles holding the numbers.
+         */
+        [[nodiscard]] const double* doubles() const;
+
+        /**
+         * Returns true if every number takes up two doubles.
+         */
+        [[nodiscard]] bool is_complex() const;
+
+    private:
+        std::shared_ptr<const void> owner;
+        const double* data = nullptr;
+        std::size_t count = 0;
+        bool complex = false;
+    };
+};
@@ -0,0 +1,264 @@
+//
+// Copyright 2023 Nikolaj Banke Jensen.
+//
+// This file is part of Kepler.
+// 
+// Kepler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Kepler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License 
+// along with Kepler. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <compare>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+#include "memory.h"
+#include "numbers.h"
+#include "text.h"
+
+namespace kepler {
+    /**
+     * Converts a character of a compactly stored Storage into an element.
+     *
+     * Must be specialised for every type of element which can be stored as Text.
+     *
+     * @tparam T The type of elements.
+     * @param c The character to convert.
+     * @return The element holding the character.
+     */
+    template<typename T>
+    T from_char(Char c);
+
+    /**
+     * Converts a number of a compactly stored Storage into an element.
+     *
+     * Must be specialised for every type of element which can be stored as Numbers.
+     *
+     * @tparam T The type of elements.
+     * @param number The number to convert.
+     * @return The element holding the number.
+     */
+    template<typename T>
+    T from_number(const Number& number);
+
+    /**
+     * Copy-on-write storage for the elements of an Array.
+     *
+     * Copying a Storage is cheap: the copy shares the underlying buffer with the
+     * original, so passing Arrays around (e.g. reading a variable) does not copy
+     * their elements. The buffer is only copied when a Storage sharing it is about
+     * to be modified, i.e. when a non-const member function is called on it.
+     *
+     * The interface mirrors the parts of std::vector used throughout Kepler, except that
+     * elements are only read through it. They are written through the vector returned by
+     * mutate(), which must not be written through after the Storage has been copied.
+     *
+     * Characters can be stored compactly as Text, and numbers as Numbers. Reading a character
+     * yields a boxed element shared by every Storage, so compactly stored characters are never
+     * converted to elements one by one. The elements of numbers are only created when they are
+     * first accessed, and the Storage is converted to a buffer of elements when it is modified.
+     *
+     * Buffers of elements are allocated by memory::Allocator, so the memory they hold is counted.
+     *
+     * @tparam T The type of elements.
+     */
+    template<typename T>
+    class Storage {
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using reference = T&;
+        using const_reference = const T&;
+        using buffer_type = std::vector<T, memory::Allocator<T>>;
+        using iterator = typename buffer_type::iterator;
+        using reverse_iterator = typename buffer_type::reverse_iterator;
+
+        /**
+         * Iterator over the elements of a Storage, reading compactly stored characters in place.
+         */
+        class const_iterator {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const T*;
+            using reference = const T&;
+
+            const_iterator() = default;
+
+            reference operator*() const;
+            pointer operator->() const { return &**this; }
+            reference operator[](difference_type n) const { return *(*this + n); }
+
+            const_iterator& operator++() { ++index; return *this; }
+            const_iterator operator++(int) { auto copy = *this; ++index; return copy; }
+            const_iterator& operator--() { --index; return *this; }
+            const_iterator operator--(int) { auto copy = *this; --index; return copy; }
+            const_iterator& operator+=(difference_type n) { index += n; return *this; }
+            const_iterator& operator-=(difference_type n) { index -= n; return *this; }
+
+            friend const_iterator operator+(const_iterator it, difference_type n) { return it += n; }
+            friend const_iterator operator+(difference_type n, const_iterator it) { return it += n; }
+            friend const_iterator operator-(const_iterator it, difference_type n) { return it -= n; }
+            friend difference_type operator-(const const_iterator& lhs, const const_iterator& rhs) { return lhs.index - rhs.index; }
+
+            friend bool operator==(const const_iterator& lhs, const const_iterator& rhs) { return lhs.index == rhs.index; }
+            friend std::strong_ordering operator<=>(const const_iterator& lhs, const const_iterator& rhs) { return lhs.index <=> rhs.index; }
+
+        private:
+            friend class Storage;
+            const_iterator(const Text* chars_, const T* elements_, difference_type index_) : chars(chars_), elements(elements_), index(index_) {}
+
+            // Exactly one of chars and elements is set, unless the Storage is empty.
+            const Text* chars = nullptr;
+            const T* elements = nullptr;
+            difference_type index = 0;
+        };
+
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        Storage() = default;
+        Storage(buffer_type elements);
+        Storage(std::initializer_list<T> elements);
+        Storage(size_type count, const T& value);
+
+        template<typename InputIt>
+        Storage(InputIt first, InputIt last);
+
+        /**
+         * Creates a Storage holding characters compactly.
+         *
+         * @param chars The characters to store.
+         */
+        explicit Storage(Text chars);
+
+        /**
+         * Creates a Storage holding numbers compactly.
+         *
+         * @param numbers The numbers to store.
+         */
+        explicit Storage(Numbers numbers);
+
+        /**
+         * Returns the characters of the Storage if they are stored compactly, otherwise nullptr.
+         */
+        [[nodiscard]] const Text* text() const;
+
+        /**
+         * Returns the numbers of the Storage if they are stored compactly, otherwise nullptr.
+         */
+        [[nodiscard]] const Numbers* numbers() const;
+
+        /**
+         * Returns the elements as a vector, without copying them.
+         *
+         * Compactly stored elements are converted to a vector on the first call,
+         * so prefer reading them through the accessors and iterators.
+         */
+        [[nodiscard]] const buffer_type& view() const;
+
+        /**
+         * Returns the elements as a modifiable vector.
+         *
+         * If the buffer is shared with other Storages, it is copied first,
+         * so modifications are never visible through other Storages.
+         */
+        buffer_type& mutate();
+
+        /**
+         * Returns a value identifying the buffer of this Storage.
+         *
+         * Storages which share a buffer have the same identity. The identity of an empty
+         * Storage is nullptr.
+         */
+        [[nodiscard]] const void* identity() const;
+
+        /**
+         * Returns a shared handle to the buffer, keeping it alive.
+         *
+         * As long as the handle exists, the buffer is shared, and thus never modified.
+         * The handle points to the identity of the Storage; compactly stored elements
+         * are not converted, so they must still be read through the Storage.
+         */
+        [[nodiscard]] std::shared_ptr<const buffer_type> share() const;
+
+        [[nodiscard]] size_type size() const { return compact ? compact->size() : view().size(); }
+        [[nodiscard]] bool empty() const { return size() == 0; }
+
+        const_reference operator[](size_type i) const;
+        const_reference at(size_type i) const;
+        const_reference front() const { return (*this)[0]; }
+        const_reference back() const { return (*this)[size() - 1]; }
+
+        const_iterator begin() const { return iterator_at(0); }
+        const_iterator end() const { return iterator_at(size()); }
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend() const { return end(); }
+        const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+        const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+        void reserve(size_type capacity) { mutate().reserve(capacity); }
+        void resize(size_type count) { mutate().resize(count); }
+        void clear();
+
+        void push_back(const T& value) { mutate().push_back(value); }
+        void push_back(T&& value) { mutate().push_back(std::move(value)); }
+
+        template<typename... Args>
+        reference emplace_back(Args&&... args) { return mutate().emplace_back(std::forward<Args>(args)...); }
+
+        template<typename... Args>
+        iterator insert(const_iterator pos, Args&&... args);
+
+        iterator erase(const_iterator pos);
+        iterator erase(const_iterator first, const_iterator last);
+
+        friend bool operator==(const Storage& lhs, const Storage& rhs) {
+            if(lhs.text() && rhs.text()) {
+                return lhs.compact == rhs.compact || lhs.compact->chars == rhs.compact->chars;
+            }
+            if(lhs.buffer == rhs.buffer && lhs.compact == rhs.compact) {
+                return true;
+            }
+            return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+        }
+
+    private:
+        [[nodiscard]] const_iterator iterator_at(size_type i) const;
+
+        // Characters or numbers stored compactly, and their elements once they have been viewed.
+        struct Compact {
+            Text chars;
+            std::optional<Numbers> numbers;
+            std::once_flag materialized;
+            buffer_type elements;
+
+            [[nodiscard]] size_type size() const { return numbers ? numbers->size() : chars.size(); }
+        };
+
+        std::shared_ptr<buffer_type> buffer;
+        std::shared_ptr<Compact> compact;
+    };
+};
+
+// Include of .tpp file goes at the bottom.
+#include "storage.tpp"
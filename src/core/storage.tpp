@@ -0,0 +1,214 @@
+//
+// Copyright 2023 Nikolaj Banke Jensen.
+//
+// This file is part of Kepler.
+// 
+// Kepler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Kepler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License 
+// along with Kepler. If not, see <https://www.gnu.org/licenses/>.
+//
+
+namespace kepler {
+    namespace detail {
+        // Allocates a shared object, counting its memory along with that of the elements.
+        template<typename U, typename... Args>
+        std::shared_ptr<U> make_counted(Args&&... args) {
+            return std::allocate_shared<U>(memory::Allocator<U>(), std::forward<Args>(args)...);
+        }
+
+        /**
+         * Returns the element of a character, shared by every compactly stored Storage.
+         *
+         * The elements are created a page of code points at a time and live for the rest
+         * of the program, so references to them never dangle.
+         */
+        template<typename T>
+        const T& boxed_char(Char c) {
+            constexpr std::size_t page_size = 256;
+            constexpr std::size_t page_count = 0x110000 / page_size;
+
+            static std::array<std::atomic<const std::vector<T>*>, page_count> pages{};
+            static std::unordered_map<Char, T> others;
+            static std::mutex mutex;
+
+            if(c >= page_size * page_count) {
+                // Beyond Unicode, which only arises from damaged input.
+                std::lock_guard lock(mutex);
+                return others.try_emplace(c, from_char<T>(c)).first->second;
+            }
+
+            auto& slot = pages[c / page_size];
+            auto page = slot.load(std::memory_order_acquire);
+            if(page == nullptr) {
+                std::lock_guard lock(mutex);
+                page = slot.load(std::memory_order_relaxed);
+                if(page == nullptr) {
+                    auto created = std::make_unique<std::vector<T>>();
+                    created->reserve(page_size);
+                    for(std::size_t i = 0; i < page_size; ++i) {
+                        created->push_back(from_char<T>(static_cast<Char>(c / page_size * page_size + i)));
+                    }
+                    page = created.release();
+                    slot.store(page, std::memory_order_release);
+                }
+            }
+            return (*page)[c % page_size];
+        }
+    }
+
+    template<typename T>
+    const T& Storage<T>::const_iterator::operator*() const {
+        return chars ? detail::boxed_char<T>((*chars)[index]) : elements[index];
+    }
+
+    template<typename T>
+    Storage<T>::Storage(buffer_type elements) : buffer(detail::make_counted<buffer_type>(std::move(elements))) {}
+
+    template<typename T>
+    Storage<T>::Storage(std::initializer_list<T> elements) : buffer(detail::make_counted<buffer_type>(elements)) {}
+
+    template<typename T>
+    Storage<T>::Storage(size_type count, const T& value) : buffer(detail::make_counted<buffer_type>(count, value)) {}
+
+    template<typename T>
+    template<typename InputIt>
+    Storage<T>::Storage(InputIt first, InputIt last) : buffer(detail::make_counted<buffer_type>(first, last)) {}
+
+    template<typename T>
+    Storage<T>::Storage(Text chars) : compact(detail::make_counted<Compact>()) {
+        compact->chars = std::move(chars);
+    }
+
+    template<typename T>
+    Storage<T>::Storage(Numbers numbers) : compact(detail::make_counted<Compact>()) {
+        compact->numbers = std::move(numbers);
+    }
+
+    template<typename T>
+    const Text* Storage<T>::text() const {
+        return compact && !compact->numbers ? &compact->chars : nullptr;
+    }
+
+    template<typename T>
+    const Numbers* Storage<T>::numbers() const {
+        return compact && compact->numbers ? &*compact->numbers : nullptr;
+    }
+
+    template<typename T>
+    const typename Storage<T>::buffer_type& Storage<T>::view() const {
+        static const buffer_type empty_buffer;
+        if(compact) {
+            // Concurrent readers may be the first to access the elements.
+            std::call_once(compact->materialized, [this]() {
+                compact->elements.reserve(compact->size());
+                if(compact->numbers) {
+                    for(std::size_t i = 0; i < compact->numbers->size(); ++i) {
+                        compact->elements.emplace_back(from_number<T>((*compact->numbers)[i]));
+                    }
+                } else {
+                    for(std::size_t i = 0; i < compact->chars.size(); ++i) {
+                        compact->elements.push_back(detail::boxed_char<T>(compact->chars[i]));
+                    }
+                }
+            });
+            return compact->elements;
+        }
+        return buffer ? *buffer : empty_buffer;
+    }
+
+    template<typename T>
+    typename Storage<T>::buffer_type& Storage<T>::mutate() {
+        if(compact) {
+            const auto& elements = view();
+            if(compact.use_count() == 1) {
+                buffer = detail::make_counted<buffer_type>(std::move(compact->elements));
+            } else {
+                buffer = detail::make_counted<buffer_type>(elements);
+            }
+            compact.reset();
+        } else if(!buffer) {
+            buffer = detail::make_counted<buffer_type>();
+        } else if(buffer.use_count() > 1) {
+            buffer = detail::make_counted<buffer_type>(*buffer);
+        }
+        return *buffer;
+    }
+
+    template<typename T>
+    const void* Storage<T>::identity() const {
+        return compact ? &compact->elements : buffer.get();
+    }
+
+    template<typename T>
+    std::shared_ptr<const typename Storage<T>::buffer_type> Storage<T>::share() const {
+        if(compact) {
+            return {compact, &compact->elements};
+        }
+        return buffer;
+    }
+
+    template<typename T>
+    typename Storage<T>::const_reference Storage<T>::operator[](size_type i) const {
+        if(auto chars = text()) {
+            return detail::boxed_char<T>((*chars)[i]);
+        }
+        return view()[i];
+    }
+
+    template<typename T>
+    typename Storage<T>::const_reference Storage<T>::at(size_type i) const {
+        if(i >= size()) {
+            throw std::out_of_range("Storage::at");
+        }
+        return (*this)[i];
+    }
+
+    template<typename T>
+    typename Storage<T>::const_iterator Storage<T>::iterator_at(size_type i) const {
+        auto index = static_cast<typename const_iterator::difference_type>(i);
+        if(auto chars = text()) {
+            return {chars, nullptr, index};
+        }
+        return {nullptr, view().data(), index};
+    }
+
+    template<typename T>
+    void Storage<T>::clear() {
+        // Releasing the buffer avoids copying a shared buffer only to clear it.
+        buffer.reset();
+        compact.reset();
+    }
+
+    template<typename T>
+    template<typename... Args>
+    typename Storage<T>::iterator Storage<T>::insert(const_iterator pos, Args&&... args) {
+        // pos may point into a shared buffer, which is replaced by mutate().
+        auto index = pos - begin();
+        auto& elements = mutate();
+        return elements.insert(elements.begin() + index, std::forward<Args>(args)...);
+    }
+
+    template<typename T>
+    typename Storage<T>::iterator Storage<T>::erase(const_iterator pos) {
+        auto index = pos - begin();
+        auto& elements = mutate();
+        return elements.erase(elements.begin() + index);
+    }
+
+    template<typename T>
+    typename Storage<T>::iterator Storage<T>::erase(const_iterator first, const_iterator last) {
+        auto from = first - begin();
+        auto to = last - begin();
+        auto& elements = mutate();
+        return elements.erase(elements.begin() + from, elements.begin() + to);
+    }
+};
@@ -20,8 +20,10 @@
 #pragma once
 #include <map>
 #include <optional>
+#include <vector>
 #include "core/array.h"
 #include "core/evaluation/ast.h"
+#include "core/token.h"
 
 namespace kepler {
 
@@ -43,6 +45,9 @@ namespace kepler {
         content_type content;
         SymbolType type;
 
+        // The tokens of the expression which defined a function, from which it can be defined again.
+        TokenRange definition;
+
         /**
          * Creates a new Symbol with the given type and content.
          * @param type_ The type of the symbol.
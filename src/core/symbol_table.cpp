@@ -43,6 +43,14 @@ namespace kepler {
         }
     }
 
+    void SymbolTable::assign(const String &id, Symbol* symbol) {
+        auto [it, inserted] = table.try_emplace(id, symbol);
+        if(!inserted) {
+            delete it->second;
+            it->second = symbol;
+        }
+    }
+
     void SymbolTable::attach_parent(SymbolTable *parent_) {
         parent = parent_;
     }
@@ -51,15 +59,17 @@ namespace kepler {
         if(!locally_only && parent != nullptr && parent->contains(id)) {
             parent->set(id, value);
         } else {
-            table.insert_or_assign(id, new Symbol(VariableSymbol, value));
+            assign(id, new Symbol(VariableSymbol, value));
         }
     }
 
-    void SymbolTable::set(const String &id, const Operation_ptr& value, bool locally_only) {
+    void SymbolTable::set(const String &id, const Operation_ptr& value, bool locally_only, const TokenRange& definition) {
         if(!locally_only && parent != nullptr && parent->contains(id)) {
-            parent->set(id, value);
+            parent->set(id, value, false, definition);
         } else {
-            table.insert_or_assign(id, new Symbol(FunctionSymbol, value));
+            auto symbol = new Symbol(FunctionSymbol, value);
+            symbol->definition = definition;
+            assign(id, symbol);
         }
     }
 
@@ -85,7 +95,7 @@ namespace kepler {
     }
 
     void SymbolTable::bind_function(const String &id) {
-        table.insert_or_assign(id, new Symbol(FunctionSymbol));
+        assign(id, new Symbol(FunctionSymbol));
     }
 
     void SymbolTable::clear() {
@@ -95,8 +105,24 @@ namespace kepler {
         table.clear();
     }
 
+    SymbolTable& SymbolTable::root() {
+        return parent == nullptr ? *this : parent->root();
+    }
+
+    const std::map<String, Symbol*>& SymbolTable::symbols() const {
+        return table;
+    }
+
     void SymbolTable::insert_system_parameters() {
         set(constants::index_origin_id, constants::initial_index_origin);
         set(constants::print_precision_id, constants::initial_print_precision);
+        set(constants::print_width_id, constants::initial_print_width);
+        bind_function(constants::save_workspace_id);
+        bind_function(constants::load_workspace_id);
+        bind_function(constants::read_binary_id);
+        bind_function(constants::write_binary_id);
+        bind_function(constants::read_csv_id);
+        bind_function(constants::profile_id);
+        bind_function(constants::workspace_available_id);
     }
 };
\ No newline at end of file
@@ -53,6 +53,15 @@ namespace kepler {
          */
         [[nodiscard]] const Symbol& lookup(const String& id) const;
 
+        /**
+         * Associates the given identifier with a Symbol in the current SymbolTable,
+         * deleting the Symbol it was associated with before, if any.
+         *
+         * @param id The identifier.
+         * @param symbol The Symbol, which the SymbolTable takes ownership of.
+         */
+        void assign(const String& id, Symbol* symbol);
+
     public:
         /**
          * Creates a new SymbolTable.
@@ -146,8 +155,9 @@ namespace kepler {
          * @param id The id to set the value for.
          * @param value The Operation_ptr to set as value.
          * @param locally_only Whether to set the value locally or not.
+         * @param definition The tokens of the expression which defined the function, if any.
          */
-        void set(const String& id, const Operation_ptr& value, bool locally_only = false);
+        void set(const String& id, const Operation_ptr& value, bool locally_only = false, const TokenRange& definition = {});
 
         /**
          * Sets the value associated with the given id.
@@ -194,8 +204,18 @@ namespace kepler {
         /**
          * Inserts the default system parameters into the SymbolTable.
          *
-         * These include '⎕IO' and '⎕PP'.
+         * These include '⎕IO', '⎕PP' and '⎕PW', and the system functions '⎕SAVE', '⎕LOAD', '⎕NREAD', '⎕NWRITE', '⎕CSV', '⎕PROFILE' and '⎕WA'.
          */
         void insert_system_parameters();
+
+        /**
+         * Returns the SymbolTable at the root of the chain of parents, which holds the global ids.
+         */
+        [[nodiscard]] SymbolTable& root();
+
+        /**
+         * Returns the Symbols defined in this SymbolTable, excluding those of its parent.
+         */
+        [[nodiscard]] const std::map<String, Symbol*>& symbols() const;
     };
 };
\ No newline at end of file
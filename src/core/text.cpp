@@ -0,0 +1,54 @@
+//
+// Copyright 2023 Nikolaj Banke Jensen.
+//
+// This file is part of Kepler.
+// 
+// Kepler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Kepler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License 
+// along with Kepler. If not, see <https://www.gnu.org/licenses/>.
+//
+#include "text.h"
+#include <algorithm>
+
+namespace kepler {
+    Text::Text(const String& chars_) {
+        Char largest = chars_.empty() ? 0 : *std::max_element(chars_.begin(), chars_.end());
+
+        if(largest <= 0xFF) {
+            chars = std::vector<std::uint8_t>(chars_.begin(), chars_.end());
+        } else if(largest <= 0xFFFF) {
+            chars = std::vector<char16_t>(chars_.begin(), chars_.end());
+        } else {
+            chars = std::vector<char32_t>(chars_.begin(), chars_.end());
+        }
+    }
+
+    std::size_t Text::size() const {
+        return std::visit([](auto& buffer) { return buffer.size(); }, chars);
+    }
+
+    bool Text::empty() const {
+        return size() == 0;
+    }
+
+    int Text::width() const {
+        return std::visit([](auto& buffer) { return static_cast<int>(sizeof(buffer[0])); }, chars);
+    }
+
+    Char Text::operator[](std::size_t i) const {
+        return std::visit([&](auto& buffer) { return static_cast<Char>(buffer[i]); }, chars);
+    }
+
+    String Text::to_string() const {
+        return std::visit([](auto& buffer) { return String(buffer.begin(), buffer.end()); }, chars);
+    }
+};
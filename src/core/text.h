@@ -0,0 +1,81 @@
+//
+// Copyright 2023 Nikolaj Banke Jensen.
+//
+// This file is part of Kepler.
+// 
+// Kepler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Kepler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License 
+// along with Kepler. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <variant>
+#include <vector>
+#include "datatypes.h"
+
+namespace kepler {
+    /**
+     * Compact buffer of characters.
+     *
+     * Characters are stored with the smallest width (8, 16 or 32 bits)
+     * which fits the largest code point, so text which is mostly ASCII
+     * takes a quarter of the space of a String.
+     */
+    class Text {
+    public:
+        Text() = default;
+
+        /**
+         * Creates a Text holding the given characters.
+         *
+         * @param chars The characters to store.
+         */
+        explicit Text(const String& chars);
+
+        /**
+         * Returns the number of characters in the Text.
+         */
+        [[nodiscard]] std::size_t size() const;
+
+        /**
+         * Returns true if the Text holds no characters.
+         */
+        [[nodiscard]] bool empty() const;
+
+        /**
+         * Returns the number of bytes used to store each character: 1, 2 or 4.
+         */
+        [[nodiscard]] int width() const;
+
+        /**
+         * Returns the character at the given position.
+         *
+         * @param i The position of the character.
+         * @return The character.
+         */
+        Char operator[](std::size_t i) const;
+
+        /**
+         * Returns the characters of the Text as a String.
+         */
+        [[nodiscard]] String to_string() const;
+
+        friend bool operator==(const Text& lhs, const Text& rhs) {
+            return lhs.size() == rhs.size() && lhs.to_string() == rhs.to_string();
+        }
+
+    private:
+        std::variant<std::vector<std::uint8_t>, std::vector<char16_t>, std::vector<char32_t>> chars;
+    };
+};
@@ -21,81 +21,170 @@
 
 #include "token_type.h"
 #include "datatypes.h"
+#include "interner.h"
 #include "uni_algo/conv.h"
-#include "array.h"
 #include "interface/conversion.h"
-#include <utility>
-#include <optional>
-#include "position.h"
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <type_traits>
+#include <vector>
 
 namespace kepler {
 
     /**
      * A Token represents a single lexical unit in the source code.
      *
-     * It contains the type of the token, and optionally the content of the token. It is also position-tagged.
+     * Tokens are small records which do not own any memory: they locate the
+     * lexical unit in the input, and refer to the content of identifiers and
+     * primitives by its interned id. The value of a number is parsed when the
+     * number is tokenized, and the content of a string is read from the input.
      */
-    struct Token : Position {
+    struct Token {
 
         TokenType type;
-        std::optional<std::vector<Char>> content;
+
+        // Position of the first character of the token in the input.
+        std::int32_t offset;
+
+        // Number of characters of the token in the input.
+        std::int32_t length;
+
+        // Interned content of the token, or no_id if it has no content or is read from the input.
+        InternId id;
+
+        // Value of a NUMBER token.
+        Number value;
+
+        Token() = default;
 
         /**
-         * Creates a Token with the given type, content, and position.
-         * @param pos The position of the token.
+         * Creates a Token with the given type, location and interned content.
          * @param type_ The type of the token.
-         * @param content_ The content of the token.
+         * @param offset_ The position of the first character of the token.
+         * @param length_ The number of characters of the token.
+         * @param id_ The interned content of the token.
+         * @param value_ The value of the token, if it is a number.
          */
-        Token(long pos, TokenType type_, Char content_) : Position(pos), type(type_), content(std::vector<Char>{content_}) {}
+        Token(TokenType type_, std::int32_t offset_, std::int32_t length_, InternId id_ = no_id, Number value_ = 0)
+            : type(type_), offset(offset_), length(length_), id(id_), value(value_) {}
 
         /**
-         * Creates a Token with the given type, content, and position.
-         * @param pos The position of the token.
+         * Creates a Token with the given type and content, which is not located in any input.
          * @param type_ The type of the token.
          * @param content_ The content of the token.
          */
-        Token(long pos, TokenType type_, String content_) : Position(pos), type(type_), content({content_.begin(), content_.end()}) {}
+        Token(TokenType type_, const String& content_) : type(type_), offset(0), length(0), id(type_ == NUMBER ? no_id : intern(content_)),
+                                                         value(type_ == NUMBER ? kepler::from_string(content_) : 0) {}
 
         /**
-         * Creates a Token with the given type and content.
-         * @param type_ The type of the token.
-         * @param content_ The content of the token.
+         * Returns the position just past the token, which is where errors are reported.
+         */
+        [[nodiscard]] long get_position() const {
+            return offset + length;
+        }
+
+        /**
+         * Returns the content of the token.
          */
-        Token(TokenType type_, String content_) : type(type_), content({content_.begin(), content_.end()}) {}
+        [[nodiscard]] const String& content() const {
+            static const String empty;
+            return id == no_id ? empty : interned(id);
+        }
 
         /**
-         * Creates a Token with no content.
-         * @param pos The position of the token.
-         * @param type_ The type of the token.
+         * Returns the content of the token, reading a string which is not interned from the input it was tokenized from.
+         * @param input The input the token was tokenized from, or nullptr if it is not known.
          */
-        Token(long pos, TokenType type_) : Position(pos), type(type_), content(std::nullopt) {}
+        [[nodiscard]] String content(const std::vector<Char>* input) const {
+            if(id != no_id || type != STRING || input == nullptr || offset < 0 || length < 2
+               || static_cast<std::size_t>(offset) + length > input->size()) {
+                return content();
+            }
+
+            // The content excludes the quotes.
+            return {input->begin() + offset + 1, input->begin() + offset + length - 1};
+        }
 
         /**
          * Checks if two tokens are equal.
          *
-         * Two tokens are equal if they have the same type and content.
+         * Two tokens are equal if they have the same type and content, or for numbers the same value.
          * @param lhs Left hand side Token.
          * @param rhs Right hand side Token.
          * @return True if the tokens are equal, false otherwise.
          */
         friend bool operator==(const Token& lhs, const Token& rhs) {
-            return lhs.type == rhs.type && lhs.content == rhs.content;
+            return lhs.type == rhs.type && lhs.id == rhs.id && (lhs.type != NUMBER || lhs.value == rhs.value);
         }
 
         /**
          * Returns the a string representation of the Token.
          */
         [[nodiscard]] std::string to_string() const {
+            auto format = [](double part) {
+                std::array<char, 32> buffer{};
+                auto end = std::to_chars(buffer.data(), buffer.data() + buffer.size(), part).ptr;
+                return std::string(buffer.data(), end);
+            };
+
             std::stringstream ss;
             ss << "Token(" << kepler::to_string(type);
 
-            if(content.has_value()) {
-                auto unwrapped = content.value();
-                auto str = String(unwrapped.begin(), unwrapped.end());
-                ss << ", " << uni::utf32to8(str);
+            if(id != no_id) {
+                ss << ", " << uni::utf32to8(content());
+            } else if(type == NUMBER) {
+                ss << ", " << format(value.real());
+                if(value.imag() != 0) {
+                    ss << "J" << format(value.imag());
+                }
             }
             ss << ")";
             return ss.str();
         }
     };
-};
\ No newline at end of file
+
+    static_assert(std::is_trivially_copyable_v<Token>);
+
+    /**
+     * A range of tokens in a list shared with other ranges, such as the tokens defining a function.
+     *
+     * Functions defined inside one another refer to the same list, so defining them does not copy any tokens.
+     */
+    class TokenRange {
+    private:
+        std::shared_ptr<const std::vector<Token>> tokens;
+        std::size_t first = 0;
+        std::size_t last = 0;
+
+    public:
+        TokenRange() = default;
+
+        /**
+         * Creates a range of the given tokens.
+         * @param tokens_ The list of tokens.
+         * @param first_ The index of the first token in the range.
+         * @param last_ The index past the last token in the range.
+         */
+        TokenRange(std::shared_ptr<const std::vector<Token>> tokens_, std::size_t first_, std::size_t last_)
+            : tokens(std::move(tokens_)), first(first_), last(last_) {}
+
+        [[nodiscard]] const Token* begin() const {
+            return tokens ? tokens->data() + first : nullptr;
+        }
+
+        [[nodiscard]] const Token* end() const {
+            return tokens ? tokens->data() + last : nullptr;
+        }
+
+        [[nodiscard]] std::size_t size() const {
+            return last - first;
+        }
+
+        [[nodiscard]] bool empty() const {
+            return first == last;
+        }
+    };
+};
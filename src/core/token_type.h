@@ -41,7 +41,11 @@ namespace kepler {
         CIRCLE_BAR,
         CIRCLE_STILE,
         COMMA,
+        DEL_STILE,
+        DELTA_STILE,
         DIVIDE,
+        DOWN_SHOE,
+        EPSILON,
         EQUAL,
         EXCLAMATION_MARK,
         FLOOR,
@@ -66,6 +70,7 @@ namespace kepler {
         RIGHT_TACK,
         STAR,
         TIMES,
+        UP_SHOE,
         WITHOUT,
 
         // Operators
@@ -21,6 +21,7 @@
 #include "array_printer.h"
 #include "core/helpers.h"
 #include <string>
+#include <string_view>
 #include <vector>
 #include <algorithm>
 
@@ -29,7 +30,40 @@
 #include <numeric>
 
 namespace kepler {
-    ArrayPrinter::ArrayPrinter(int precision_) : precision(precision_) {}
+    namespace {
+        // Returns true if the element is a boxed character.
+        bool is_char(const Array::element_type& element) {
+            return holds_alternative<Array>(element) && holds_alternative<Char>(get<Array>(element).data[0]);
+        }
+
+        // Appends the UTF-8 encoding of the character.
+        void append_utf8(std::string& out, Char c) {
+            if(c < 0x80) {
+                out += static_cast<char>(c);
+            } else if(c < 0x800) {
+                out += static_cast<char>(0xC0 | (c >> 6));
+                out += static_cast<char>(0x80 | (c & 0x3F));
+            } else if(c < 0x10000) {
+                out += static_cast<char>(0xE0 | (c >> 12));
+                out += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (c & 0x3F));
+            } else {
+                out += static_cast<char>(0xF0 | (c >> 18));
+                out += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+                out += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (c & 0x3F));
+            }
+        }
+
+        // Returns the number of characters in the UTF-8 text, which is the number of columns it takes up.
+        unsigned int display_width(std::string_view text) {
+            return std::count_if(text.begin(), text.end(), [](char c) {
+                return (static_cast<unsigned char>(c) & 0xC0) != 0x80;
+            });
+        }
+    }
+
+    ArrayPrinter::ArrayPrinter(int precision_, unsigned int width_, unsigned int rows_) : precision(precision_), width(width_), rows(rows_) {}
 
     bool ArrayPrinter::all_elements_are_scalars(const Array& arr) {
         return std::all_of(arr.data.begin(), arr.data.end(), [&](const Array::element_type& element){
@@ -48,284 +82,317 @@ namespace kepler {
         return result;
     }
 
-    std::vector<unsigned int> ArrayPrinter::offsets(const std::vector<unsigned int>& shape) {
-        std::vector<unsigned int> result;
-
-        for(int i = 2; i < shape.size() - 2; ++i) {
-            result.emplace_back(std::accumulate(shape.rbegin() + i, shape.rend(), 1, std::multiplies<>()));
+    ArrayPrinter::Block ArrayPrinter::text_block(const std::string& text) {
+        Block block;
+        String chars = uni::utf8to32u(text);
+        std::size_t start = 0;
+        while(true) {
+            auto end = chars.find(U'\n', start);
+            auto& line = block.lines.emplace_back(chars.substr(start, end - start));
+            block.width = std::max(block.width, static_cast<unsigned int>(line.size()));
+            if(end == String::npos) {
+                break;
+            }
+            start = end + 1;
         }
-
-        return result;
+        block.height = block.lines.size();
+        return block;
     }
 
-    std::vector<String> ArrayPrinter::split(const String& text, char32_t delim) {
-        std::vector<String> vec;
-
-        if(text.empty()) {
-            return vec;
+    ArrayPrinter::Block ArrayPrinter::measure(const Array& array) const {
+        if(array.empty() || array.is_simple_scalar() || (array.rank() == 1 && array.data.text()) || all_elements_are_scalars(array)) {
+            return text_block((*this)(array));
         }
 
-        int start = 0;
-        int cursor = start;
-
-        while(cursor <= text.size() - 1) {
-            if(text[cursor] == delim) {
-                vec.emplace_back(text.substr(start, cursor - start));
-                start = cursor + 1;
-            }
-            cursor++;
+        // Scalars and vectors are framed as matrices of one row.
+        Block block;
+        block.shape = array.shape;
+        if(array.rank() == 0) {
+            block.shape = {1, 1};
+        } else if(array.rank() == 1) {
+            block.shape.insert(block.shape.begin(), 1);
         }
-        if(start < cursor) {
-            vec.emplace_back(text.substr(start, cursor - start));
+
+        std::size_t columns = block.shape.back();
+        std::size_t rows = block.shape[block.shape.size() - 2];
+        block.widths.assign(columns, 0);
+        block.cells.reserve(array.data.size());
+
+        for(std::size_t i = 0; i < array.data.size(); ++i) {
+            auto& element = array.data[i];
+            Block cell = holds_alternative<Array>(element) ? measure(get<Array>(element)) : text_block(std::visit(*this, element));
+            block.widths[i % columns] = std::max(block.widths[i % columns], cell.width);
+            block.row_height = std::max(block.row_height, cell.height);
+            block.cells.emplace_back(std::move(cell));
         }
 
-        return vec;
+        // Every matrix has a border around and between its cells.
+        std::size_t matrices = array.data.size() / (rows * columns);
+        block.width = std::accumulate(block.widths.begin(), block.widths.end(), 0U) + columns + 1;
+        block.height = matrices * (rows * (block.row_height + 1) + 1);
+        for(std::size_t matrix = 1; matrix < matrices; ++matrix) {
+            block.height += blank_lines(block.shape, matrix);
+        }
+        return block;
     }
 
-
-    unsigned int ArrayPrinter::max_length_contiguous_segment(const String& str) {
-        std::vector<String> segments = split(str, U'\n');
-        unsigned int max_length = 0;
-        for(auto& element : segments) {
-            if(element.length() > max_length) {
-                max_length = element.length();
+    unsigned int ArrayPrinter::blank_lines(const std::vector<unsigned int>& shape, std::size_t matrix) {
+        // One blank line for every axis which a new item starts along, as in displays of simple arrays.
+        unsigned int count = 0;
+        std::size_t matrices = 1;
+        for(std::size_t axis = shape.size() - 2; axis > 0; --axis) {
+            if(matrix % matrices == 0) {
+                ++count;
             }
+            matrices *= shape[axis - 1];
         }
-        return max_length;
+        return count;
     }
 
+    void ArrayPrinter::draw(const Block& block, std::vector<String>& grid, std::size_t line, std::size_t column) {
+        if(block.shape.empty()) {
+            for(std::size_t i = 0; i < block.lines.size(); ++i) {
+                std::copy(block.lines[i].begin(), block.lines[i].end(), grid[line + i].begin() + static_cast<long>(column));
+            }
+            return;
+        }
 
-    String ArrayPrinter::concatenate_block(const String& left, const String& right) {
-        std::vector<String> l_segments = split(left, U'\n');
-        std::vector<String> r_segments = split(right, U'\n');
-
-        String result;
+        std::size_t columns = block.widths.size();
+        std::size_t rows = block.shape[block.shape.size() - 2];
+        std::size_t matrices = block.cells.size() / (rows * columns);
 
-        if(l_segments.empty()) {
-            return result;
-        }
+        for(std::size_t matrix = 0; matrix < matrices; ++matrix) {
+            if(matrix != 0) {
+                line += blank_lines(block.shape, matrix);
+            }
 
-        for(int i = 0; i < l_segments.size(); ++i) {
-            result += l_segments[i] + r_segments[i];
-            result += U'\n';
-        }
-        result.pop_back();
+            for(std::size_t row = 0; row <= rows; ++row) {
+                // The border above every row, and below the last.
+                Char left = row == 0 ? U'┌' : row == rows ? U'└' : U'├';
+                Char middle = row == 0 ? U'┬' : row == rows ? U'┴' : U'┼';
+                Char right = row == 0 ? U'┐' : row == rows ? U'┘' : U'┤';
+
+                auto border = grid[line].begin() + static_cast<long>(column);
+                *border++ = left;
+                for(std::size_t c = 0; c < columns; ++c) {
+                    border = std::fill_n(border, block.widths[c], U'─');
+                    *border++ = c + 1 == columns ? right : middle;
+                }
+                ++line;
 
-        return result;
-    }
+                if(row == rows) {
+                    break;
+                }
 
-    String ArrayPrinter::prepend_block(const String& str, char32_t val) {
-        std::vector<String> delimited = split(str, U'\n');
-        String result;
-        for(auto& substr : delimited) {
-            result += val + substr + U'\n';
+                std::size_t x = column;
+                for(std::size_t c = 0; c <= columns; ++c) {
+                    for(std::size_t i = 0; i < block.row_height; ++i) {
+                        grid[line + i][x] = U'│';
+                    }
+                    if(c < columns) {
+                        draw(block.cells[(matrix * rows + row) * columns + c], grid, line, x + 1);
+                        x += block.widths[c] + 1;
+                    }
+                }
+                line += block.row_height;
+            }
         }
-        result.pop_back();
-        return result;
     }
 
-    String ArrayPrinter::append_block(const String& str, char32_t val) {
-        std::vector<String> delimited = split(str, U'\n');
-        String result;
-        for(auto& substr : delimited) {
-            result += substr + val + U'\n';
-        }
-        result.pop_back();
+    std::string ArrayPrinter::operator()(const Char& element) const {
+        std::string result;
+        append_utf8(result, element);
         return result;
     }
 
-
-    String ArrayPrinter::box_string(const String& str, unsigned int width, unsigned int height) {
-        std::vector<String> lines = split(str, U'\n');
-        for(auto& line : lines) {
-            line += String(width - line.size(), U' ');
-        }
-        for(unsigned int i = lines.size(); i < height; ++i) {
-            lines.emplace_back(width, U' ');
-        }
-
-        String result;
-        for(auto& line : lines) {
-            result += line + U'\n';
-        }
-        result.pop_back();
-        return result;
+    std::string ArrayPrinter::operator()(const Number& element) const {
+        return kepler::helpers::number_to_string(element, precision);
     }
 
-
-    String ArrayPrinter::join_block(char32_t separator, const std::vector<String>& blocks) {
-        if(blocks.empty()) {
-            return U"";
+    std::string ArrayPrinter::operator()(const Array& array) const {
+        if(array.empty()) {
+            return "";
         }
 
-        String result = blocks[0];
-        for(int i = 1; i < blocks.size(); ++i) {
-            result = concatenate_block(append_block(result, separator), blocks[i]);
+        if(array.is_simple_scalar()) {
+            return std::visit(*this, array.data[0]);
         }
-        return result;
-    }
 
-    String ArrayPrinter::frame_matrix(const std::vector<String>& strings, const std::vector<unsigned int>& widths, unsigned int height) {
-        unsigned int num_cols = widths.size();
-        unsigned int num_rows = strings.size() / num_cols;
-
-        std::vector<String> boxes(strings.size());
-        for(int i = 0; i < strings.size(); ++i) {
-            boxes.at(i) = box_string(strings[i], widths[i % num_cols], height);
+        if(array.rank() == 1 && array.data.text()) {
+            // Character vectors are printed without creating their elements.
+            return uni::utf32to8(array.data.text()->to_string());
         }
 
-        std::vector<String> rows;
-        for(unsigned int i = 0; i < num_rows; ++i) {
-            String row = join_block(U'│', {boxes.begin() + i * widths.size(), boxes.begin() + (i + 1) * widths.size()});
-            row = prepend_block(row, U'│');
-            row = append_block(row, U'│');
-            rows.emplace_back(std::move(row));
-        }
+        if(all_elements_are_scalars(array)) {
+            // No arrays inside each other, so every element is written once into a single buffer,
+            // while measuring the width of each column.
+            std::size_t count = array.data.size();
+            std::size_t columns = array.rank() > 1 ? array.shape.back() : count;
+            std::string text;
+            text.reserve(count * 4);
+            std::vector<std::size_t> ends(count);
+            std::vector<unsigned int> element_widths(count);
+            std::vector<unsigned int> widths(columns, 0);
+
+            char buffer[helpers::number_buffer_size];
+            for(std::size_t i = 0; i < count; ++i) {
+                auto& scalar = get<Array>(array.data[i]).data[0];
+                auto begin = text.size();
+                if(auto number = get_if<Number>(&scalar)) {
+                    text.append(buffer, helpers::format_number(buffer, *number, precision));
+                } else {
+                    append_utf8(text, get<Char>(scalar));
+                }
+                ends[i] = text.size();
+                element_widths[i] = display_width({text.data() + begin, text.size() - begin});
+                widths[i % columns] = std::max(widths[i % columns], element_widths[i]);
+            }
 
-        String ref_line = split(rows[0], U'\n')[0];
-        String top = U"┌";
-        for(int i = 1; i < ref_line.size() - 1; ++i) {
-            if(ref_line[i] == U'│') {
-                top += U'┬';
-            } else {
-                top += U'─';
+            std::vector<unsigned int> cumulative_dims = dims(array.shape);
+            std::string result;
+            result.reserve(text.size() + count * (array.rank() > 1 ? 1 + *std::max_element(widths.begin(), widths.end()) : 1));
+            std::size_t begin = 0;
+            for(std::size_t i = 0; i < count; ++i) {
+                for(auto& d : cumulative_dims) {
+                    if(i != 0 && i % d == 0) {
+                        result += '\n';
+                    }
+                }
+                // Adjacent characters are not separated.
+                if(i != 0 && result.back() != '\n' && !(is_char(array.data[i - 1]) && is_char(array.data[i]))) {
+                    result += ' ';
+                }
+                // Every element in a column is padded to the same width.
+                if(array.rank() > 1) {
+                    result.append(widths[i % columns] - element_widths[i], ' ');
+                }
+                result.append(text, begin, ends[i] - begin);
+                begin = ends[i];
             }
+            return result;
         }
-        top += U'┐';
-        String intermediate = U'├' + top.substr(1, top.size() - 2) + U'┤';
-        std::replace(intermediate.begin(), intermediate.end(), U'┬', U'┼');
-        String bot = U'└' + top.substr(1, top.size() - 2) + U'┘';
-        std::replace(bot.begin(), bot.end(), U'┬', U'┴');
-
-        std::vector<String> lines{top};
-        for(auto& row : rows) {
-            std::vector<String> delimited = split(row, U'\n');
-            std::copy(delimited.begin(), delimited.end(), std::back_inserter(lines));
-            lines.emplace_back(intermediate);
-        }
-        lines.back() = bot;
+
+        // Arrays inside each other are measured as a whole, and then drawn onto a grid in one pass.
+        Block block = measure(array);
+        std::vector<String> grid(block.height, String(block.width, U' '));
+        draw(block, grid, 0, 0);
 
         String result;
-        for(auto& str : lines) {
-            result += str + U'\n';
+        for(auto& line : grid) {
+            // Blank lines between matrices are left empty.
+            auto end = line.find_last_not_of(U' ');
+            result.append(line, 0, end == String::npos ? 0 : end + 1);
+            result += U'\n';
         }
         result.pop_back();
-
-        return result;
+        return uni::utf32to8(result);
     }
 
-    std::string ArrayPrinter::operator()(const String &element) const {
-        auto result = element;
-
-        // The following is inspired by an answer on StackOverflow by
-        // user "rotmax" at https://stackoverflow.com/a/15372760/15372019
-        size_t index = 0;
-        while(true) {
-            index = result.find(U"\\n", index);
-            if(index == std::string::npos) break;
-            result.replace(index, 2, U"\n");
-            index += 2;
+    Array ArrayPrinter::visible_part(const Array& array, bool& elided) const {
+        elided = false;
+        if(array.rank() == 0) {
+            return array;
         }
 
-        return uni::utf32to8(result);
-    }
+        // Every element takes up at least one character, so one more element than the width fills a line.
+        std::vector<unsigned int> shape = array.shape;
+        shape.back() = std::min(shape.back(), width == std::numeric_limits<unsigned int>::max() ? width : width + 1);
 
-    std::string ArrayPrinter::operator()(const Number& element) const {
-        return kepler::helpers::number_to_string(element, precision);
-    }
+        // Cut the leading axes, starting from the first, until the rows fit.
+        for(std::size_t axis = 0; axis + 1 < shape.size(); ++axis) {
+            std::size_t below = std::accumulate(array.shape.begin() + static_cast<long>(axis) + 1, array.shape.end() - 1, std::size_t{1}, std::multiplies<>());
+            if(shape[axis] * below <= rows) {
+                break;
+            }
 
-    std::string ArrayPrinter::operator()(const Array& array) const {
-        if(array.empty()) {
-            return "";
+            elided = true;
+            if(below <= rows) {
+                shape[axis] = rows / below;
+                break;
+            }
+            shape[axis] = 1;
         }
 
-        if(array.is_simple_scalar()) {
-            return std::visit(*this, array.data[0]);
+        if(shape == array.shape) {
+            return array;
         }
 
-        if(all_elements_are_scalars(array)) {
-            // No arrays inside each other, so just make strings of everything.
-            std::vector<std::string> strings(array.data.size());
-            for(int i = 0; i < array.data.size(); ++i) {
-                strings.at(i) = std::visit(*this, array.data[i]);
+        if(array.rank() == 1 && array.data.text()) {
+            String chars(shape[0], U' ');
+            for(std::size_t i = 0; i < chars.size(); ++i) {
+                chars[i] = (*array.data.text())[i];
             }
+            return Array(Text(chars));
+        }
 
-            if(array.rank() > 1) {
+        std::vector<std::size_t> strides(shape.size(), 1);
+        for(std::size_t axis = shape.size() - 1; axis > 0; --axis) {
+            strides[axis - 1] = strides[axis] * array.shape[axis];
+        }
 
-                // Compute max widths for each column.
-                std::vector<int> widths(array.shape.back(), 0);
-                for(int i = 0; i < strings.size(); ++i) {
-                    int index = i % array.shape.back();
-                    widths[index] = std::max(widths[index], (int)strings[i].size());
-                }
+        std::size_t count = std::accumulate(shape.begin(), shape.end(), std::size_t{1}, std::multiplies<>());
+        Array::buffer_type elements;
+        elements.reserve(count);
 
-                // Pad every element such that every element in a colum
-                // has the same size.
-                for(int i = 0; i < strings.size(); ++i) {
-                    int index = i % array.shape.back();
-                    strings[i].insert(0, std::string(widths[index] - strings[i].size(), ' '));
-                }
+        // Step through the indices of the visible elements, as an odometer.
+        std::vector<unsigned int> index(shape.size(), 0);
+        for(std::size_t i = 0; i < count; ++i) {
+            std::size_t offset = 0;
+            for(std::size_t axis = 0; axis < shape.size(); ++axis) {
+                offset += index[axis] * strides[axis];
+            }
+            if(auto text = array.data.text()) {
+                elements.emplace_back(Array{(*text)[offset]});
+            } else {
+                elements.emplace_back(array.data[offset]);
             }
 
-            std::vector<unsigned int> cumulative_dims = dims(array.shape);
-            std::string result;// = " ";
-            for(int i = 0; i < strings.size(); ++i) {
-                for(auto& d : cumulative_dims) {
-                    if(i != 0 && i % d == 0) {
-                        result += "\n";
-                    }
+            for(std::size_t axis = shape.size(); axis-- > 0;) {
+                if(++index[axis] < shape[axis]) {
+                    break;
                 }
-                if(i != 0 && result.back() != '\n') {
-                    result += " ";
-                }
-                result += strings[i];
+                index[axis] = 0;
             }
-            return result;
         }
 
-        if(array.rank() == 0) {
-            return (*this)(Array{{1, 1}, array.data});
-        } else if(array.rank() == 1) {
-            std::vector<unsigned int> shape = {1};
-            shape.reserve(array.shape.size() + 1);
-            std::copy(array.shape.begin(), array.shape.end(), std::back_inserter(shape));
-            return (*this)(Array{shape, array.data});
-        } else {
-            std::vector<String> strings;
-            int last_dim = array.shape.back();
-            std::vector<unsigned int> widths(last_dim, 0);
-            unsigned int max_height = 0;
-
-            for(int i = 0; i < array.data.size(); ++i) {
-                String str = uni::utf8to32u(std::visit(*this, array.data[i]));
-                unsigned int s_height = 1 + std::count(str.begin(), str.end(), '\n');
-                max_height = std::max(max_height, s_height);
-
-                unsigned int s_width = max_length_contiguous_segment(str);
-                widths[i%last_dim] = std::max(widths[i%last_dim], s_width);
-                strings.emplace_back(str);
-            }
+        return {shape, std::move(elements)};
+    }
+
+    void ArrayPrinter::write_line(std::string_view line, std::ostream& out) const {
+        if(display_width(line) <= width) {
+            out << line;
+            return;
+        }
 
-            int matrix_size = array.shape[array.shape.size() - 2] * array.shape[array.shape.size() - 1];
-            int n_matrices = std::accumulate(array.shape.rbegin(), array.shape.rend(), 1, std::multiplies<>()) / matrix_size;
-            std::vector<String> matrices;
-            for(int i = 0; i < n_matrices; ++i) {
-                matrices.emplace_back(frame_matrix({strings.begin() + i * matrix_size, strings.begin() + (i + 1) * matrix_size}, widths, max_height));
+        // Keep the characters before the last column, which is taken by the ellipsis.
+        std::size_t characters = 0;
+        std::size_t end = 0;
+        while(end < line.size()) {
+            if((static_cast<unsigned char>(line[end]) & 0xC0) != 0x80 && characters++ == width - 1) {
+                break;
             }
+            ++end;
+        }
+        out << line.substr(0, end) << "…";
+    }
 
-            std::vector<unsigned int> off = offsets(array.shape);
-            String result;
-            for(int i = 0; i < matrices.size(); ++i) {
-                for(auto& o : off) {
-                    if(i != 0 && i % o == 0) {
-                        result += U'\n';
-                    }
-                }
-                result += matrices[i] + U' ';
+    void ArrayPrinter::print(const Array& array, std::ostream& out) const {
+        bool elided = false;
+        std::string text = (*this)(visible_part(array, elided));
+
+        std::string_view lines = text;
+        while(true) {
+            auto end = lines.find('\n');
+            write_line(lines.substr(0, end), out);
+            if(end == std::string_view::npos) {
+                break;
             }
+            out << '\n';
+            lines.remove_prefix(end + 1);
+        }
 
-            result.pop_back();
-            return uni::utf32to8(result);
+        if(elided) {
+            out << "\n…";
         }
     }
 };
\ No newline at end of file
@@ -18,7 +18,10 @@
 //
 
 #pragma once
+#include <limits>
+#include <ostream>
 #include <string>
+#include <string_view>
 #include "core/datatypes.h"
 
 namespace kepler {
@@ -38,16 +41,25 @@ namespace kepler {
         // The number of decimal places to use when printing numbers.
         int precision;
 
+        // The maximum number of characters on a line printed by print().
+        unsigned int width;
+
+        // The maximum number of rows printed by print().
+        unsigned int rows;
+
         /**
          * Creates a new ArrayPrinter.
          * @param precision The number of decimal places to use when printing numbers.
+         * @param width The maximum number of characters on a line printed by print().
+         * @param rows The maximum number of rows printed by print().
          */
-        explicit ArrayPrinter(int precision);
+        explicit ArrayPrinter(int precision, unsigned int width = std::numeric_limits<unsigned int>::max(),
+                              unsigned int rows = std::numeric_limits<unsigned int>::max());
 
         /**
-         * Converts a String (std::u32string) to a std::string.
+         * Converts a Char (char32_t) to a std::string.
          */
-        std::string operator()(const String& element) const;
+        std::string operator()(const Char& element) const;
 
         /**
          * Converts a Number (std::complex<double>) to a std::string.
@@ -59,8 +71,39 @@ namespace kepler {
          */
         std::string operator()(const Array& array) const;
 
+        /**
+         * Writes an Array to the given stream, one line at a time.
+         *
+         * Only the part of the Array which fits within the width and rows of the printer
+         * is formatted. Lines which are too wide are cut short with '…', and a final
+         * line of '…' marks rows which are left out.
+         *
+         * @param array The Array to write.
+         * @param out The stream to write to.
+         */
+        void print(const Array& array, std::ostream& out) const;
+
     private:
 
+        /**
+         * Returns the part of the Array which can be shown within the width and rows of the printer.
+         *
+         * The last axis is cut to the width, as every element takes up at least one character,
+         * and the leading axes are cut to the rows.
+         *
+         * @param array The Array to cut.
+         * @param elided Set to true if any rows of the Array are left out.
+         * @return The visible part of the Array.
+         */
+        [[nodiscard]] Array visible_part(const Array& array, bool& elided) const;
+
+        /**
+         * Writes a line to the stream, cutting it short with '…' if it is wider than the printer.
+         * @param line The UTF-8 line to write.
+         * @param out The stream to write to.
+         */
+        void write_line(std::string_view line, std::ostream& out) const;
+
         /**
          * Returns true if all elements in the Array are Arrays themselves which are scalar.
          */
@@ -79,99 +122,67 @@ namespace kepler {
         static std::vector<unsigned int> dims(const std::vector<unsigned int>& shape);
 
         /**
-         * Returns the a list of offsets of each dimension of the shape, reversed.
+         * The layout of an element of a nested display.
          *
-         * Start at the two before end of the shape input. For each element, multiply all
-         * elements to the right of it and insert the result in the result vector.
-         *
-         * For example, if the shape is [3, 5, 9, 10, 6], the result will be [1, 1, 9].
-         * @param shape The shape vector of the Array.
-         * @return The accumulated dimensions.
-        */
-        static std::vector<unsigned int> offsets(const std::vector<unsigned int>& shape);
-
-        /**
-         * Splits a String into a vector of Strings by a delimiter.
-         * @param text Original string.
-         * @param delim Delimiter to split by.
-         * @return A vector of delimited strings.
+         * Blocks are measured before anything is drawn, so that every character
+         * of the display is written exactly once.
          */
-        static std::vector<String> split(const String& text, char32_t delim);
+        struct Block {
+            // The number of characters on each line of the Block.
+            unsigned int width = 0;
 
-        /**
-         * Returns the maximum length of a contiguous segment of a String.
-         *
-         * A contiguous segment is a sequence of characters that are not a newline.
-         * @param str String to find the maximum length of a contiguous segment in.
-         * @return The maximum length of a contiguous segment.
-         */
-        static unsigned int max_length_contiguous_segment(const String& str);
+            // The number of lines of the Block.
+            unsigned int height = 0;
 
-        /**
-         * Concatenates two Strings by appending contiguous segments of one String to the other.
-         *
-         * Specifically, the Strings are split by newlines, and the contiguous segments are
-         * zipped between the splits. The result is a String where each contiguous segment
-         * is the concatenation of the corresponding contiguous segments of the two input Strings.
-         *
-         * @param left One of two Strings to concatenate.
-         * @param right Second of two Strings to concatenate.
-         * @return The concatenated String.
-         */
-        static String concatenate_block(const String& left, const String& right);
+            // The lines of a Block of text, which is empty for a frame.
+            std::vector<String> lines;
 
-        /**
-         * Splits the given string by newlines, prepends the given value to each segment,
-         * and concatenates all segments.
-         *
-         * @param str The String to modify.
-         * @param val The value to prepend to each segment.
-         * @return The resulting String.
-         */
-        static String prepend_block(const String& str, char32_t val);
+            // The shape of a frame, which is at least a matrix.
+            std::vector<unsigned int> shape;
+
+            // The Blocks in the cells of a frame, in row-major order.
+            std::vector<Block> cells;
+
+            // The width of each column of a frame.
+            std::vector<unsigned int> widths;
+
+            // The height of every row of a frame.
+            unsigned int row_height = 0;
+        };
 
         /**
-         * Splits the given string by newlines, appends the given value to each segment,
-         * and concatenates all segments.
+         * Measures the Block of an Array, without drawing it.
          *
-         * @param str The String to modify.
-         * @param val The value to append to each segment.
-         * @return The resulting String.
+         * Arrays of simple scalars are formatted as text, and other Arrays
+         * become frames of the Blocks of their elements.
+         *
+         * @param array The Array to measure.
+         * @return The Block of the Array.
          */
-        static String append_block(const String& str, char32_t val);
+        [[nodiscard]] Block measure(const Array& array) const;
 
         /**
-         * Splits the given String by newlines, ensures that each segment is at least the
-         * width given, and that there is at least height amount of segments.
-         *
-         * If a line is not width characters long, it is padded with spaces.
-         * If there are not enough lines, empty lines are added.
-         *
-         * @param str The String containing the lines to box.
-         * @param width The desired width.
-         * @param height The desired height.
-         * @return The box-formatted String
+         * Returns a Block of the given text.
+         * @param text The UTF-8 text, with lines separated by newlines.
+         * @return The Block of the text.
          */
-        static String box_string(const String& str, unsigned int width, unsigned int height);
+        static Block text_block(const std::string& text);
 
         /**
-         * Joins several blocks into one String by concatenating them
-         * (side-by-side) and inserting a separator between each block.
-         *
-         * @param separator The separator to insert between each block.
-         * @param blocks The blocks to join.
-         * @return The String of joined blocks.
+         * Returns the number of blank lines which separate the given matrix of a frame from the previous one.
+         * @param shape The shape of the frame.
+         * @param matrix The index of the matrix, which is not the first.
+         * @return The number of blank lines.
          */
-        static String join_block(char32_t separator, const std::vector<String>& blocks);
+        static unsigned int blank_lines(const std::vector<unsigned int>& shape, std::size_t matrix);
 
         /**
-         * Frames a matrix by adding box-drawing characters around it.
-         *
-         * @param strings The Strings which make up the matrix.
-         * @param widths The widths of each column.
-         * @param height The height of the matrix.
-         * @return The framed matrix in String format.
+         * Draws a Block onto the grid, with its top left corner at the given line and column.
+         * @param block The Block to draw.
+         * @param grid The lines to draw onto, which are large enough to hold the Block.
+         * @param line The line of the top of the Block.
+         * @param column The column of the left of the Block.
          */
-        static String frame_matrix(const std::vector<String>& strings, const std::vector<unsigned int>& widths, unsigned int height);
+        static void draw(const Block& block, std::vector<String>& grid, std::size_t line, std::size_t column);
     };
 };
\ No newline at end of file
@@ -0,0 +1,236 @@
+//
+// Copyright 2023 Nikolaj Banke Jensen.
+//
+// This file is part of Kepler.
+// 
+// Kepler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Kepler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License 
+// along with Kepler. If not, see <https://www.gnu.org/licenses/>.
+//
+#include "binary_file.h"
+#include "file_reader.h"
+#include "core/error.h"
+#include "core/memory.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <random>
+
+namespace {
+    std::size_t width_of(int type) {
+        switch(type) {
+            case kepler::Unsigned8:
+            case kepler::Char8:
+                return 1;
+            case kepler::Integer32:
+            case kepler::Char32:
+                return 4;
+            case kepler::Integer64:
+            case kepler::Float64:
+                return 8;
+            default:
+                throw kepler::Error(kepler::DomainError, "Unknown type of binary file: " + std::to_string(type) + ".");
+        }
+    }
+
+    bool is_char(int type) {
+        return type == kepler::Char8 || type == kepler::Char32;
+    }
+
+    template<typename T>
+    T load(const char* bytes) {
+        T value;
+        std::memcpy(&value, bytes, sizeof(T));
+        return value;
+    }
+
+    template<typename T>
+    void store(std::string& out, T value) {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    kepler::Char char_at(int type, const char* at) {
+        return type == kepler::Char8 ? static_cast<std::uint8_t>(*at) : load<kepler::Char>(at);
+    }
+
+    kepler::Number number_at(int type, const char* at) {
+        switch(type) {
+            case kepler::Unsigned8: return static_cast<std::uint8_t>(*at);
+            case kepler::Integer32: return load<std::int32_t>(at);
+            case kepler::Integer64: return static_cast<double>(load<std::int64_t>(at));
+            default: return load<double>(at);
+        }
+    }
+
+    void store_char(std::string& out, int type, kepler::Char c) {
+        if(type == kepler::Char32) {
+            store(out, c);
+        } else if(c <= 0xFF) {
+            store(out, static_cast<std::uint8_t>(c));
+        } else {
+            throw kepler::Error(kepler::DomainError, "The character cannot be written as a single byte.");
+        }
+    }
+
+    // Returns the element of a simple scalar, which is boxed in the elements of a vector.
+    const kepler::Array::element_type& simple(const kepler::Array::element_type& element) {
+        if(auto boxed = std::get_if<kepler::Array>(&element)) {
+            if(!boxed->is_simple_scalar()) {
+                throw kepler::Error(kepler::DomainError, "Only arrays of simple scalars can be written to binary files.");
+            }
+            return boxed->data[0];
+        }
+        return element;
+    }
+
+    // Converts a number to an integer of type T, if it is a whole number which T can hold.
+    template<typename T>
+    T whole(const kepler::Number& number) {
+        // The upper bound is exclusive, as the largest value of a 64-bit integer is not a double.
+        auto upper = std::ldexp(1.0, std::numeric_limits<T>::digits);
+        auto lower = static_cast<double>(std::numeric_limits<T>::min());
+        if(number.imag() != 0 || number.real() != std::floor(number.real()) || number.real() < lower || number.real() >= upper) {
+            throw kepler::Error(kepler::DomainError, "The number cannot be written as an integer of the type.");
+        }
+        return static_cast<T>(number.real());
+    }
+}
+
+kepler::Array kepler::read_binary(const std::string& path, int type, const std::optional<std::vector<unsigned int>>& shape) {
+    auto width = width_of(type);
+    auto file = std::make_shared<const FileBytes>(path);
+    auto bytes = file->view();
+
+    if(bytes.size() % width != 0) {
+        throw kepler::Error(LengthError, "The file does not hold a whole number of elements of the type.");
+    }
+    auto count = bytes.size() / width;
+
+    Array result = {shape.value_or(std::vector<unsigned int>{static_cast<unsigned int>(count)}), {}};
+    std::size_t expected = 1;
+    for(auto dim : result.shape) {
+        expected *= dim;
+    }
+    if(expected != count) {
+        throw kepler::Error(LengthError, "The file holds " + std::to_string(count) + " elements, but the shape has " + std::to_string(expected) + ".");
+    }
+
+    if(type == Float64) {
+        // The numbers are used from the file, which they keep alive, and copied only once they are written.
+        // Files are written by replacing them rather than writing into them, so a write never changes them.
+        if(reinterpret_cast<std::uintptr_t>(bytes.data()) % alignof(double) == 0) {
+            result.data = Storage<Array::element_type>(Numbers(file, reinterpret_cast<const double*>(bytes.data()), count, false));
+            return result;
+        }
+
+        // The file was read into a buffer without the alignment of doubles, so the numbers are copied.
+        auto values = std::make_shared<std::vector<double, memory::Allocator<double>>>(count);
+        std::copy_n(bytes.data(), bytes.size(), reinterpret_cast<char*>(values->data()));
+        result.data = Storage<Array::element_type>(Numbers(values, values->data(), count, false));
+        return result;
+    }
+
+    if(is_char(type)) {
+        String chars;
+        chars.reserve(count);
+        for(std::size_t i = 0; i < count; ++i) {
+            chars.push_back(char_at(type, bytes.data() + i * width));
+        }
+        result.data = Storage<Array::element_type>(Text(chars));
+        return result;
+    }
+
+    auto& elements = result.data.mutate();
+    elements.reserve(count);
+    for(std::size_t i = 0; i < count; ++i) {
+        elements.emplace_back(Array{number_at(type, bytes.data() + i * width)});
+    }
+    return result;
+}
+
+std::size_t kepler::write_binary(const std::string& path, int type, const Array& array) {
+    auto width = width_of(type);
+
+    std::string buffer;
+    const char* data = nullptr;
+    std::size_t size = 0;
+
+    auto numbers = array.data.numbers();
+    if(type == Float64 && numbers && !numbers->is_complex()) {
+        // The numbers already have the layout of the file.
+        data = reinterpret_cast<const char*>(numbers->doubles());
+        size = numbers->size() * width;
+    } else {
+        buffer.reserve(array.data.size() * width);
+        if(auto text = array.data.text(); text && is_char(type)) {
+            for(std::size_t i = 0; i < text->size(); ++i) {
+                store_char(buffer, type, (*text)[i]);
+            }
+        } else {
+            for(auto& element : array.data) {
+                auto& scalar = simple(element);
+                if(is_char(type) != std::holds_alternative<Char>(scalar)) {
+                    throw kepler::Error(DomainError, is_char(type) ? "Expected characters." : "Expected numbers.");
+                }
+
+                if(auto c = std::get_if<Char>(&scalar)) {
+                    store_char(buffer, type, *c);
+                    continue;
+                }
+
+                auto& number = std::get<Number>(scalar);
+                switch(type) {
+                    case Unsigned8: store(buffer, whole<std::uint8_t>(number)); break;
+                    case Integer32: store(buffer, whole<std::int32_t>(number)); break;
+                    case Integer64: store(buffer, whole<std::int64_t>(number)); break;
+                    default:
+                        if(number.imag() != 0) {
+                            throw kepler::Error(DomainError, "Complex numbers cannot be written as real numbers.");
+                        }
+                        store(buffer, number.real());
+                        break;
+                }
+            }
+        }
+        data = buffer.data();
+        size = buffer.size();
+    }
+
+    // Write to a temporary file first, so a failed write never leaves a partial file behind.
+    std::error_code error;
+    std::filesystem::path temporary = path;
+    temporary += ".tmp" + std::to_string(std::random_device()());
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if(!out.is_open()) {
+            throw kepler::Error(FileError, "Could not open the file.");
+        }
+        out.write(data, static_cast<std::streamsize>(size));
+        if(!out) {
+            out.close();
+            std::filesystem::remove(temporary, error);
+            throw kepler::Error(FileError, "Could not write the file.");
+        }
+    }
+
+    std::filesystem::rename(temporary, path, error);
+    if(error) {
+        std::filesystem::remove(temporary, error);
+        throw kepler::Error(FileError, "Could not write the file.");
+    }
+    return size / width;
+}
@@ -0,0 +1,73 @@
+//
+// Copyright 2023 Nikolaj Banke Jensen.
+//
+// This file is part of Kepler.
+// 
+// Kepler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Kepler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License 
+// along with Kepler. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include <optional>
+#include <string>
+#include <vector>
+#include "core/array.h"
+
+namespace kepler {
+
+    /**
+     * The types of elements of binary array files.
+     *
+     * The codes follow the convention of APL: the width of the element in bits, followed by
+     * a digit for its kind (0 for characters, 3 for integers, 5 for floating point numbers).
+     * Elements are stored in the byte order of the machine.
+     */
+    enum BinaryType {
+        Unsigned8 = 83,
+        Integer32 = 323,
+        Integer64 = 643,
+        Float64 = 645,
+        Char8 = 80,
+        Char32 = 320,
+    };
+
+    /**
+     * Reads an array of the given type and shape from a binary file.
+     *
+     * Files of 64-bit floating point numbers have the layout of numbers in memory, so their
+     * elements are used directly from the mapped file, and are only created when they are first accessed.
+     *
+     * @param path The path of the file.
+     * @param type The code of the type of the elements of the file.
+     * @param shape The shape of the array, or nullopt to read every element of the file into a vector.
+     * @return The array.
+     * @throws Error if the file could not be read, the type is unknown,
+     *         or the file does not hold exactly the elements of the shape.
+     */
+    Array read_binary(const std::string& path, int type, const std::optional<std::vector<unsigned int>>& shape);
+
+    /**
+     * Writes the ravel of an array to a binary file, as elements of the given type.
+     *
+     * The elements are written to a temporary file, which then replaces the file, so the file is
+     * never left partly written, and arrays read from it stay valid.
+     *
+     * @param path The path of the file, which is replaced if it exists.
+     * @param type The code of the type of the elements of the file.
+     * @param array The array of simple scalars to write.
+     * @return The number of elements written.
+     * @throws Error if the file could not be written, the type is unknown,
+     *         or an element of the array cannot be represented by the type.
+     */
+    std::size_t write_binary(const std::string& path, int type, const Array& array);
+};
@@ -19,20 +19,72 @@
 
 #include "conversion.h"
 #include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
 #include <uni_algo/conv.h>
+#include "core/error.h"
+#include "core/literals.h"
 
-kepler::Number kepler::from_string(const std::string& num_str) {
-    String str = uni::utf8to32u(num_str);
-    std::replace(str.begin(), str.end(), U'¯', U'-');
+namespace {
+    // The longest literal accumulated directly as an integer, which is exact in an int64_t.
+    constexpr std::size_t max_integer_digits = 18;
 
-    size_t complex_index = str.find(U'J');
-    if(complex_index != String::npos) {
-        return {
-                std::stod(uni::utf32to8(str.substr(0, complex_index))), std::stod(uni::utf32to8(str.substr(complex_index + 1)))
-        };
+    // Parses a real number, in which '¯' and '-' both denote negation.
+    double parse_real(std::u32string_view str) {
+        bool negative = !str.empty() && (str.front() == U'¯' || str.front() == U'-');
+        auto digits = negative ? str.substr(1) : str;
+
+        if(!digits.empty() && digits.size() <= max_integer_digits && std::all_of(digits.begin(), digits.end(), [](char32_t c) { return c >= U'0' && c <= U'9'; })) {
+            std::int64_t value = 0;
+            for(char32_t c : digits) {
+                value = value * 10 + (c - U'0');
+            }
+            return negative ? -static_cast<double>(value) : static_cast<double>(value);
+        }
+
+        // Every other character of a literal is ASCII, so it is narrowed for std::from_chars.
+        char small[64]{};
+        std::string large;
+        char* buffer = small;
+        if(str.size() > sizeof(small)) {
+            large.resize(str.size());
+            buffer = large.data();
+        }
+
+        for(std::size_t i = 0; i < str.size(); ++i) {
+            char32_t c = str[i];
+            if(c == U'¯') c = U'-';
+            if(c > 0x7F) {
+                throw kepler::Error(kepler::SyntaxError, "Invalid number.");
+            }
+            buffer[i] = static_cast<char>(c);
+        }
+
+        double result = 0;
+        auto [end, error] = std::from_chars(buffer, buffer + str.size(), result);
+        if(error == std::errc::result_out_of_range) {
+            // Numbers too small to represent become zero, but numbers too large are rejected.
+            result = std::strtod(std::string(buffer, str.size()).c_str(), nullptr);
+            if(std::isinf(result)) {
+                throw kepler::Error(kepler::DomainError, "The number is too large.");
+            }
+            return result;
+        }
+        if(error != std::errc() || end != buffer + str.size()) {
+            throw kepler::Error(kepler::SyntaxError, "Invalid number.");
+        }
+        return result;
     }
+}
 
-    return {std::stod(uni::utf32to8(str))};
+kepler::Number kepler::from_string(std::u32string_view str) {
+    auto complex_index = str.find(constants::complex_marker);
+    if(complex_index != std::u32string_view::npos) {
+        return {parse_real(str.substr(0, complex_index)), parse_real(str.substr(complex_index + 1))};
+    }
+    return {parse_real(str)};
 }
 
 std::string kepler::to_string(const TokenType& type) {
@@ -81,6 +133,16 @@ std::string kepler::to_string(const TokenType& type) {
             return "WITHOUT";
         case LEFT_SHOE:
             return "LSHOE";
+        case EPSILON:
+            return "EPSILON";
+        case DOWN_SHOE:
+            return "DSHOE";
+        case UP_SHOE:
+            return "USHOE";
+        case DELTA_STILE:
+            return "DELTASTILE";
+        case DEL_STILE:
+            return "DELSTILE";
         case RHO:
             return "RHO";
         case AND:
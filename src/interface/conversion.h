@@ -19,17 +19,20 @@
 
 #pragma once
 #include <string>
+#include <string_view>
 #include "core/datatypes.h"
 #include "core/token_type.h"
 
 namespace kepler {
 
     /**
-     * Converts a string to a Number.
-     * @param num_str The string to convert.
-     * @return The Number representation of the string.
+     * Converts a numeric literal to a Number.
+     *
+     * The literal is read directly from its characters, where both '¯' and '-' denote negation.
+     * @param str The literal to convert.
+     * @return The Number representation of the literal.
      */
-    Number from_string(const std::string& num_str);
+    Number from_string(std::u32string_view str);
 
     /**
      * Converts a TokenType to a string.
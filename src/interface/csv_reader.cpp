@@ -0,0 +1,323 @@
+//
+// Copyright 2023 Nikolaj Banke Jensen.
+//
+// This file is part of Kepler.
+// 
+// Kepler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Kepler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License 
+// along with Kepler. If not, see <https://www.gnu.org/licenses/>.
+//
+#include "csv_reader.h"
+#include "file_reader.h"
+#include "core/error.h"
+#include "core/memory.h"
+#include "core/evaluation/parallel.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+namespace {
+    // The location of a field in the file.
+    struct Field {
+        std::uint64_t offset;
+        std::uint32_t length;
+        bool quoted;
+    };
+
+    // The rows of a range of the file, and what is known of the types of their columns.
+    struct Chunk {
+        std::size_t quotes = 0;
+        std::size_t rows = 0;
+        std::size_t columns = 0;
+        std::vector<Field> fields;
+
+        // The value of every field which is a number.
+        std::vector<double> numbers;
+
+        // For every column, whether all its fields in this chunk are numbers or empty.
+        std::vector<char> numeric;
+
+        // For every column, whether any of its fields in this chunk is a number.
+        std::vector<char> has_numbers;
+    };
+
+    /**
+     * Parses the rows of a delimited file.
+     */
+    class RowParser {
+    private:
+        std::string_view bytes;
+        char delimiter;
+
+    public:
+        RowParser(std::string_view bytes_, char delimiter_) : bytes(bytes_), delimiter(delimiter_) {}
+
+        /**
+         * Returns the first position at or after the given one where a row starts.
+         *
+         * @param position The position to search from.
+         * @param quoted Whether the position is inside a quoted field.
+         */
+        [[nodiscard]] std::size_t row_start(std::size_t position, bool quoted) const {
+            if(position == 0 || (!quoted && bytes[position - 1] == '\n')) {
+                return position;
+            }
+            for(; position < bytes.size(); ++position) {
+                if(bytes[position] == '"') {
+                    quoted = !quoted;
+                } else if(bytes[position] == '\n' && !quoted) {
+                    return position + 1;
+                }
+            }
+            return bytes.size();
+        }
+
+        /**
+         * Parses the row at the given position, appending its fields.
+         *
+         * @param position The start of the row, which is moved past its end.
+         * @param fields The fields to append to.
+         * @return The number of fields of the row, or 0 if it is blank.
+         */
+        std::size_t row(std::size_t& position, std::vector<Field>& fields) const {
+            std::size_t first = fields.size();
+            while(true) {
+                Field field{position, 0, false};
+                if(position < bytes.size() && bytes[position] == '"') {
+                    field.quoted = true;
+                    field.offset = ++position;
+                    while(position < bytes.size() && (bytes[position] != '"' || (position + 1 < bytes.size() && bytes[position + 1] == '"'))) {
+                        position += bytes[position] == '"' ? 2 : 1;
+                    }
+                    if(position == bytes.size()) {
+                        throw kepler::Error(kepler::DomainError, "A quoted field is never closed.");
+                    }
+                    field.length = static_cast<std::uint32_t>(position++ - field.offset);
+                    if(position + 1 < bytes.size() && bytes[position] == '\r' && bytes[position + 1] == '\n') {
+                        ++position;
+                    }
+                    if(position < bytes.size() && bytes[position] != delimiter && bytes[position] != '\n') {
+                        throw kepler::Error(kepler::DomainError, "Expected a delimiter after a quoted field.");
+                    }
+                } else {
+                    while(position < bytes.size() && bytes[position] != delimiter && bytes[position] != '\n') {
+                        ++position;
+                    }
+                    field.length = static_cast<std::uint32_t>(position - field.offset);
+                    if(field.length > 0 && bytes[position - 1] == '\r' && (position == bytes.size() || bytes[position] == '\n')) {
+                        --field.length;
+                    }
+                }
+                fields.push_back(field);
+
+                if(position < bytes.size() && bytes[position] == delimiter) {
+                    ++position;
+                    continue;
+                }
+                if(position < bytes.size()) {
+                    ++position;
+                }
+                break;
+            }
+
+            if(fields.size() == first + 1 && !fields.back().quoted && fields.back().length == 0) {
+                fields.pop_back();
+                return 0;
+            }
+            return fields.size() - first;
+        }
+
+        [[nodiscard]] std::string_view text(const Field& field) const {
+            return bytes.substr(field.offset, field.length);
+        }
+    };
+
+    // Parses a number in the notation of APL, or as it is commonly written in delimited files.
+    bool parse_number(std::string_view text, double& value) {
+        while(!text.empty() && text.front() == ' ') {
+            text.remove_prefix(1);
+        }
+        while(!text.empty() && text.back() == ' ') {
+            text.remove_suffix(1);
+        }
+
+        bool negative = false;
+        if(text.starts_with("¯") || text.starts_with('-')) {
+            negative = true;
+            text.remove_prefix(text.front() == '-' ? 1 : 2);
+        }
+        // Rule out what from_chars accepts beyond decimal numbers, such as 'inf' and 'nan'.
+        if(text.empty() || !(std::isdigit(static_cast<unsigned char>(text.front())) || text.front() == '.')) {
+            return false;
+        }
+
+        auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if(error != std::errc() || end != text.data() + text.size()) {
+            return false;
+        }
+        value = negative ? -value : value;
+        return true;
+    }
+
+    kepler::Array text_of(const RowParser& parser, const Field& field) {
+        auto text = parser.text(field);
+        std::string unescaped;
+        if(field.quoted && text.find('"') != std::string_view::npos) {
+            unescaped.reserve(text.size());
+            for(std::size_t i = 0; i < text.size(); ++i) {
+                unescaped.push_back(text[i]);
+                i += text[i] == '"';
+            }
+            text = unescaped;
+        }
+
+        std::vector<kepler::Char> chars;
+        kepler::decode_utf8(text, chars);
+        return kepler::Array(kepler::Text(kepler::String(chars.begin(), chars.end())));
+    }
+}
+
+kepler::Array kepler::read_csv(const std::string& path, const CsvOptions& options) {
+    FileBytes file(path);
+    RowParser parser(file.view(), options.delimiter);
+
+    std::size_t base = 0;
+    std::vector<Field> skipped;
+    for(std::size_t i = 0; i < options.skipped_rows && base < file.view().size(); ++i) {
+        parser.row(base, skipped);
+    }
+
+    // Rows may span several ranges of the file, as quoted fields can contain newlines.
+    // Where a range's first row starts thus depends on whether it starts inside quotes,
+    // which is found by counting the quotes before it.
+    auto size = file.view().size() - base;
+    std::vector<Chunk> chunks(parallel::chunk_count(size));
+    parallel::for_chunks(size, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+        chunks[chunk].quotes = std::count(file.view().begin() + base + begin, file.view().begin() + base + end, '"');
+    });
+
+    std::vector<std::size_t> starts(chunks.size() + 1, base + size);
+    std::size_t quotes = 0;
+    for(std::size_t chunk = 0; chunk < chunks.size(); ++chunk) {
+        starts[chunk] = chunk == 0 ? base : parser.row_start(base + size * chunk / chunks.size(), quotes % 2 == 1);
+        quotes += chunks[chunk].quotes;
+    }
+
+    parallel::for_chunks(size, [&](std::size_t chunk, std::size_t, std::size_t) {
+        auto& current = chunks[chunk];
+        for(std::size_t position = starts[chunk]; position < std::max(starts[chunk], starts[chunk + 1]);) {
+            auto columns = parser.row(position, current.fields);
+            if(columns == 0) {
+                continue;
+            }
+            if(current.rows == 0) {
+                current.columns = columns;
+                current.numeric.assign(columns, 1);
+                current.has_numbers.assign(columns, 0);
+            } else if(columns != current.columns) {
+                throw kepler::Error(LengthError, "Every row must have the same number of fields.");
+            }
+            ++current.rows;
+        }
+
+        current.numbers.resize(current.fields.size());
+        for(std::size_t i = 0; i < current.fields.size(); ++i) {
+            auto& field = current.fields[i];
+            auto column = i % current.columns;
+            if(field.quoted) {
+                current.numeric[column] = 0;
+            } else if(field.length == 0) {
+                current.numbers[i] = 0;
+            } else if(parse_number(parser.text(field), current.numbers[i])) {
+                current.has_numbers[column] = 1;
+            } else {
+                current.numeric[column] = 0;
+            }
+        }
+    });
+
+    std::size_t columns = 0;
+    std::size_t rows = 0;
+    std::vector<std::size_t> row_offsets;
+    for(auto& chunk : chunks) {
+        if(chunk.rows > 0 && columns != 0 && chunk.columns != columns) {
+            throw kepler::Error(LengthError, "Every row must have the same number of fields.");
+        }
+        columns = chunk.rows > 0 ? chunk.columns : columns;
+        row_offsets.emplace_back(rows);
+        rows += chunk.rows;
+    }
+
+    std::vector<char> numeric(columns, 1);
+    std::vector<char> has_numbers(columns, 0);
+    for(auto& chunk : chunks) {
+        for(std::size_t column = 0; column < chunk.numeric.size(); ++column) {
+            numeric[column] &= chunk.numeric[column];
+            has_numbers[column] |= chunk.has_numbers[column];
+        }
+    }
+    for(std::size_t column = 0; column < columns; ++column) {
+        // A column of only empty fields holds text.
+        numeric[column] &= has_numbers[column];
+    }
+
+    // Numeric columns are counted as the elements of Arrays are, as they end up held by them.
+    std::vector<std::shared_ptr<std::vector<double, memory::Allocator<double>>>> number_columns(columns);
+    std::vector<Array::buffer_type> text_columns(columns);
+    Array::buffer_type cells;
+    if(options.matrix) {
+        cells.resize(rows * columns);
+    } else {
+        for(std::size_t column = 0; column < columns; ++column) {
+            if(numeric[column]) {
+                number_columns[column] = std::make_shared<std::vector<double, memory::Allocator<double>>>(rows);
+            } else {
+                text_columns[column].resize(rows);
+            }
+        }
+    }
+
+    parallel::for_chunks(size, [&](std::size_t chunk, std::size_t, std::size_t) {
+        auto& current = chunks[chunk];
+        for(std::size_t i = 0; i < current.fields.size(); ++i) {
+            auto column = i % columns;
+            auto row = row_offsets[chunk] + i / columns;
+            if(options.matrix) {
+                cells[row * columns + column] = numeric[column] ? Array{Number(current.numbers[i])} : text_of(parser, current.fields[i]);
+            } else if(numeric[column]) {
+                (*number_columns[column])[row] = current.numbers[i];
+            } else {
+                text_columns[column][row] = text_of(parser, current.fields[i]);
+            }
+        }
+    });
+
+    if(options.matrix) {
+        return {{static_cast<unsigned int>(rows), static_cast<unsigned int>(columns)}, std::move(cells)};
+    }
+
+    Array result = {{static_cast<unsigned int>(columns)}, {}};
+    for(std::size_t column = 0; column < columns; ++column) {
+        if(rows == 0) {
+            result.data.emplace_back(Array{{0}, {}});
+        } else if(numeric[column]) {
+            auto& values = number_columns[column];
+            result.data.emplace_back(Array{{static_cast<unsigned int>(rows)}, Storage<Array::element_type>(Numbers(values, values->data(), rows, false))});
+        } else {
+            result.data.emplace_back(Array{{static_cast<unsigned int>(rows)}, std::move(text_columns[column])});
+        }
+    }
+    return result;
+}
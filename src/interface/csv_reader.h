@@ -0,0 +1,59 @@
+//
+// Copyright 2023 Nikolaj Banke Jensen.
+//
+// This file is part of Kepler.
+// 
+// Kepler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Kepler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License 
+// along with Kepler. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include <cstddef>
+#include <string>
+#include "core/array.h"
+
+namespace kepler {
+
+    /**
+     * Options controlling how a delimited text file is read.
+     */
+    struct CsvOptions {
+        // The character separating the fields of a row.
+        char delimiter = ',';
+
+        // The number of rows at the start of the file which are skipped, such as a header.
+        std::size_t skipped_rows = 0;
+
+        // Whether to return a matrix of fields rather than a vector of columns.
+        bool matrix = false;
+    };
+
+    /**
+     * Reads a file of delimited fields, such as CSV or TSV, into an array.
+     *
+     * Fields may be quoted with '"', in which case they can contain delimiters, newlines and
+     * escaped quotes ('""'). Rows end with a newline, optionally preceded by a carriage return,
+     * and blank rows are skipped. Every row must have the same number of fields.
+     *
+     * A column whose unquoted fields are all numbers (or empty, which is read as 0) is a numeric vector.
+     * Any other column is a vector of character vectors.
+     *
+     * The file is split into ranges of rows which are parsed in parallel.
+     *
+     * @param path The path of the file.
+     * @param options How to read the file.
+     * @return A vector of the columns of the file, or a matrix of its fields.
+     * @throws Error if the file could not be read, or its rows do not have the same number of fields.
+     */
+    Array read_csv(const std::string& path, const CsvOptions& options = {});
+};
@@ -16,41 +16,251 @@
 // You should have received a copy of the GNU General Public License 
 // along with Kepler. If not, see <https://www.gnu.org/licenses/>.
 //
-
 #include "file_reader.h"
 #include "core/error.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
-#include <uni_algo/conv.h>
+#include <iterator>
 
-std::vector<std::vector<kepler::Char>> kepler::read_file(const std::string& path) {
-    if(!path.ends_with(".kpl")) {
-        throw kepler::Error(FileError, "Only .kpl files are accepted.");
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define KEPLER_HAS_MMAP 1
+#endif
+
+namespace {
+    constexpr kepler::Char replacement_character = U'�';
+
+    // Returns the number of bytes in the sequence starting with the given byte, or 0 if it cannot start one.
+    int sequence_length(std::uint8_t lead) {
+        if(lead < 0x80) return 1;
+        if(lead >= 0xC2 && lead <= 0xDF) return 2;
+        if(lead >= 0xE0 && lead <= 0xEF) return 3;
+        if(lead >= 0xF0 && lead <= 0xF4) return 4;
+        return 0;
+    }
+
+    std::uint64_t rotate(std::uint64_t value, int bits) {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    std::uint64_t finalize(std::uint64_t value) {
+        value ^= value >> 33;
+        value *= 0xff51afd7ed558ccdULL;
+        value ^= value >> 33;
+        value *= 0xc4ceb9fe1a85ec53ULL;
+        value ^= value >> 33;
+        return value;
+    }
+
+    constexpr std::uint64_t c1 = 0x87c37b91114253d5ULL;
+    constexpr std::uint64_t c2 = 0x4cf5ad432745937fULL;
+
+    std::uint64_t mix_first(std::uint64_t k) {
+        return rotate(k * c1, 31) * c2;
+    }
+
+    std::uint64_t mix_second(std::uint64_t k) {
+        return rotate(k * c2, 33) * c1;
+    }
+}
+
+kepler::Digest kepler::digest(std::string_view bytes) {
+    std::uint64_t h1 = 0;
+    std::uint64_t h2 = 0;
+
+    // The body is hashed in blocks of 16 bytes.
+    std::size_t blocks = bytes.size() / 16;
+    for(std::size_t i = 0; i < blocks; ++i) {
+        std::uint64_t k1;
+        std::uint64_t k2;
+        std::memcpy(&k1, bytes.data() + i * 16, sizeof(k1));
+        std::memcpy(&k2, bytes.data() + i * 16 + 8, sizeof(k2));
+
+        h1 ^= mix_first(k1);
+        h1 = rotate(h1, 27) + h2;
+        h1 = h1 * 5 + 0x52dce729;
+
+        h2 ^= mix_second(k2);
+        h2 = rotate(h2, 31) + h1;
+        h2 = h2 * 5 + 0x38495ab5;
+    }
+
+    // The remaining bytes are gathered into two words.
+    auto tail = reinterpret_cast<const std::uint8_t*>(bytes.data()) + blocks * 16;
+    std::size_t remaining = bytes.size() % 16;
+    std::uint64_t k1 = 0;
+    std::uint64_t k2 = 0;
+    for(std::size_t i = remaining; i > 8; --i) {
+        k2 ^= static_cast<std::uint64_t>(tail[i - 1]) << ((i - 9) * 8);
+    }
+    for(std::size_t i = std::min<std::size_t>(remaining, 8); i > 0; --i) {
+        k1 ^= static_cast<std::uint64_t>(tail[i - 1]) << ((i - 1) * 8);
+    }
+    if(remaining > 8) {
+        h2 ^= mix_second(k2);
+    }
+    if(remaining > 0) {
+        h1 ^= mix_first(k1);
+    }
+
+    h1 ^= bytes.size();
+    h2 ^= bytes.size();
+    h1 += h2;
+    h2 += h1;
+    h1 = finalize(h1);
+    h2 = finalize(h2);
+    h1 += h2;
+    h2 += h1;
+    return {h1, h2, bytes.size()};
+}
+
+kepler::FileBytes::FileBytes(const std::string& path) {
+#ifdef KEPLER_HAS_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0) {
+        throw kepler::Error(kepler::FileError, "Could not open the file.");
     }
 
-    std::ifstream f(path);
+    struct stat info{};
+    if(::fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+        void* address = ::mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(address != MAP_FAILED) {
+            ::madvise(address, info.st_size, MADV_SEQUENTIAL);
+            data = static_cast<const char*>(address);
+            size = info.st_size;
+            mapped = true;
+        }
+    }
+    ::close(fd);
 
+    if(mapped || (info.st_size == 0 && S_ISREG(info.st_mode))) {
+        return;
+    }
+#endif
+    std::ifstream f(path, std::ios::binary);
     if(!f.is_open()) {
-        throw kepler::Error(FileError, "Could not open the file.");
+        throw kepler::Error(kepler::FileError, "Could not open the file.");
     }
+    buffer.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+    data = buffer.data();
+    size = buffer.size();
+}
+
+kepler::FileBytes::~FileBytes() {
+#ifdef KEPLER_HAS_MMAP
+    if(mapped) {
+        ::munmap(const_cast<char*>(data), size);
+    }
+#endif
+}
+
+void kepler::decode_utf8(std::string_view bytes, std::vector<Char>& out) {
+    // A character is never shorter than a byte, so the result fits in as many characters as there are bytes.
+    std::size_t written = out.size();
+    out.resize(written + bytes.size());
+    Char* result = out.data();
+
+    auto input = reinterpret_cast<const std::uint8_t*>(bytes.data());
+    std::size_t size = bytes.size();
+    std::size_t i = 0;
+
+    while(i < size) {
+        // Copy ASCII eight bytes at a time.
+        while(i + 8 <= size) {
+            std::uint64_t word;
+            std::memcpy(&word, input + i, sizeof(word));
+            if(word & 0x8080808080808080ULL) {
+                break;
+            }
+            for(int j = 0; j < 8; ++j) {
+                result[written++] = input[i + j];
+            }
+            i += 8;
+        }
+
+        if(i >= size) {
+            break;
+        }
+
+        std::uint8_t lead = input[i];
+        int length = sequence_length(lead);
+        if(length == 1) {
+            result[written++] = lead;
+            ++i;
+            continue;
+        } else if(length == 0 || i + length > size) {
+            result[written++] = replacement_character;
+            ++i;
+            continue;
+        }
+
+        Char c = lead & (0x7F >> length);
+        bool valid = true;
+        for(int j = 1; j < length; ++j) {
+            std::uint8_t next = input[i + j];
+            if((next & 0xC0) != 0x80) {
+                valid = false;
+                break;
+            }
+            c = (c << 6) | (next & 0x3F);
+        }
+
+        // Reject overlong encodings, surrogates and code points beyond Unicode.
+        if(valid && ((length == 3 && c < 0x800) || (length == 4 && c < 0x10000) || (c >= 0xD800 && c <= 0xDFFF) || c > 0x10FFFF)) {
+            valid = false;
+        }
 
-    std::stringstream ss;
-    std::vector<std::vector<kepler::Char>> result;
-    for(std::string line; getline(f, line); ) {
-        String str = uni::utf8to32u(line);
-        result.emplace_back(str.begin(), str.end());
+        if(valid) {
+            result[written++] = c;
+            i += length;
+        } else {
+            result[written++] = replacement_character;
+            ++i;
+        }
     }
-    f.close();
-    return result;
+
+    out.resize(written);
 }
 
-std::vector<kepler::Char> kepler::concat_lines(const std::vector<std::vector<kepler::Char>>& lines) {
-    std::vector<kepler::Char> result;
-    for(auto& line : lines) {
-        std::copy(line.begin(), line.end(), std::back_inserter(result));
-        result.emplace_back(U'\n');
+kepler::Source kepler::read_file(const std::string& path) {
+    if(!path.ends_with(".kpl")) {
+        throw kepler::Error(FileError, "Only .kpl files are accepted.");
+    }
+
+    FileBytes bytes(path);
+
+    Source source;
+    source.digest = digest(bytes.view());
+    decode_utf8(bytes.view(), source.text);
+
+    // A final newline ends the last line, rather than starting another.
+    if(!source.text.empty() && source.text.back() == U'\n') {
+        source.text.pop_back();
     }
-    if(!result.empty()) {
-        result.pop_back();
+
+    source.line_starts.emplace_back(0);
+    for(std::size_t i = 0; i < source.text.size(); ++i) {
+        if(source.text[i] == U'\n') {
+            source.line_starts.emplace_back(i + 1);
+        }
     }
-    return result;
-}
\ No newline at end of file
+
+    return source;
+}
+
+std::size_t kepler::Source::line_of(long position) const {
+    // The newline character ending a line belongs to the line, so a line extends up to the start of the next.
+    auto next = std::lower_bound(line_starts.begin() + 1, line_starts.end(), static_cast<std::size_t>(std::max(position, 0L)));
+    return next - (line_starts.begin() + 1);
+}
+
+std::vector<kepler::Char> kepler::Source::line(std::size_t index) const {
+    auto begin = text.begin() + line_starts[index];
+    auto end = index + 1 < line_starts.size() ? text.begin() + line_starts[index + 1] - 1 : text.end();
+    return {begin, end};
+}
@@ -18,28 +18,112 @@
 //
 
 #pragma once
+#include <cstdint>
 #include <vector>
 #include <string>
+#include <string_view>
 #include "core/datatypes.h"
 
 namespace kepler {
 
     /**
-     * Reads the given file and returns a vector of lines.
-     * Each line is a vector of characters.
+     * The bytes of a file, mapped into memory when the platform allows it and read otherwise.
+     */
+    class FileBytes {
+    private:
+        std::string buffer;
+        const char* data = nullptr;
+        std::size_t size = 0;
+        bool mapped = false;
+
+    public:
+        /**
+         * Maps or reads the given file.
+         * @param path The path to the file.
+         * @throws Error if the file could not be opened.
+         */
+        explicit FileBytes(const std::string& path);
+
+        ~FileBytes();
+
+        FileBytes(const FileBytes&) = delete;
+        FileBytes& operator=(const FileBytes&) = delete;
+
+        /**
+         * Returns the bytes of the file, which stay valid for the lifetime of this object.
+         */
+        [[nodiscard]] std::string_view view() const {
+            return {data, size};
+        }
+    };
+
+    /**
+     * A 128-bit hash of the bytes of a file, along with their number, which identifies the file.
+     */
+    struct Digest {
+        std::uint64_t high = 0;
+        std::uint64_t low = 0;
+        std::uint64_t size = 0;
+
+        friend bool operator==(const Digest& lhs, const Digest& rhs) = default;
+    };
+
+    /**
+     * Returns the digest of the given bytes, using MurmurHash3 (x64, 128-bit).
+     * @param bytes The bytes to hash.
+     * @return The digest of the bytes.
+     */
+    Digest digest(std::string_view bytes);
+
+    /**
+     * The characters of a source file, with an index of where each of its lines start.
+     */
+    struct Source {
+        // The characters of the file, with lines separated by a newline character.
+        std::vector<Char> text;
+
+        // The offset in 'text' of the first character of each line.
+        std::vector<std::size_t> line_starts;
+
+        // The digest of the bytes of the file, before they were decoded.
+        Digest digest;
+
+        /**
+         * Returns the index of the line containing the given position.
+         *
+         * Positions are counted from 1, as in the positions of errors.
+         * @param position The position in 'text'.
+         * @return The index of the line, counted from 0.
+         */
+        [[nodiscard]] std::size_t line_of(long position) const;
+
+        /**
+         * Returns a copy of the characters on the given line, excluding the newline character.
+         * @param index The index of the line, counted from 0.
+         * @return The characters on the line.
+         */
+        [[nodiscard]] std::vector<Char> line(std::size_t index) const;
+    };
+
+    /**
+     * Reads the given file into a Source.
+     *
+     * The file is mapped into memory where possible, and decoded from UTF-8 in a single pass.
+ * Its bytes are hashed as they are, so the digest does not depend on how they decode.
      *
      * @param path The path to the file to read.
-     * @return The lines in the file.
+     * @return The contents of the file.
      * @throws Error if the file could not be read.
      */
-    std::vector<std::vector<kepler::Char>> read_file(const std::string& path);
+    Source read_file(const std::string& path);
 
     /**
-     * Concatenates the given lines into a single vector of characters.
-     * Separates the lines with a newline character.
+     * Decodes UTF-8 into characters, appending them to the given vector.
+     *
+     * Invalid sequences are decoded as the replacement character U+FFFD.
      *
-     * @param lines A vector of lines.
-     * @return The concatenated lines.
+     * @param bytes The UTF-8 to decode.
+     * @param out The vector to append the characters to.
      */
-    std::vector<kepler::Char> concat_lines(const std::vector<std::vector<kepler::Char>>& lines);
-};
\ No newline at end of file
+    void decode_utf8(std::string_view bytes, std::vector<Char>& out);
+};
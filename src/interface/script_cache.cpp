@@ -0,0 +1,230 @@
+//
+// Copyright 2023 Nikolaj Banke Jensen.
+//
+// This file is part of Kepler.
+// 
+// Kepler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Kepler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License 
+// along with Kepler. If not, see <https://www.gnu.org/licenses/>.
+//
+#include "script_cache.h"
+#include "core/error.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <type_traits>
+#include <unordered_map>
+
+namespace {
+    // Marks the start of every entry, and tells entries written with another byte order apart.
+    constexpr std::uint32_t magic = 0x434C504B;
+
+    // Raised whenever the tokenizer or the layout of entries changes, so older entries are ignored.
+    constexpr std::uint32_t format_version = 3;
+
+    struct Header {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint64_t high;
+        std::uint64_t low;
+        std::uint64_t size;
+        std::uint64_t statements;
+        std::uint64_t tokens;
+        std::uint64_t texts;
+        std::uint64_t characters;
+    };
+
+    // A token as stored in an entry, where its content is an index into the texts of the entry.
+    struct TokenRecord {
+        std::uint32_t type;
+        std::int32_t offset;
+        std::int32_t length;
+        std::uint32_t text;
+        double real;
+        double imag;
+    };
+
+    static_assert(std::is_trivially_copyable_v<Header> && std::is_trivially_copyable_v<TokenRecord>);
+
+    constexpr std::uint32_t no_text = std::numeric_limits<std::uint32_t>::max();
+
+    std::filesystem::path entry_path(const std::string& directory, const kepler::Digest& digest) {
+        char name[48];
+        std::snprintf(name, sizeof(name), "%016llx%016llx.kplc", static_cast<unsigned long long>(digest.high), static_cast<unsigned long long>(digest.low));
+        return std::filesystem::path(directory) / name;
+    }
+
+    /**
+     * Reads the sections of an entry in order, failing once a section would extend past its end.
+     */
+    class Reader {
+    private:
+        std::string_view bytes;
+        std::size_t cursor = 0;
+
+    public:
+        explicit Reader(std::string_view bytes_) : bytes(bytes_) {}
+
+        template<typename T>
+        bool read(T* out, std::size_t count) {
+            if(count > (bytes.size() - cursor) / sizeof(T)) {
+                return false;
+            }
+            std::memcpy(out, bytes.data() + cursor, count * sizeof(T));
+            cursor += count * sizeof(T);
+            return true;
+        }
+
+        [[nodiscard]] bool finished() const {
+            return cursor == bytes.size();
+        }
+    };
+
+    template<typename T>
+    void write(std::ofstream& out, const T* data, std::size_t count) {
+        out.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(count * sizeof(T)));
+    }
+}
+
+void kepler::CompiledScript::add(std::size_t start, const std::vector<Token>& statement) {
+    starts.emplace_back(start);
+    tokens.insert(tokens.end(), statement.begin(), statement.end());
+    bounds.emplace_back(tokens.size());
+}
+
+std::vector<kepler::Token> kepler::CompiledScript::statement(std::size_t index) const {
+    return {tokens.begin() + static_cast<long>(bounds[index]), tokens.begin() + static_cast<long>(bounds[index + 1])};
+}
+
+std::optional<kepler::CompiledScript> kepler::load_script(const std::string& directory, const Source& source) {
+    auto path = entry_path(directory, source.digest);
+
+    std::error_code error;
+    if(!std::filesystem::is_regular_file(path, error)) {
+        return std::nullopt;
+    }
+
+    try {
+        FileBytes bytes(path.string());
+        Reader reader(bytes.view());
+
+        Header header{};
+        if(!reader.read(&header, 1) || header.magic != magic || header.version != format_version
+           || Digest{header.high, header.low, header.size} != source.digest) {
+            return std::nullopt;
+        }
+
+        // Check the size of the entry before allocating for its sections.
+        auto size = bytes.view().size();
+        if(header.statements >= size || header.tokens >= size || header.texts >= size || header.characters >= size
+           || size != sizeof(Header) + (2 * header.statements + header.texts + 2) * sizeof(std::uint64_t)
+                     + header.tokens * sizeof(TokenRecord) + header.characters * sizeof(Char)) {
+            return std::nullopt;
+        }
+
+        CompiledScript script;
+        std::vector<TokenRecord> records(header.tokens);
+        std::vector<std::uint64_t> text_bounds(header.texts + 1);
+        std::vector<Char> characters(header.characters);
+        script.starts.resize(header.statements);
+        script.bounds.resize(header.statements + 1);
+
+        if(!reader.read(script.starts.data(), script.starts.size()) || !reader.read(script.bounds.data(), script.bounds.size())
+           || !reader.read(records.data(), records.size()) || !reader.read(text_bounds.data(), text_bounds.size())
+           || !reader.read(characters.data(), characters.size()) || !reader.finished()
+           || !std::is_sorted(script.starts.begin(), script.starts.end()) || (!script.starts.empty() && script.starts.back() >= source.text.size())
+           || !std::is_sorted(script.bounds.begin(), script.bounds.end()) || script.bounds.back() != records.size()
+           || !std::is_sorted(text_bounds.begin(), text_bounds.end()) || text_bounds.back() != characters.size()) {
+            return std::nullopt;
+        }
+
+        // Ids are only meaningful within one run, so the texts of the entry are interned anew.
+        std::vector<InternId> ids;
+        ids.reserve(header.texts);
+        for(std::size_t i = 0; i < header.texts; ++i) {
+            ids.emplace_back(intern({characters.data() + text_bounds[i], text_bounds[i + 1] - text_bounds[i]}));
+        }
+
+        script.tokens.reserve(records.size());
+        for(auto& record : records) {
+            if(record.type > RIGHT_PARENS || (record.text != no_text && record.text >= ids.size())) {
+                return std::nullopt;
+            }
+            InternId id = record.text == no_text ? no_id : ids[record.text];
+            script.tokens.emplace_back(static_cast<TokenType>(record.type), record.offset, record.length, id, Number(record.real, record.imag));
+        }
+
+        return script;
+    } catch (kepler::Error&) {
+        return std::nullopt;
+    }
+}
+
+void kepler::store_script(const std::string& directory, const Source& source, const CompiledScript& script) {
+    // Number the texts of the tokens in order of first use.
+    std::unordered_map<InternId, std::uint32_t> texts;
+    std::vector<std::uint64_t> text_bounds = {0};
+    std::vector<Char> characters;
+    std::vector<TokenRecord> records;
+    records.reserve(script.tokens.size());
+
+    for(auto& token : script.tokens) {
+        std::uint32_t text = no_text;
+        if(token.id != no_id) {
+            auto [it, inserted] = texts.try_emplace(token.id, static_cast<std::uint32_t>(texts.size()));
+            if(inserted) {
+                auto& content = interned(token.id);
+                characters.insert(characters.end(), content.begin(), content.end());
+                text_bounds.emplace_back(characters.size());
+            }
+            text = it->second;
+        }
+        records.push_back({static_cast<std::uint32_t>(token.type), token.offset, token.length, text, token.value.real(), token.value.imag()});
+    }
+
+    Header header{magic, format_version, source.digest.high, source.digest.low, source.digest.size, script.starts.size(), records.size(), texts.size(), characters.size()};
+    std::vector<std::uint64_t> starts(script.starts.begin(), script.starts.end());
+    std::vector<std::uint64_t> bounds(script.bounds.begin(), script.bounds.end());
+
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    auto path = entry_path(directory, source.digest);
+    auto temporary = path;
+    temporary += ".tmp" + std::to_string(std::random_device()());
+
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if(!out.is_open()) {
+            return;
+        }
+        write(out, &header, 1);
+        write(out, starts.data(), starts.size());
+        write(out, bounds.data(), bounds.size());
+        write(out, records.data(), records.size());
+        write(out, text_bounds.data(), text_bounds.size());
+        write(out, characters.data(), characters.size());
+        if(!out) {
+            out.close();
+            std::filesystem::remove(temporary, error);
+            return;
+        }
+    }
+
+    std::filesystem::rename(temporary, path, error);
+    if(error) {
+        std::filesystem::remove(temporary, error);
+    }
+}
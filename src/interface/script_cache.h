@@ -0,0 +1,86 @@
+//
+// Copyright 2023 Nikolaj Banke Jensen.
+//
+// This file is part of Kepler.
+// 
+// Kepler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Kepler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License 
+// along with Kepler. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+#include "core/token.h"
+#include "interface/file_reader.h"
+
+namespace kepler {
+
+    /**
+     * The tokens of every statement of a source file, as kept in the script cache.
+     *
+     * Statements are found and tokenized as when the file is run, so the positions
+     * of their tokens are relative to the start of their statement.
+     */
+    struct CompiledScript {
+        // The offset in the source of the first character of each statement.
+        std::vector<std::size_t> starts;
+
+        // The index in 'tokens' of the first token of each statement, followed by the number of tokens.
+        std::vector<std::size_t> bounds = {0};
+
+        // The tokens of all statements, one statement after the other.
+        std::vector<Token> tokens;
+
+        /**
+         * Appends the tokens of a statement.
+         * @param start The offset in the source of the first character of the statement.
+         * @param statement The tokens of the statement.
+         */
+        void add(std::size_t start, const std::vector<Token>& statement);
+
+        /**
+         * Returns a copy of the tokens of the given statement.
+         * @param index The index of the statement.
+         * @return The tokens of the statement.
+         */
+        [[nodiscard]] std::vector<Token> statement(std::size_t index) const;
+    };
+
+    /**
+     * Loads the compiled form of the given source from the cache directory.
+     *
+     * Entries are keyed by the digest of the bytes of the source, which is also kept in the entry
+     * and compared with that of the given source, so a hit never reads the source again. They are
+     * also checked against the format of this interpreter, so an entry which is missing, stale,
+     * damaged or made for another source is simply not found.
+     *
+     * @param directory The cache directory.
+     * @param source The source which was compiled.
+     * @return The compiled script, if the cache holds a valid entry for the source.
+     */
+    std::optional<CompiledScript> load_script(const std::string& directory, const Source& source);
+
+    /**
+     * Stores the compiled form of the given source in the cache directory.
+     *
+     * The entry is written to a temporary file which then replaces any previous entry, so
+     * concurrent runs never see a partial entry. Failing to write the cache is not an error.
+     *
+     * @param directory The cache directory, which is created if needed.
+     * @param source The source which was compiled.
+     * @param script The compiled form of the source.
+     */
+    void store_script(const std::string& directory, const Source& source, const CompiledScript& script);
+};
@@ -0,0 +1,500 @@
+//
+// Copyright 2023 Nikolaj Banke Jensen.
+//
+// This file is part of Kepler.
+// 
+// Kepler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Kepler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License 
+// along with Kepler. If not, see <https://www.gnu.org/licenses/>.
+//
+#include "workspace.h"
+#include "file_reader.h"
+#include "core/error.h"
+#include "core/helpers.h"
+#include "core/literals.h"
+#include "core/memory.h"
+#include "core/evaluation/execution.h"
+#include "core/evaluation/parser.h"
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <type_traits>
+
+namespace {
+    // Marks the start of every workspace, and tells workspaces written with another byte order apart.
+    constexpr std::uint32_t magic = 0x574C504B;
+
+    // Raised whenever the layout of workspaces changes.
+    constexpr std::uint32_t format_version = 1;
+
+    // Alignment of the payloads, so their doubles can be used in place.
+    constexpr std::size_t payload_alignment = 64;
+    constexpr std::size_t number_alignment = alignof(double);
+
+    struct Header {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint64_t records_size;
+        std::uint64_t payload_offset;
+        std::uint64_t payload_size;
+    };
+
+    static_assert(std::is_trivially_copyable_v<Header>);
+
+    enum SymbolKind : std::uint8_t {
+        VariableKind,
+        FunctionKind,
+    };
+
+    // How the elements of an array are stored.
+    enum ArrayForm : std::uint8_t {
+        RealForm,
+        ComplexForm,
+        CharForm,
+        ElementForm,
+    };
+
+    enum ElementTag : std::uint8_t {
+        NumberTag,
+        CharTag,
+        ArrayTag,
+    };
+
+    constexpr std::uint32_t no_content = std::numeric_limits<std::uint32_t>::max();
+
+    std::size_t align(std::size_t offset, std::size_t alignment) {
+        return (offset + alignment - 1) / alignment * alignment;
+    }
+
+    kepler::Error damaged() {
+        return {kepler::FileError, "The workspace is damaged."};
+    }
+
+    /**
+     * Writes the records of a workspace, and the payloads of the numbers they refer to.
+     */
+    class Writer {
+    public:
+        std::string records;
+        std::string payload;
+
+        template<typename T>
+        void put(const T& value) {
+            records.append(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        void put(const kepler::String& string) {
+            put(static_cast<std::uint32_t>(string.size()));
+            records.append(reinterpret_cast<const char*>(string.data()), string.size() * sizeof(kepler::Char));
+        }
+
+        void put(const kepler::Array& array) {
+            put(static_cast<std::uint32_t>(array.shape.size()));
+            for(auto dim : array.shape) {
+                put(static_cast<std::uint32_t>(dim));
+            }
+
+            // Scalars and empty arrays are rare and small, so they always store their elements.
+            if(array.rank() > 0 && !array.data.empty()) {
+                if(auto numbers = array.data.numbers()) {
+                    put_numbers(numbers->doubles(), numbers->size(), numbers->is_complex());
+                    return;
+                } else if(auto text = array.data.text()) {
+                    put(CharForm);
+                    put(text->to_string());
+                    return;
+                } else if(put_simple(array)) {
+                    return;
+                }
+            }
+
+            put(ElementForm);
+            for(auto& element : array.data) {
+                put_element(element);
+            }
+        }
+
+    private:
+        void put_numbers(const double* doubles, std::size_t count, bool complex) {
+            payload.resize(align(payload.size(), number_alignment));
+            put(complex ? ComplexForm : RealForm);
+            put(static_cast<std::uint64_t>(payload.size()));
+            payload.append(reinterpret_cast<const char*>(doubles), count * (complex ? 2 : 1) * sizeof(double));
+        }
+
+        // Stores the elements of an array of simple scalars compactly, if they are all numbers or all characters.
+        bool put_simple(const kepler::Array& array) {
+            bool numbers = true;
+            bool chars = true;
+            bool complex = false;
+            for(auto& element : array.data) {
+                auto scalar = std::get_if<kepler::Array>(&element);
+                if(!scalar || !scalar->is_scalar()) {
+                    return false;
+                }
+                if(auto number = std::get_if<kepler::Number>(&scalar->data[0])) {
+                    complex |= number->imag() != 0;
+                    chars = false;
+                } else if(std::holds_alternative<kepler::Char>(scalar->data[0])) {
+                    numbers = false;
+                } else {
+                    return false;
+                }
+            }
+
+            if(numbers) {
+                std::vector<double> doubles;
+                doubles.reserve(array.data.size() * (complex ? 2 : 1));
+                for(auto& element : array.data) {
+                    auto& number = std::get<kepler::Number>(std::get<kepler::Array>(element).data[0]);
+                    doubles.emplace_back(number.real());
+                    if(complex) {
+                        doubles.emplace_back(number.imag());
+                    }
+                }
+                put_numbers(doubles.data(), array.data.size(), complex);
+                return true;
+            } else if(chars) {
+                kepler::String string;
+                string.reserve(array.data.size());
+                for(auto& element : array.data) {
+                    string.push_back(std::get<kepler::Char>(std::get<kepler::Array>(element).data[0]));
+                }
+                put(CharForm);
+                put(string);
+                return true;
+            }
+            return false;
+        }
+
+        void put_element(const kepler::Array::element_type& element) {
+            if(auto number = std::get_if<kepler::Number>(&element)) {
+                put(NumberTag);
+                put(number->real());
+                put(number->imag());
+            } else if(auto c = std::get_if<kepler::Char>(&element)) {
+                put(CharTag);
+                put(static_cast<std::uint32_t>(*c));
+            } else {
+                put(ArrayTag);
+                put(std::get<kepler::Array>(element));
+            }
+        }
+    };
+
+    /**
+     * Reads the records of a workspace in order, failing once a record would extend past their end.
+     */
+    class Reader {
+    private:
+        std::string_view records;
+        std::string_view payload;
+        std::shared_ptr<const kepler::FileBytes> file;
+        std::size_t cursor = 0;
+
+        // Guards against stack exhaustion when reading damaged, deeply nested arrays.
+        static constexpr int max_depth = 10000;
+        int depth = 0;
+
+    public:
+        Reader(std::string_view records_, std::string_view payload_, std::shared_ptr<const kepler::FileBytes> file_)
+            : records(records_), payload(payload_), file(std::move(file_)) {}
+
+        template<typename T>
+        T get() {
+            T value;
+            if(sizeof(T) > records.size() - cursor) {
+                throw damaged();
+            }
+            std::memcpy(&value, records.data() + cursor, sizeof(T));
+            cursor += sizeof(T);
+            return value;
+        }
+
+        kepler::String get_string() {
+            return get_string(get<std::uint32_t>());
+        }
+
+        kepler::String get_string(std::uint32_t size) {
+            if(size > (records.size() - cursor) / sizeof(kepler::Char)) {
+                throw damaged();
+            }
+            kepler::String string(size, 0);
+            std::memcpy(string.data(), records.data() + cursor, size * sizeof(kepler::Char));
+            cursor += size * sizeof(kepler::Char);
+            return string;
+        }
+
+        kepler::Array get_array() {
+            if(++depth > max_depth) {
+                throw damaged();
+            }
+
+            auto rank = get<std::uint32_t>();
+            if(rank > (records.size() - cursor) / sizeof(std::uint32_t)) {
+                throw damaged();
+            }
+            std::vector<unsigned int> shape(rank);
+            std::size_t count = 1;
+            for(auto& dim : shape) {
+                dim = get<std::uint32_t>();
+                if(dim != 0 && count > std::numeric_limits<std::uint32_t>::max() / dim) {
+                    throw damaged();
+                }
+                count *= dim;
+            }
+
+            kepler::Array array = {std::move(shape), {}};
+            auto form = get<std::uint8_t>();
+            if(form == RealForm || form == ComplexForm) {
+                array.data = kepler::Storage<kepler::Array::element_type>(get_numbers(count, form == ComplexForm));
+            } else if(form == CharForm) {
+                auto string = get_string();
+                if(string.size() != count) {
+                    throw damaged();
+                }
+                array.data = kepler::Storage<kepler::Array::element_type>(kepler::Text(string));
+            } else if(form == ElementForm) {
+                // Every element takes up at least a byte, which bounds the allocation by the size of the file.
+                if(count > records.size() - cursor) {
+                    throw damaged();
+                }
+                auto& elements = array.data.mutate();
+                elements.reserve(count);
+                for(std::size_t i = 0; i < count; ++i) {
+                    elements.emplace_back(get_element());
+                }
+            } else {
+                throw damaged();
+            }
+
+            --depth;
+            return array;
+        }
+
+        [[nodiscard]] bool finished() const {
+            return cursor == records.size();
+        }
+
+    private:
+        kepler::Numbers get_numbers(std::size_t count, bool complex) {
+            auto offset = get<std::uint64_t>();
+            auto size = count * (complex ? 2 : 1) * sizeof(double);
+            if(offset > payload.size() || size > payload.size() - offset) {
+                throw damaged();
+            }
+
+            // The numbers are used from the file, which they keep alive, and copied only once they are written.
+            // Workspaces are saved by replacing the file rather than writing into it, so a save never changes them.
+            auto data = payload.data() + offset;
+            if(reinterpret_cast<std::uintptr_t>(data) % number_alignment == 0) {
+                return {file, reinterpret_cast<const double*>(data), count, complex};
+            }
+
+            // The file was read into a buffer without the alignment of doubles, so the numbers are copied.
+            auto copy = std::make_shared<std::vector<double, kepler::memory::Allocator<double>>>(size / sizeof(double));
+            std::memcpy(copy->data(), data, size);
+            return {copy, copy->data(), count, complex};
+        }
+
+        kepler::Array::element_type get_element() {
+            auto tag = get<std::uint8_t>();
+            if(tag == NumberTag) {
+                auto real = get<double>();
+                auto imag = get<double>();
+                return kepler::Number(real, imag);
+            } else if(tag == CharTag) {
+                return static_cast<kepler::Char>(get<std::uint32_t>());
+            } else if(tag == ArrayTag) {
+                return get_array();
+            }
+            throw damaged();
+        }
+    };
+}
+
+std::size_t kepler::save_workspace(const SymbolTable& symbol_table, const std::string& path) {
+    Writer writer;
+    std::uint32_t count = 0;
+    writer.put(count);
+
+    for(auto& [id, symbol] : symbol_table.symbols()) {
+        if(id.starts_with(constants::recursive_call_id) || !symbol->content.has_value()) {
+            continue;
+        }
+
+        if(auto array = std::get_if<Array>(&symbol->content.value())) {
+            writer.put(VariableKind);
+            writer.put(id);
+            writer.put(*array);
+        } else if(!symbol->definition.empty()) {
+            writer.put(FunctionKind);
+            writer.put(id);
+            writer.put(static_cast<std::uint32_t>(symbol->definition.size()));
+            for(auto& token : symbol->definition) {
+                writer.put(static_cast<std::uint32_t>(token.type));
+                writer.put(token.value.real());
+                writer.put(token.value.imag());
+                if(token.id == no_id) {
+                    writer.put(no_content);
+                } else {
+                    writer.put(token.content());
+                }
+            }
+        } else {
+            // Functions which were not defined by an expression, such as those of the system, are not saved.
+            continue;
+        }
+        ++count;
+    }
+    std::memcpy(writer.records.data(), &count, sizeof(count));
+
+    auto payload_offset = align(sizeof(Header) + writer.records.size(), payload_alignment);
+    Header header{magic, format_version, writer.records.size(), payload_offset, writer.payload.size()};
+
+    // Write to a temporary file first, so a failed save never leaves a damaged workspace behind.
+    std::error_code error;
+    std::filesystem::path temporary = path;
+    temporary += ".tmp" + std::to_string(std::random_device()());
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if(!out.is_open()) {
+            throw kepler::Error(FileError, "Could not write the workspace.");
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(writer.records.data(), static_cast<std::streamsize>(writer.records.size()));
+        std::string padding(payload_offset - sizeof(Header) - writer.records.size(), '\0');
+        out.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+        out.write(writer.payload.data(), static_cast<std::streamsize>(writer.payload.size()));
+        if(!out) {
+            out.close();
+            std::filesystem::remove(temporary, error);
+            throw kepler::Error(FileError, "Could not write the workspace.");
+        }
+    }
+
+    std::filesystem::rename(temporary, path, error);
+    if(error) {
+        std::filesystem::remove(temporary, error);
+        throw kepler::Error(FileError, "Could not write the workspace.");
+    }
+    return count;
+}
+
+std::size_t kepler::load_workspace(SymbolTable& symbol_table, const std::string& path, std::ostream& stream) {
+    auto file = std::make_shared<const FileBytes>(path);
+    auto bytes = file->view();
+
+    Header header{};
+    if(bytes.size() < sizeof(Header)) {
+        throw damaged();
+    }
+    std::memcpy(&header, bytes.data(), sizeof(Header));
+    if(header.magic != magic || header.version != format_version) {
+        throw kepler::Error(FileError, "The file is not a workspace of this version of Kepler.");
+    }
+    if(header.records_size > bytes.size() - sizeof(Header) || header.payload_offset < sizeof(Header) + header.records_size
+       || header.payload_offset > bytes.size() || header.payload_size != bytes.size() - header.payload_offset) {
+        throw damaged();
+    }
+
+    Reader reader(bytes.substr(sizeof(Header), header.records_size), bytes.substr(header.payload_offset), file);
+
+    // Read the whole workspace before defining anything, so a damaged workspace leaves the table untouched.
+    std::vector<std::pair<String, Array>> variables;
+    std::vector<std::pair<String, std::vector<Token>>> functions;
+    auto count = reader.get<std::uint32_t>();
+    for(std::uint32_t i = 0; i < count; ++i) {
+        auto kind = reader.get<std::uint8_t>();
+        auto id = reader.get_string();
+        if(id.empty()) {
+            throw damaged();
+        }
+
+        if(kind == VariableKind) {
+            auto value = reader.get_array();
+            if(id.starts_with(U'⎕')) {
+                helpers::check_valid_system_param_value(id, value);
+            }
+            variables.emplace_back(std::move(id), std::move(value));
+        } else if(kind == FunctionKind) {
+            auto size = reader.get<std::uint32_t>();
+            std::vector<Token> definition;
+            for(std::uint32_t j = 0; j < size; ++j) {
+                auto type = reader.get<std::uint32_t>();
+                auto real = reader.get<double>();
+                auto imag = reader.get<double>();
+                if(type > RIGHT_PARENS) {
+                    throw damaged();
+                }
+
+                auto length = reader.get<std::uint32_t>();
+                InternId content = length == no_content ? no_id : intern(reader.get_string(length));
+                definition.emplace_back(static_cast<TokenType>(type), 0, 0, content, Number(real, imag));
+            }
+            functions.emplace_back(std::move(id), std::move(definition));
+        } else {
+            throw damaged();
+        }
+    }
+    if(!reader.finished()) {
+        throw damaged();
+    }
+
+    // Functions are defined by executing the assignments which defined them when they were saved.
+    std::vector<std::vector<Token>> assignments;
+    for(auto& [id, definition] : functions) {
+        std::vector<Token> tokens = {Token(END, -1, 0), Token(ID, id), Token(ASSIGNMENT, U"←")};
+        tokens.insert(tokens.end(), definition.begin(), definition.end());
+        assignments.emplace_back(std::move(tokens));
+    }
+
+    // Parse every assignment against a table holding the loaded names, before anything is defined,
+    // so a definition which does not parse leaves the table untouched.
+    auto& root = symbol_table.root();
+    {
+        SymbolTable staging(&root);
+        for(auto& [id, value] : variables) {
+            staging.set(id, value, true);
+        }
+        for(auto& [id, definition] : functions) {
+            staging.bind_function(id);
+        }
+        for(auto& tokens : assignments) {
+            Parser parser;
+            parser.use_table(&staging);
+            try {
+                delete parser.parse(tokens);
+            } catch(kepler::Error&) {
+                throw damaged();
+            }
+        }
+    }
+
+    for(auto& [id, value] : variables) {
+        root.set(id, value);
+    }
+
+    // Functions may call each other, so every name must be known as a function before any is defined.
+    for(auto& [id, definition] : functions) {
+        root.bind_function(id);
+    }
+    for(auto& tokens : assignments) {
+        immediate_execution(tokens, stream, false, &root);
+    }
+
+    return variables.size() + functions.size();
+}
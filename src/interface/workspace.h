@@ -0,0 +1,58 @@
+//
+// Copyright 2023 Nikolaj Banke Jensen.
+//
+// This file is part of Kepler.
+// 
+// Kepler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Kepler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License 
+// along with Kepler. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include "core/symbol_table.h"
+
+namespace kepler {
+
+    /**
+     * Saves the variables and functions of a SymbolTable to a workspace file.
+     *
+     * Variables are saved with their values, and functions with the tokens which defined them.
+     * The elements of arrays of simple numbers are laid out as aligned payloads, which are
+     * used directly from the mapped file when the workspace is loaded. The file is written
+     * under a temporary name and then renamed, so saving never changes a file in use.
+     *
+     * @param symbol_table The SymbolTable to save.
+     * @param path The path of the workspace file, which is replaced if it exists.
+     * @return The number of variables and functions saved.
+     * @throws Error if the file could not be written.
+     */
+    std::size_t save_workspace(const SymbolTable& symbol_table, const std::string& path);
+
+    /**
+     * Loads the variables and functions of a workspace file into a SymbolTable.
+     *
+     * Ids which are already defined are replaced. Arrays of simple numbers keep referring
+     * to the mapped file, and are only copied into elements when they are first accessed.
+     * The whole workspace is read, and every function parsed, before anything is defined,
+     * so a workspace which fails to load leaves the SymbolTable unchanged.
+     *
+     * @param symbol_table The SymbolTable to load into.
+     * @param path The path of the workspace file.
+     * @param stream The output stream of the loaded functions.
+     * @return The number of variables and functions loaded.
+     * @throws Error if the file could not be read, or is not a workspace of this version.
+     */
+    std::size_t load_workspace(SymbolTable& symbol_table, const std::string& path, std::ostream& stream);
+};
@@ -1,10 +1,14 @@
 
 #include <iostream>
+#include <optional>
 #include <catch2/catch_session.hpp>
 #include <lyra/lyra.hpp>
 #include "cli.h"
 #include "core/evaluation/execution.h"
+#include "core/evaluation/profiler.h"
+#include "core/evaluation/sampler.h"
 #include "core/literals.h"
+#include "core/memory.h"
 
 using namespace kepler;
 
@@ -19,6 +23,27 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
+    profiler::Format profile_format;
+    bool profiling = !kepler::cli::config.profile_format.empty();
+    if(profiling && !profiler::parse_format(kepler::cli::config.profile_format, profile_format)) {
+        std::cerr << "Error in command line: unknown profile format '" << kepler::cli::config.profile_format << "'." << std::endl;
+        return 1;
+    } else if(profiling) {
+        profiler::start();
+    }
+
+    if(kepler::cli::config.report_memory) {
+        memory::start();
+    }
+    memory::set_limit(kepler::cli::config.workspace_limit);
+
+    sampler::Format sample_format;
+    bool sampling = !kepler::cli::config.sample_format.empty();
+    if(sampling && !sampler::parse_format(kepler::cli::config.sample_format, sample_format)) {
+        std::cerr << "Error in command line: unknown sample format '" << kepler::cli::config.sample_format << "'." << std::endl;
+        return 1;
+    }
+
     if(kepler::cli::config.show_help) {
         // Show help.
         std::cout << kepler::cli::cli << "\n";
@@ -33,9 +58,38 @@ int main(int argc, char* argv[]) {
     } else if(kepler::cli::config.commands.empty()) {
         // Run REPL.
         run_repl();
+        if(profiling) {
+            std::cerr << profiler::report(profile_format) << std::endl;
+        }
+        if(kepler::cli::config.report_memory) {
+            std::cerr << memory::report() << std::endl;
+        }
     } else if(kepler::cli::config.commands.size() == 1) {
         // Run file.
-        return run_file(kepler::cli::config.commands[0]);
+        // The source is read before running, as the report needs it and run_file reports its errors itself.
+        std::optional<Source> sampled;
+        if(sampling) {
+            try {
+                sampled = read_file(kepler::cli::config.commands[0]);
+            } catch (kepler::Error&) {
+                sampled.reset();
+            }
+            sampler::start();
+        }
+        int status = run_file(kepler::cli::config.commands[0], std::cout, kepler::cli::config.cache_directory);
+        if(profiling) {
+            std::cerr << profiler::report(profile_format) << std::endl;
+        }
+        if(sampling) {
+            sampler::stop();
+            if(sampled) {
+                std::cerr << sampler::report(sample_format, *sampled) << std::endl;
+            }
+        }
+        if(kepler::cli::config.report_memory) {
+            std::cerr << memory::report() << std::endl;
+        }
+        return status;
     } else {
         std::cerr << "Command error: only one file can be specified." << std::endl;
     }
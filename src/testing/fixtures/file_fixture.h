@@ -36,4 +36,16 @@ protected:
         kepler::run_file(path, ss);
         return ss.str();
     }
+
+    /**
+     * Runs the given Kepler file, using the given directory as its script cache.
+     * @param path The path to the file to run.
+     * @param cache_directory The directory of the script cache.
+     * @return The output of the file.
+     */
+    std::string run(std::string&& path, const std::string& cache_directory) {
+        std::stringstream ss;
+        kepler::run_file(path, ss, cache_directory);
+        return ss.str();
+    }
 };
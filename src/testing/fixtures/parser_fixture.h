@@ -64,9 +64,26 @@ protected:
 
             kepler::Parser parser;
             parser.use_table(&symbol_table);
-            return parser.parse(tokens)->to_string();
+            return parser.parse(tokens, &input)->to_string();
         } catch(kepler::Error& err) {
             return err.to_string();
         }
     }
+
+    /**
+     * Runs the parser on the given input.
+     * @param raw The input to parse.
+     * @return The AST.
+     */
+    kepler::Statements* parse(std::string&& raw) {
+        kepler::String converted = uni::utf8to32u(raw);
+        std::vector<kepler::Char> input(converted.begin(), converted.end());
+
+        kepler::Tokenizer tokenizer;
+        auto tokens = tokenizer.tokenize(&input);
+
+        kepler::Parser parser;
+        parser.use_table(&symbol_table);
+        return parser.parse(tokens, &input);
+    }
 };
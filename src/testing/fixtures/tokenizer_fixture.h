@@ -38,6 +38,12 @@ protected:
         std::vector<kepler::Char> input(converted.begin(), converted.end());
         kepler::Tokenizer tokenizer;
         std::vector<kepler::Token> output = tokenizer.tokenize(&input);
+        for(auto& token : output) {
+            // Strings are not interned, so their contents are interned here to compare them.
+            if(token.type == kepler::STRING) {
+                token.id = kepler::intern(token.content(&input));
+            }
+        }
         return output;
     }
 };
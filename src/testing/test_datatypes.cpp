@@ -21,6 +21,9 @@
 #include "testing/fixtures/general_fixture.h"
 #include "matcher.h"
 #include "core/error_type.h"
+#include "core/array.h"
+#include "core/memory.h"
+#include <algorithm>
 
 TEST_CASE_METHOD(GeneralFixture, "numbers", "[numbers][datatypes]") {
     CHECK_THAT(run("0"), Prints("0"));
@@ -40,6 +43,21 @@ TEST_CASE_METHOD(GeneralFixture, "numbers", "[numbers][datatypes]") {
     CHECK_THAT(run("1E9J¯2"), Prints("1000000000J¯2"));
     CHECK_THAT(run("(((((((((1.923J2.3E9)))))))))"), Prints("1.923J2300000000"));
 
+    CHECK_THAT(run(".5 5. ¯.25"), Prints("0.5 5 ¯0.25"));
+    CHECK_THAT(run("123456789012345678"), Prints("1.23456789E17"));
+    CHECK_THAT(run("12345678901234567890"), Prints("1.23456789E19"));
+    CHECK_THAT(run("¯2.5E¯3J¯.5"), Prints("¯0.0025J¯0.5"));
+    CHECK_THAT(run("1E¯400"), Prints("0"));
+    CHECK_THAT(run("1E400"), Throws(kepler::DomainError));
+
+    CHECK_THAT(run("1.5E¯5 ¯1.5E¯5 1E¯10"), Prints("0.000015 ¯0.000015 1E¯10"));
+    CHECK_THAT(run("¯0 ¯1.25E¯300J2"), Prints("0 ¯1.25E¯300J2"));
+    CHECK_THAT(run("⎕PP←3 ◊ 3.14159 1234.5 ¯0.0012345"), Prints("3.14 1.23E3 ¯0.00123"));
+    CHECK_THAT(run("2 2⍴1 ¯1 10 1"), Prints(" 1 ¯1\n"
+                                           "10  1"));
+    CHECK_THAT(run("2 2⍴0.5 100 ¯2.25 3"), Prints("  0.5 100\n"
+                                                 "¯2.25   3"));
+
     // Many more corner cases (and negative tests) are in test_lexer.cpp.
 }
 
@@ -48,6 +66,24 @@ TEST_CASE_METHOD(GeneralFixture, "strings", "[strings][datatypes]") {
     CHECK_THAT(run("'Hello, World!!!'"), Prints("Hello, World!!!"));
     CHECK_THAT(run("'1E9J¯2'"), Prints("1E9J¯2"));
     CHECK_THAT(run("'3 3⍴10 12 14'"), Prints("3 3⍴10 12 14"));
+    CHECK_THAT(run("⍴'abc'"), Prints("3"));
+    CHECK_THAT(run("⍴⍴'a'"), Prints("0"));
+    CHECK_THAT(run("2 3⍴'abcdef'"), Prints("abc\n"
+                                           "def"));
+    CHECK_THAT(run("1 'a' 2"), Prints("1 a 2"));
+    CHECK_THAT(run("'héllo→𝔸'"), Prints("héllo→𝔸"));
+    CHECK_THAT(run("⌽'héllo→𝔸'"), Prints("𝔸→olléh"));
+    CHECK_THAT(run("'abc' 'de'"), Prints("┌───┬──┐\n"
+                                         "│abc│de│\n"
+                                         "└───┴──┘"));
+
+    // Reading compactly stored characters does not box them one by one.
+    kepler::Array text(kepler::Text(kepler::String(100000, U'a')));
+    auto held = kepler::memory::usage().live;
+    CHECK(std::count(text.data.begin(), text.data.end(), text.data[0]) == 100000);
+    CHECK(text.data.back() == kepler::Array::element_type(kepler::Array{U'a'}));
+    CHECK(kepler::memory::usage().live < held + 100000);
+    CHECK(text.data.text() != nullptr);
 }
 
 TEST_CASE_METHOD(GeneralFixture, "arrays", "[arrays][datatypes]") {
@@ -73,4 +109,31 @@ TEST_CASE_METHOD(GeneralFixture, "arrays", "[arrays][datatypes]") {
                                                                          "│ ││ │└─┴────┴─────┴─┘│              ││\n"
                                                                          "│ │└─┴────────────────┴──────────────┘│\n"
                                                                          "└─┴───────────────────────────────────┘"));
+    CHECK_THAT(run("(2 2⍴⍳4) 'ab'"), Prints("┌───┬──┐\n"
+                                            "│1 2│ab│\n"
+                                            "│3 4│  │\n"
+                                            "└───┴──┘"));
+    CHECK_THAT(run("(⍳0) 1 '│'"), Prints("┌┬─┬─┐\n"
+                                         "││1│││\n"
+                                         "└┴─┴─┘"));
+    CHECK_THAT(run("2 2 2⍴(1 2) 3"), Prints("┌───┬─┐\n"
+                                            "│1 2│3│\n"
+                                            "├───┼─┤\n"
+                                            "│1 2│3│\n"
+                                            "└───┴─┘\n"
+                                            "\n"
+                                            "┌───┬─┐\n"
+                                            "│1 2│3│\n"
+                                            "├───┼─┤\n"
+                                            "│1 2│3│\n"
+                                            "└───┴─┘"));
+
+    // Literal vectors are shared between evaluations, so they must be unaffected by what is computed from them.
+    CHECK_THAT(run("f←{⌽⍵ 1 2 3} ◊ (f 0) (f 4)"), Prints("┌───────┬───────┐\n"
+                                                       "│3 2 1 0│3 2 1 4│\n"
+                                                       "└───────┴───────┘"));
+    CHECK_THAT(run("({⍵+1 2 3}⍣3) 0"), Prints("3 6 9"));
+    CHECK_THAT(run("x←1 2 (3 4) ◊ y←-x ◊ x"), Prints("┌─┬─┬───┐\n"
+                                                    "│1│2│3 4│\n"
+                                                    "└─┴─┴───┘"));
 }
\ No newline at end of file
@@ -21,6 +21,15 @@
 #include "matcher.h"
 #include "core/error_type.h"
 #include "testing/fixtures/file_fixture.h"
+#include "core/evaluation/sampler.h"
+#include "core/memory.h"
+#include "interface/script_cache.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <regex>
+#include <thread>
+#include <sstream>
 
 TEST_CASE_METHOD(FileFixture, "files", "[files]") {
     CHECK_THAT(run("../src/testing/files/degrees.kpl"), Prints("20"));
@@ -28,6 +37,11 @@ TEST_CASE_METHOD(FileFixture, "files", "[files]") {
     CHECK_THAT(run("../src/testing/files/error_degrees.kpl"), Throws(kepler::SyntaxError));
     CHECK_THAT(run("../src/testing/files/non_existent_file.kpl"), Throws(kepler::FileError));
 
+    CHECK_THAT(run("../src/testing/files/unicode.kpl"), Prints("𝔸→olléh"));
+    CHECK_THAT(run("../src/testing/files/partial.kpl"), Throws(kepler::SyntaxError));
+    CHECK(run("../src/testing/files/partial.kpl").starts_with("before42"));
+    CHECK(run("../src/testing/files/unterminated.kpl").find("unterminated.kpl:3: SYNTAX ERROR") != std::string::npos);
+
     CHECK_THAT(run("../src/testing/files/fib.kpl"), Prints("34"));
     CHECK_THAT(run("../src/testing/files/fact.kpl"), Prints("Factorial of 8:\n40320"));
     CHECK_THAT(run("../src/testing/files/mandelbrot.kpl"), Prints("1 1 1 1 1 1 1\n"
@@ -114,6 +128,33 @@ TEST_CASE_METHOD(GeneralFixture, "System variables", "[system-variables]") {
     CHECK_THAT(run("⎕PP←0"), Throws(kepler::LimitError));
     CHECK_THAT(run("⎕PP←¯3"), Throws(kepler::LimitError));
     CHECK_THAT(run("⎕PP←¯100"), Throws(kepler::LimitError));
+
+    CHECK_THAT(run("⎕PW←30"), Prints(""));
+    CHECK_THAT(run("⎕PW←32767"), Prints(""));
+    CHECK_THAT(run("⎕PW←29"), Throws(kepler::LimitError));
+    CHECK_THAT(run("⎕PW←32768"), Throws(kepler::LimitError));
+    CHECK_THAT(run("⎕PW←40.5"), Throws(kepler::LimitError));
+}
+
+TEST_CASE_METHOD(GeneralFixture, "Print limits", "[print-limits]") {
+    CHECK_THAT(run("⎕PW←30 ◊ ⍳100"), Prints("1 2 3 4 5 6 7 8 9 10 11 12 13…"));
+    CHECK_THAT(run("⎕←⍳100"), Prints("1 2 3 4 5 6 7 8 9 10 11 12 13…"));
+    CHECK_THAT(run("⍳12"), Prints("1 2 3 4 5 6 7 8 9 10 11 12"));
+    CHECK_THAT(run("2 40⍴'ab'"), Prints("ababababababababababababababa…\n"
+                                         "ababababababababababababababa…"));
+    CHECK_THAT(run("2 40⍴'é'"), Prints("ééééééééééééééééééééééééééééé…\n"
+                                        "ééééééééééééééééééééééééééééé…"));
+    CHECK_THAT(run("(⍳20) 1"), Prints("┌────────────────────────────…\n"
+                                      "│1 2 3 4 5 6 7 8 9 10 11 12 1…\n"
+                                      "└────────────────────────────…"));
+
+    std::string rows;
+    for(int i = 0; i < 1000; ++i) {
+        rows += "7\n";
+    }
+    rows += "…";
+    CHECK_THAT(run("2000 1⍴7"), Prints(rows));
+    CHECK_THAT(run("1000 1⍴7"), Prints(rows.substr(0, rows.size() - 4)));
 }
 
 TEST_CASE_METHOD(GeneralFixture, "Index origin", "[index-origin]") {
@@ -185,3 +226,414 @@ TEST_CASE_METHOD(GeneralFixture, "user-defined-functions", "[user-defined-functi
     CHECK_THAT(run("0 k 0"), Prints(""));
     CHECK_THAT(run("⎕IO"), Prints("0"));
 }
+
+TEST_CASE_METHOD(GeneralFixture, "Workspaces", "[workspaces]") {
+    auto path = (std::filesystem::temp_directory_path() / "kepler-workspace-test.kws").string();
+    std::filesystem::remove(path);
+
+    CHECK_THAT(run("numbers←2 3⍴⍳6"), Prints(""));
+    CHECK_THAT(run("complex←1J2 3 ¯4.5"), Prints(""));
+    CHECK_THAT(run("text←'Hello, 𝔸!'"), Prints(""));
+    CHECK_THAT(run("nested←1 'ab' (2 (3 4))"), Prints(""));
+    auto nested = run("nested");
+    CHECK_THAT(run("scalar←42"), Prints(""));
+    CHECK_THAT(run("half←{⍵÷2}"), Prints(""));
+    CHECK_THAT(run("quarter←{half half ⍵}"), Prints(""));
+    CHECK_THAT(run("label←{⌽'quarter'}"), Prints(""));
+    CHECK_THAT(run("⎕PP←3"), Prints(""));
+    CHECK_THAT(run("⎕SAVE '" + path + "'"), Prints("11"));
+
+    symbol_table.clear();
+    symbol_table.insert_system_parameters();
+    CHECK_THAT(run("numbers"), Throws(kepler::DefinitionError));
+    CHECK_THAT(run("⎕PP"), Prints("10"));
+
+    // ⎕IO, ⎕PP and ⎕PW are saved along with the variables and functions.
+    CHECK_THAT(run("⎕LOAD '" + path + "'"), Prints("11"));
+    CHECK_THAT(run("numbers"), Prints("1 2 3\n4 5 6"));
+    CHECK_THAT(run("numbers+1"), Prints("2 3 4\n5 6 7"));
+    CHECK_THAT(run("complex"), Prints("1J2 3 ¯4.5"));
+    CHECK_THAT(run("text"), Prints("Hello, 𝔸!"));
+    CHECK(run("nested") == nested);
+    CHECK_THAT(run("scalar"), Prints("42"));
+    CHECK_THAT(run("⍴⍴scalar"), Prints("0"));
+    CHECK_THAT(run("⎕PP"), Prints("3"));
+    CHECK_THAT(run("quarter 1"), Prints("0.25"));
+    CHECK_THAT(run("label 0"), Prints("retrauq"));
+    CHECK_THAT(run("÷3"), Prints("0.333"));
+
+    // Loading again replaces the values of the variables.
+    CHECK_THAT(run("numbers←0"), Prints(""));
+    CHECK_THAT(run("⎕LOAD '" + path + "'"), Prints("11"));
+    CHECK_THAT(run("numbers"), Prints("1 2 3\n4 5 6"));
+
+    // Loaded numbers are used from the file, which saving replaces rather than writes into.
+    CHECK_THAT(run("kept←numbers"), Prints(""));
+    CHECK_THAT(run("numbers←7"), Prints(""));
+    CHECK_THAT(run("⎕SAVE '" + path + "'"), Prints("12"));
+    CHECK_THAT(run("kept"), Prints("1 2 3\n4 5 6"));
+    CHECK_THAT(run("complex"), Prints("1J2 3 ¯4.5"));
+
+    // A function which does not parse is rejected before anything is defined.
+    std::string bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    // The content of a token is preceded by its length, and by its type and value.
+    std::uint32_t content[] = {1, U'÷'};
+    auto divide = bytes.find(std::string(reinterpret_cast<const char*>(content), sizeof(content)));
+    CHECK(divide != std::string::npos);
+    if(divide != std::string::npos) {
+        auto type = static_cast<std::uint32_t>(kepler::RIGHT_PARENS);
+        std::memcpy(bytes.data() + divide - 2 * sizeof(double) - sizeof(type), &type, sizeof(type));
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << bytes;
+
+        CHECK_THAT(run("numbers←0"), Prints(""));
+        CHECK_THAT(run("⎕LOAD '" + path + "'"), Throws(kepler::FileError));
+        CHECK_THAT(run("numbers"), Prints("0"));
+        CHECK_THAT(run("quarter 1"), Prints("0.25"));
+    }
+
+    // Loading numbers does not copy them.
+    auto large = path + ".large";
+    CHECK_THAT(run("large←⍳100000"), Prints(""));
+    CHECK_THAT(run("⎕SAVE '" + large + "'"), Prints("13"));
+    CHECK_THAT(run("large←0"), Prints(""));
+    auto held = kepler::memory::usage().live;
+    CHECK_THAT(run("⎕LOAD '" + large + "'"), Prints("13"));
+    CHECK(kepler::memory::usage().live < held + 100000 * sizeof(double) / 2);
+    CHECK_THAT(run("(⍴large)=100000"), Prints("1"));
+    std::filesystem::remove(large);
+
+    CHECK_THAT(run("⎕SAVE 1 2"), Throws(kepler::DomainError));
+    CHECK_THAT(run("⎕LOAD '" + path + ".missing'"), Throws(kepler::FileError));
+
+    // Damaged workspaces are rejected without changing the workspace.
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 8);
+    CHECK_THAT(run("⎕LOAD '" + path + "'"), Throws(kepler::FileError));
+    std::ofstream(path, std::ios::trunc) << "not a workspace";
+    CHECK_THAT(run("⎕LOAD '" + path + "'"), Throws(kepler::FileError));
+    CHECK_THAT(run("scalar"), Prints("42"));
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE_METHOD(GeneralFixture, "Binary files", "[binary-files]") {
+    auto path = (std::filesystem::temp_directory_path() / "kepler-binary-test.bin").string();
+    auto file = "'" + path + "'";
+
+    CHECK_THAT(run("(" + file + " 645) ⎕NWRITE 2 3⍴1.5 ¯2 3"), Prints("6"));
+    CHECK(std::filesystem::file_size(path) == 48);
+    CHECK_THAT(run("645 ⎕NREAD " + file), Prints("1.5 ¯2 3 1.5 ¯2 3"));
+    CHECK_THAT(run("645 3 2 ⎕NREAD " + file), Prints("1.5  ¯2\n  3 1.5\n ¯2   3"));
+    CHECK_THAT(run("+/645 ⎕NREAD " + file), Prints("5"));
+    CHECK_THAT(run("645 4 ⎕NREAD " + file), Throws(kepler::LengthError));
+
+    // Arrays read from a file are not changed by writing to it, and can be written back to it.
+    CHECK_THAT(run("x←645 ⎕NREAD " + file), Prints(""));
+    CHECK_THAT(run("(" + file + " 645) ⎕NWRITE 7 8 9 10"), Prints("4"));
+    CHECK_THAT(run("x"), Prints("1.5 ¯2 3 1.5 ¯2 3"));
+    CHECK_THAT(run("(" + file + " 645) ⎕NWRITE x"), Prints("6"));
+    CHECK_THAT(run("(" + file + " 645) ⎕NWRITE 645 ⎕NREAD " + file), Prints("6"));
+    CHECK(std::filesystem::file_size(path) == 48);
+    CHECK_THAT(run("645 ⎕NREAD " + file), Prints("1.5 ¯2 3 1.5 ¯2 3"));
+
+    // Numbers are read without copying them.
+    CHECK_THAT(run("(" + file + " 645) ⎕NWRITE (⍳100000)"), Prints("100000"));
+    auto held = kepler::memory::usage().live;
+    CHECK_THAT(run("y←645 ⎕NREAD " + file), Prints(""));
+    CHECK(kepler::memory::usage().live < held + 100000 * sizeof(double) / 2);
+    CHECK_THAT(run("+/y"), Prints("5000050000"));
+
+    CHECK_THAT(run("(" + file + " 323) ⎕NWRITE ¯1 0 2147483647"), Prints("3"));
+    CHECK(std::filesystem::file_size(path) == 12);
+    CHECK_THAT(run("323 ⎕NREAD " + file), Prints("¯1 0 2147483647"));
+    CHECK_THAT(run("643 ⎕NREAD " + file), Throws(kepler::LengthError));
+    CHECK_THAT(run("(" + file + " 323) ⎕NWRITE 2147483648"), Throws(kepler::DomainError));
+    CHECK_THAT(run("(" + file + " 323) ⎕NWRITE 1.5"), Throws(kepler::DomainError));
+
+    CHECK_THAT(run("(" + file + " 643) ⎕NWRITE 1E15 ¯7"), Prints("2"));
+    CHECK_THAT(run("643 ⎕NREAD " + file), Prints("1E15 ¯7"));
+
+    CHECK_THAT(run("(" + file + " 83) ⎕NWRITE 0 255 7"), Prints("3"));
+    CHECK_THAT(run("83 ⎕NREAD " + file), Prints("0 255 7"));
+    CHECK_THAT(run("83 0 ⎕NREAD " + file), Throws(kepler::LengthError));
+    CHECK_THAT(run("(" + file + " 83) ⎕NWRITE ¯1"), Throws(kepler::DomainError));
+
+    CHECK_THAT(run("(" + file + " 80) ⎕NWRITE 'abc'"), Prints("3"));
+    CHECK_THAT(run("80 ⎕NREAD " + file), Prints("abc"));
+    CHECK_THAT(run("(" + file + " 80) ⎕NWRITE '𝔸'"), Throws(kepler::DomainError));
+    CHECK_THAT(run("(" + file + " 320) ⎕NWRITE 2 2⍴'𝔸→'"), Prints("4"));
+    CHECK_THAT(run("320 2 2 ⎕NREAD " + file), Prints("𝔸→\n𝔸→"));
+    CHECK_THAT(run("(" + file + " 320) ⎕NWRITE 1 2"), Throws(kepler::DomainError));
+    CHECK_THAT(run("(" + file + " 645) ⎕NWRITE 'ab'"), Throws(kepler::DomainError));
+
+    CHECK_THAT(run("(" + file + " 645) ⎕NWRITE 1J2"), Throws(kepler::DomainError));
+    CHECK_THAT(run("(" + file + " 645) ⎕NWRITE 1 (2 3)"), Throws(kepler::DomainError));
+    CHECK_THAT(run("(" + file + " 12) ⎕NWRITE 1 2"), Throws(kepler::DomainError));
+    CHECK_THAT(run("645 ⎕NREAD '" + path + ".missing'"), Throws(kepler::FileError));
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE_METHOD(GeneralFixture, "CSV files", "[csv-files]") {
+    CHECK_THAT(run("1 ⎕CSV '../src/testing/files/table.tsv'"), Prints("┌─┬─┐\n│x│y│\n├─┼─┤\n│1│a│\n├─┼─┤\n│2│b│\n└─┴─┘"));
+    CHECK_THAT(run("1 1 ⎕CSV '../src/testing/files/table.tsv'"), Prints("┌─┬─┐\n│1│a│\n├─┼─┤\n│2│b│\n└─┴─┘"));
+    CHECK_THAT(run("⍴1 ⎕CSV '../src/testing/files/table.csv'"), Prints("5 4"));
+    CHECK_THAT(run("⍴1 1 ⎕CSV '../src/testing/files/table.csv'"), Prints("4 4"));
+
+    // Columns with a header are text, and without it those of numbers are numeric.
+    CHECK_THAT(run("c←0 1 ⎕CSV '../src/testing/files/table.csv'"), Prints(""));
+    CHECK_THAT(run("⍴c"), Prints("4"));
+    CHECK_THAT(run("1↑c"), Prints("┌───────────────────────────────────┐\n│┌───┬─────────────┬─────────┬─────┐│\n││Ada│Lovelace, Jr.│Says \"hi\"│Multi││\n││   │             │         │line ││\n│└───┴─────────────┴─────────┴─────┘│\n└───────────────────────────────────┘"));
+    CHECK_THAT(run("+/¨1↑⌽c"), Prints("2"));
+    CHECK_THAT(run("+/¨1↑1⌽c"), Prints("39"));
+
+    auto path = (std::filesystem::temp_directory_path() / "kepler-csv-test.csv").string();
+    auto file = "'" + path + "'";
+
+    // Large enough to be parsed in parallel, with rows which span lines.
+    {
+        std::ofstream out(path, std::ios::trunc);
+        for(int i = 0; i < 20000; ++i) {
+            out << i << ",\"a\nb,\"\"c\"\"\"," << 2 * i << "\n";
+        }
+    }
+    CHECK_THAT(run("⍴¨⎕CSV " + file), Prints("┌─────┬─────┬─────┐\n│20000│20000│20000│\n└─────┴─────┴─────┘"));
+    CHECK_THAT(run("+/¨1↑⎕CSV " + file), Prints("199990000"));
+    CHECK_THAT(run("+/¨1↑⌽⎕CSV " + file), Prints("399980000"));
+
+    std::ofstream(path, std::ios::trunc) << "1,2\n3\n";
+    CHECK_THAT(run("⎕CSV " + file), Throws(kepler::LengthError));
+    std::ofstream(path, std::ios::trunc) << "1,\"2\n";
+    CHECK_THAT(run("⎕CSV " + file), Throws(kepler::DomainError));
+    CHECK_THAT(run("2 ⎕CSV " + file), Throws(kepler::DomainError));
+    CHECK_THAT(run("⎕CSV '" + path + ".missing'"), Throws(kepler::FileError));
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE_METHOD(GeneralFixture, "Profiler", "[profiler]") {
+    CHECK_THAT(run("⎕PROFILE 'clear'"), Prints(""));
+    CHECK_THAT(run("f←{+/⍵×⍵}"), Prints(""));
+    CHECK_THAT(run("g←{f ⍵-1}"), Prints(""));
+    CHECK_THAT(run("g 1 2 3"), Prints("5"));
+    CHECK_THAT(run("⎕PROFILE 'text'"), Prints("     calls   inclusive ms   exclusive ms      elements         bytes  function"));
+
+    CHECK_THAT(run("⎕PROFILE 'start'"), Prints(""));
+    CHECK_THAT(run("g 1 2 3"), Prints("5"));
+    CHECK_THAT(run("g¨1 2"), Prints("0 1"));
+    CHECK_THAT(run("⎕PROFILE 'stop'"), Prints(""));
+    CHECK_THAT(run("g 1 2 3"), Prints("5"));
+
+    // Times vary between runs, so only the stacks and counts are checked.
+    std::vector<std::string> stacks;
+    std::stringstream folded(run("⎕PROFILE 'folded'"));
+    for(std::string line; std::getline(folded, line);) {
+        stacks.push_back(line.substr(0, line.rfind(' ')));
+    }
+    std::vector<std::string> expected = {"g", "g;-", "g;f", "g;f;+/", "g¨", "g¨;-", "g¨;f", "g¨;f;+/", "⎕PROFILE"};
+    CHECK(stacks == expected);
+
+    auto json = run("⎕PROFILE 'json'");
+    CHECK(json.starts_with("{\"functions\":["));
+    CHECK(json.find("{\"name\":\"f\",\"calls\":3,") != std::string::npos);
+    CHECK(json.find("{\"name\":\"-\",\"calls\":3,") != std::string::npos);
+    CHECK(json.find("{\"name\":\"g¨\",\"calls\":1,") != std::string::npos);
+    CHECK(run("⎕PROFILE 'text'").find("         3") != std::string::npos);
+
+    // The bytes of a call are those it allocated, not those it was passed or returned.
+    CHECK_THAT(run("⎕PROFILE 'clear'"), Prints(""));
+    CHECK_THAT(run("big←⍳100000"), Prints(""));
+    CHECK_THAT(run("⎕PROFILE 'start'"), Prints(""));
+    CHECK_THAT(run("⍴⍴big"), Prints("1"));
+    CHECK_THAT(run("+/⍳100000"), Prints("5000050000"));
+    CHECK_THAT(run("⎕PROFILE 'stop'"), Prints(""));
+    json = run("⎕PROFILE 'json'");
+    CHECK(json.find("{\"name\":\"⍴\",\"calls\":2,") != std::string::npos);
+    CHECK(json.find("\"bytes\":0}") != std::string::npos);
+    auto iota = json.find("{\"name\":\"⍳\"");
+    CHECK(iota != std::string::npos);
+    CHECK(std::stoull(json.substr(json.find("\"bytes\":", iota) + 8)) >= 100000 * sizeof(kepler::Array::element_type));
+
+    CHECK_THAT(run("⎕PROFILE 'clear'"), Prints(""));
+    CHECK_THAT(run("⎕PROFILE 'folded'"), Prints(""));
+    CHECK_THAT(run("⎕PROFILE 'restart'"), Throws(kepler::DomainError));
+    CHECK_THAT(run("⎕PROFILE 1"), Throws(kepler::DomainError));
+}
+
+TEST_CASE_METHOD(GeneralFixture, "Memory", "[memory]") {
+    CHECK_THAT(run("⎕WA 'clear'"), Prints(""));
+    CHECK_THAT(run("⎕WA 'start'"), Prints(""));
+    auto before = kepler::memory::usage();
+    CHECK_THAT(run("x←⍳100000"), Prints(""));
+    auto after = kepler::memory::usage();
+    CHECK(after.live >= before.live + 100000 * sizeof(kepler::Array::element_type));
+    CHECK(after.peak >= after.live);
+    CHECK(after.allocations > before.allocations);
+    CHECK_THAT(run("⍴⎕WA 'usage'"), Prints("4"));
+
+    auto report = run("⎕WA 'text'");
+    CHECK(report.starts_with("live "));
+    CHECK(report.find("  ⍳\n") != std::string::npos);
+
+    // Freeing the array lowers the memory held, but not the peak.
+    CHECK_THAT(run("x←0"), Prints(""));
+    CHECK(kepler::memory::usage().live < after.live);
+    CHECK(kepler::memory::usage().peak >= after.live);
+
+    CHECK_THAT(run("⎕WA 'stop'"), Prints(""));
+    CHECK_THAT(run("⎕WA 'clear'"), Prints(""));
+    CHECK(kepler::memory::usage().peak < after.live);
+    CHECK(run("⎕WA 'text'").find("function") == std::string::npos);
+    CHECK_THAT(run("⎕WA 'full'"), Throws(kepler::DomainError));
+    CHECK_THAT(run("⎕WA 1"), Throws(kepler::DomainError));
+
+    // Small buffers are recycled, including those made by threads which have since exited.
+    std::vector<kepler::Array> made;
+    std::jthread([&] {
+        for(int i = 0; i < 1000; ++i) {
+            made.emplace_back(kepler::Number(i));
+        }
+    }).join();
+    auto held = kepler::memory::usage().live;
+    made.clear();
+    CHECK(kepler::memory::usage().live < held);
+
+    // Blocks allocated by one thread and freed by another are reused, rather than adding slabs each time.
+    std::vector<void*> blocks;
+    auto allocate_blocks = [&](std::size_t size) {
+        std::jthread([&] {
+            for(int i = 0; i < 1000; ++i) {
+                blocks.push_back(kepler::memory::allocate(size));
+            }
+        }).join();
+    };
+    auto free_blocks = [&](std::size_t size) {
+        for(auto block : blocks) {
+            kepler::memory::deallocate(block, size);
+        }
+        blocks.clear();
+    };
+    allocate_blocks(240);
+    free_blocks(240);
+    auto settled = kepler::memory::usage().pooled;
+    for(int round = 0; round < 20; ++round) {
+        allocate_blocks(240);
+        free_blocks(240);
+    }
+    CHECK(kepler::memory::usage().pooled < settled + 2 * 64 * 1024);
+
+    // Blocks freed by a thread which only frees are handed over when it exits.
+    allocate_blocks(48);
+    std::jthread([&] {
+        free_blocks(48);
+    }).join();
+    auto pooled = kepler::memory::usage().pooled;
+    allocate_blocks(48);
+    CHECK(kepler::memory::usage().pooled == pooled);
+    free_blocks(48);
+
+    CHECK_THAT(run("+/⍳100000"), Prints("5000050000"));
+}
+
+TEST_CASE_METHOD(GeneralFixture, "Workspace limit", "[memory]") {
+    CHECK_THAT(run("⎕WA 'limit'"), Prints("0"));
+    CHECK_THAT(run("5000000000 ⎕WA 'limit'"), Prints(""));
+    CHECK_THAT(run("⎕WA 'limit'"), Prints("5000000000"));
+
+    // Allocations beyond the limit fail cleanly, and leave the workspace usable.
+    kepler::memory::set_limit(kepler::memory::usage().live + 1000000);
+    CHECK_THAT(run("x←⍳100000"), Throws(kepler::WSFullError));
+    CHECK_THAT(run("x←⍳10"), Prints(""));
+    CHECK_THAT(run("+/x"), Prints("55"));
+    CHECK_THAT(run("0 ⎕WA 'limit'"), Prints(""));
+    CHECK_THAT(run("x←⍳100000"), Prints(""));
+    CHECK_THAT(run("⍴x"), Prints("100000"));
+
+    CHECK_THAT(run("1 2 ⎕WA 'limit'"), Throws(kepler::LengthError));
+    CHECK_THAT(run("¯1 ⎕WA 'limit'"), Throws(kepler::DomainError));
+    CHECK_THAT(run("1 ⎕WA 'usage'"), Throws(kepler::DomainError));
+    kepler::memory::set_limit(0);
+}
+
+TEST_CASE_METHOD(FileFixture, "Sampler", "[sampler]") {
+    kepler::sampler::start(std::chrono::microseconds{100});
+    CHECK_THAT(run("../src/testing/files/hot.kpl"), Prints("4002000000"));
+    kepler::sampler::stop();
+    auto source = kepler::read_file("../src/testing/files/hot.kpl");
+
+    // Calls inside dfns are attributed to the lines defining them, and the line calling them.
+    std::stringstream annotated(kepler::sampler::report(kepler::sampler::AnnotatedFormat, source));
+    std::vector<std::string> lines;
+    for(std::string line; std::getline(annotated, line);) {
+        lines.push_back(line);
+    }
+    CHECK(lines.size() == 7);
+    if(lines.size() == 7) {
+        CHECK(lines[1] == "    self   total   line");
+        CHECK(lines[2] == "                      1  ⍝ Most of the time is spent summing on the first line.");
+        CHECK(lines[3].find_first_not_of(' ') < 16);
+        CHECK(lines[3].ends_with("      2  sum←{+/⍳⍵}"));
+        CHECK(lines[6].find_first_not_of(' ') < 16);
+    }
+
+    std::stringstream collapsed(kepler::sampler::report(kepler::sampler::CollapsedFormat, source));
+    std::regex stack(R"(\d+:\d+(;\d+:\d+)* \d+)");
+    std::size_t stacks = 0;
+    for(std::string line; std::getline(collapsed, line); ++stacks) {
+        CHECK(std::regex_match(line, stack));
+    }
+    CHECK(stacks > 0);
+}
+
+TEST_CASE_METHOD(FileFixture, "script cache", "[files]") {
+    auto directory = (std::filesystem::temp_directory_path() / "kepler-script-cache-test").string();
+    std::filesystem::remove_all(directory);
+    auto entries = [&]() {
+        return std::distance(std::filesystem::directory_iterator(directory), std::filesystem::directory_iterator());
+    };
+
+    // The first run fills the cache, and later runs execute from it.
+    CHECK_THAT(run("../src/testing/files/fact.kpl", directory), Prints("Factorial of 8:\n40320"));
+    CHECK(entries() == 1);
+    CHECK_THAT(run("../src/testing/files/fact.kpl", directory), Prints("Factorial of 8:\n40320"));
+    CHECK_THAT(run("../src/testing/files/unicode.kpl", directory), Prints("𝔸→olléh"));
+    CHECK_THAT(run("../src/testing/files/unicode.kpl", directory), Prints("𝔸→olléh"));
+    CHECK(entries() == 2);
+
+    // Runs which fail are not cached.
+    CHECK_THAT(run("../src/testing/files/partial.kpl", directory), Throws(kepler::SyntaxError));
+    CHECK(entries() == 2);
+
+    // Damaged entries are ignored, and replaced by the next run.
+    for(auto& entry : std::filesystem::directory_iterator(directory)) {
+        std::ofstream(entry.path(), std::ios::trunc) << "not a script";
+    }
+    CHECK_THAT(run("../src/testing/files/fact.kpl", directory), Prints("Factorial of 8:\n40320"));
+    auto fact = kepler::read_file("../src/testing/files/fact.kpl");
+    CHECK(kepler::load_script(directory, fact).has_value());
+    CHECK_THAT(run("../src/testing/files/fact.kpl", directory), Prints("Factorial of 8:\n40320"));
+
+    // An entry is only found for the source it was made for, which it records the digest of.
+    auto entry_path = [&](const kepler::Source& source) {
+        char name[48];
+        std::snprintf(name, sizeof(name), "%016llx%016llx.kplc", static_cast<unsigned long long>(source.digest.high), static_cast<unsigned long long>(source.digest.low));
+        return std::filesystem::path(directory) / name;
+    };
+    auto other = fact;
+    other.digest = kepler::digest("⎕←'Factorial of 9:\n'");
+    std::filesystem::copy_file(entry_path(fact), entry_path(other));
+    CHECK(!kepler::load_script(directory, other).has_value());
+    CHECK(kepler::load_script(directory, fact).has_value());
+
+    // Digests are MurmurHash3 of the bytes, which differ for sources decoding to the same text.
+    auto quick = kepler::digest("The quick brown fox jumps over the lazy dog");
+    CHECK(quick.high == 0xe34bbc7bbc071b6cULL);
+    CHECK(quick.low == 0x7a433ca9c49a9347ULL);
+    CHECK(quick.size == 43);
+    CHECK(kepler::digest("a\xFF") != kepler::digest("a\xFE"));
+
+    std::filesystem::remove_all(directory);
+}
@@ -21,6 +21,10 @@
 #include "testing/fixtures/general_fixture.h"
 #include "matcher.h"
 #include "core/error_type.h"
+#include "core/memory.h"
+#include "core/evaluation/sorting.h"
+#include <cmath>
+#include <limits>
 
 TEST_CASE_METHOD(GeneralFixture, "plus (+)", "[plus][function]") {
     CHECK_THAT(run("+2 "), Prints("2"));
@@ -146,7 +150,7 @@ TEST_CASE_METHOD(GeneralFixture, "minus (-)", "[minus][scalar][func]") {
     CHECK_THAT(run("(1-(2-2))"), Prints("1"));
 
     CHECK_THAT(run("'abc' - 'xyz'"), Throws(kepler::DomainError));
-    CHECK_THAT(run("'abc' - ('xyz' 2)"), Throws(kepler::DomainError));
+    CHECK_THAT(run("'abc' - ('xyz' 2)"), Throws(kepler::LengthError));
 }
 
 TEST_CASE_METHOD(GeneralFixture, "multiply (×)", "[multiply][function]") {
@@ -417,7 +421,8 @@ TEST_CASE_METHOD(GeneralFixture, "less (<)", "[less][function]") {
     CHECK_THAT(run("'a' < 'b'"), Prints("1"));
     CHECK_THAT(run("'b' < 'b'"), Prints("0"));
     CHECK_THAT(run("'c' < 'b'"), Prints("0"));
-    CHECK_THAT(run("'aa' < 'bb'"), Throws(kepler::DomainError));
+    CHECK_THAT(run("'aa' < 'bb'"), Prints("1 1"));
+    CHECK_THAT(run("'a' < 1"), Throws(kepler::DomainError));
 
     CHECK_THAT(run("2J1 < 3J1"), Throws(kepler::DomainError));
 }
@@ -441,7 +446,7 @@ TEST_CASE_METHOD(GeneralFixture, "less-equal (≤)", "[less-equal][function]") {
     CHECK_THAT(run("'a' ≤ 'b'"), Prints("1"));
     CHECK_THAT(run("'b' ≤ 'b'"), Prints("1"));
     CHECK_THAT(run("'c' ≤ 'b'"), Prints("0"));
-    CHECK_THAT(run("'aa' ≤ 'bb'"), Throws(kepler::DomainError));
+    CHECK_THAT(run("'aa' ≤ 'bb'"), Prints("1 1"));
 
     CHECK_THAT(run("2J1 ≤ 3J1"), Throws(kepler::DomainError));
 }
@@ -496,7 +501,7 @@ TEST_CASE_METHOD(GeneralFixture, "greater-equal (≥)", "[greater-equal][functio
     CHECK_THAT(run("'a' ≥ 'b'"), Prints("0"));
     CHECK_THAT(run("'b' ≥ 'b'"), Prints("1"));
     CHECK_THAT(run("'c' ≥ 'b'"), Prints("1"));
-    CHECK_THAT(run("'aa' ≥ 'bb'"), Throws(kepler::DomainError));
+    CHECK_THAT(run("'aa' ≥ 'bb'"), Prints("0 0"));
 
     CHECK_THAT(run("2J1 ≥ 3J1"), Throws(kepler::DomainError));
 }
@@ -520,7 +525,7 @@ TEST_CASE_METHOD(GeneralFixture, "greater (>)", "[greater][function]") {
     CHECK_THAT(run("'a' > 'b'"), Prints("0"));
     CHECK_THAT(run("'b' > 'b'"), Prints("0"));
     CHECK_THAT(run("'c' > 'b'"), Prints("1"));
-    CHECK_THAT(run("'aa' > 'bb'"), Throws(kepler::DomainError));
+    CHECK_THAT(run("'aa' > 'bb'"), Prints("0 0"));
 
     CHECK_THAT(run("2J1 > 3J1"), Throws(kepler::DomainError));
 }
@@ -557,6 +562,13 @@ TEST_CASE_METHOD(GeneralFixture, "not-equal (≠)", "[not-equal][function]") {
     CHECK_THAT(run("≠ 1 (1 2) (1 2 3) (1 2 3) 1 2 3 (2 2)"), Prints("1 1 1 0 0 1 1 1"));
     CHECK_THAT(run("≠ 0J23 0J¯23"), Prints("1 1"));
     CHECK_THAT(run("≠ 0J23 0J¯23 0J23 1J23"), Prints("1 1 0 1"));
+    CHECK_THAT(run("≠ 0 ¯0 1"), Prints("1 0 1"));
+    CHECK_THAT(run("≠ 'ab' 'cd' 'ab'"), Prints("1 1 0"));
+    CHECK_THAT(run("≠ (2 2⍴1) (1 1 1 1) (2 2⍴1)"), Prints("1 1 0"));
+
+    // Large inputs are matched by sorting instead of hashing.
+    CHECK_THAT(run("+/≠2200000⍴⍳1100000"), Prints("1100000"));
+    CHECK_THAT(run("+/(⍳3200000)∊⍳1100000"), Prints("1100000"));
 }
 
 TEST_CASE_METHOD(GeneralFixture, "left shoe (⊂)", "[left-shoe][function]") {
@@ -612,10 +624,19 @@ TEST_CASE_METHOD(GeneralFixture, "left shoe (⊂)", "[left-shoe][function]") {
                       "└───┴─┘"));
     CHECK_THAT(run("0 0 0 0 ⊂ 1 2"), Throws(kepler::LengthError));
     CHECK_THAT(run("0 0 0 0 0 ⊂ 'Hello'"), Prints(""));
-    CHECK_THAT(run("0 1 0 1 1 ⊂ 'Hello'"), Prints("el l o"));
-    CHECK_THAT(run("1 1 1 1 1 ⊂ 'Hello'"), Prints("H e l l o"));
+    CHECK_THAT(run("0 1 0 1 1 ⊂ 'Hello'"),
+               Prints("┌──┬─┬─┐\n"
+                      "│el│l│o│\n"
+                      "└──┴─┴─┘"));
+    CHECK_THAT(run("1 1 1 1 1 ⊂ 'Hello'"),
+               Prints("┌─┬─┬─┬─┬─┐\n"
+                      "│H│e│l│l│o│\n"
+                      "└─┴─┴─┴─┴─┘"));
     CHECK_THAT(run("1 1 1 1 1 ⊂ ''"), Throws(kepler::LengthError));
-    CHECK_THAT(run("1 1 1 1 1 ⊂ 'Hello, World!'"), Prints("H e l l o"));
+    CHECK_THAT(run("1 1 1 1 1 ⊂ 'Hello, World!'"),
+               Prints("┌─┬─┬─┬─┬─┐\n"
+                      "│H│e│l│l│o│\n"
+                      "└─┴─┴─┴─┴─┘"));
 }
 
 TEST_CASE_METHOD(GeneralFixture, "without (~)", "[without][function]") {
@@ -629,6 +650,9 @@ TEST_CASE_METHOD(GeneralFixture, "without (~)", "[without][function]") {
     CHECK_THAT(run("1 2 3 4 5 1.23 ~ 1 2 3"), Prints("4 5 1.23"));
     CHECK_THAT(run("1 2 3 4 5 1.23 ~ 1 2 3 4 5 1.23"), Prints(""));
     CHECK_THAT(run("1 ~ 120"), Prints("1"));
+    CHECK_THAT(run("1 (1 2) 3 (1 2) ~ (1 2) 5"), Prints("1 3"));
+    CHECK_THAT(run("0 1 2 ~ ¯0"), Prints("1 2"));
+    CHECK_THAT(run("+/(2200000⍴⍳1100000)~2×⍳2100000"), Prints("6.05E11"));
 
     CHECK_THAT(run("(3 3 3⍴1) ~ 1"), Throws(kepler::RankError));
     CHECK_THAT(run("3 3 3⍴1 ~ 1"),
@@ -660,6 +684,82 @@ TEST_CASE_METHOD(GeneralFixture, "iota (⍳)", "[iota][function]") {
     CHECK_THAT(run("⍳2 3⍴0"), Throws(kepler::RankError));
     CHECK_THAT(run("⍳¯2"), Throws(kepler::DomainError));
     CHECK_THAT(run("⍳2J2"), Throws(kepler::DomainError));
+
+    CHECK_THAT(run("1 2 3⍳2"), Prints("2"));
+    CHECK_THAT(run("1 2 3⍳2 5"), Prints("2 4"));
+    CHECK_THAT(run("1 2 3⍳2 2⍴3 2 1 0"), Prints("3 2\n"
+                                                "1 4"));
+    CHECK_THAT(run("(1 2)(3 4)⍳⊂3 4"), Prints("2"));
+    CHECK_THAT(run("'abc'⍳'cz'"), Prints("3 4"));
+    CHECK_THAT(run("x←⍳5000 ◊ x⍳4999 5001"), Prints("4999 5001"));
+
+    // The cached index of a large left argument does not keep it alive after the statement.
+    CHECK_THAT(run("y←⍳100000"), Prints(""));
+    CHECK_THAT(run("y⍳5"), Prints("5"));
+    auto held = kepler::memory::usage().live;
+    CHECK_THAT(run("y←0"), Prints(""));
+    CHECK(kepler::memory::usage().live + 100000 * sizeof(kepler::Array::element_type) <= held);
+    CHECK_THAT(run("(2 2⍴1)⍳1"), Throws(kepler::RankError));
+}
+
+TEST_CASE_METHOD(GeneralFixture, "epsilon (∊)", "[epsilon][function]") {
+    CHECK_THAT(run("2∊1 2 3"), Prints("1"));
+    CHECK_THAT(run("1 2 3∊3 1"), Prints("1 0 1"));
+    CHECK_THAT(run("(2 2⍴⍳4)∊2 3"), Prints("0 1\n"
+                                           "1 0"));
+    CHECK_THAT(run("(1 2)(3 4)∊(1 2)(5 6)"), Prints("1 0"));
+    CHECK_THAT(run("'hello'∊'lo'"), Prints("0 0 1 1 1"));
+}
+
+TEST_CASE_METHOD(GeneralFixture, "down shoe (∪)", "[down-shoe][function]") {
+    CHECK_THAT(run("∪1 2 1 3 2"), Prints("1 2 3"));
+    CHECK_THAT(run("∪'mississippi'"), Prints("misp"));
+    CHECK_THAT(run("1 2 3∪3 4 5"), Prints("1 2 3 4 5"));
+    CHECK_THAT(run("'abc'∪'cde'"), Prints("abcde"));
+    CHECK_THAT(run("(2 2⍴1)∪1"), Throws(kepler::RankError));
+}
+
+TEST_CASE_METHOD(GeneralFixture, "up shoe (∩)", "[up-shoe][function]") {
+    CHECK_THAT(run("1 2 3 2∩2 3 4"), Prints("2 3 2"));
+    CHECK_THAT(run("'hello'∩'world'"), Prints("llo"));
+    CHECK_THAT(run("1 2 3∩4 5"), Prints(""));
+    CHECK_THAT(run("1∩2 2⍴1"), Throws(kepler::RankError));
+}
+
+TEST_CASE_METHOD(GeneralFixture, "delta stile (⍋)", "[delta-stile][function]") {
+    CHECK_THAT(run("⍋3 1 2"), Prints("2 3 1"));
+    CHECK_THAT(run("⍋2 2 1 1 0"), Prints("5 3 4 1 2"));
+    CHECK_THAT(run("⍋¯3 ¯1 ¯2"), Prints("1 3 2"));
+    CHECK_THAT(run("⍋1.5 ¯2 0.5 ¯2"), Prints("2 4 3 1"));
+    CHECK_THAT(run("⍋'hello'"), Prints("2 1 3 4 5"));
+    CHECK_THAT(run("⍋3 2⍴1 2 0 5 1 1"), Prints("2 3 1"));
+    CHECK_THAT(run("x←(⌽⍳70000)÷3 ◊ +/(⍋x)=⌽⍳70000"), Prints("70000"));
+    CHECK_THAT(run("⍋5"), Throws(kepler::RankError));
+    CHECK_THAT(run("⍋1J2 3"), Throws(kepler::DomainError));
+
+    // NaN is ordered after every number, also when large inputs are sorted in chunks and merged.
+    std::vector<double> keys(70000);
+    for(std::size_t i = 0; i < keys.size(); ++i) {
+        keys[i] = i % 7 == 0 ? std::numeric_limits<double>::quiet_NaN() : static_cast<double>(keys.size() - i);
+    }
+    auto order = kepler::grade(keys, false);
+    bool sorted = order.size() == keys.size();
+    for(std::size_t i = 1; sorted && i < order.size(); ++i) {
+        auto lhs = keys[order[i - 1]];
+        auto rhs = keys[order[i]];
+        sorted = std::isnan(rhs) ? (!std::isnan(lhs) || order[i - 1] < order[i]) : (!std::isnan(lhs) && lhs < rhs);
+    }
+    CHECK(sorted);
+    order = kepler::grade(keys, true);
+    CHECK((std::isnan(keys[order[9999]]) && !std::isnan(keys[order[10000]]) && keys[order[10000]] == 69999));
+}
+
+TEST_CASE_METHOD(GeneralFixture, "del stile (⍒)", "[del-stile][function]") {
+    CHECK_THAT(run("⍒3 1 2 3"), Prints("1 4 3 2"));
+    CHECK_THAT(run("⍒1.5 ¯2 0.5 ¯2"), Prints("1 3 2 4"));
+    CHECK_THAT(run("⍒3 2⍴1 2 0 5 1 1"), Prints("1 3 2"));
+    CHECK_THAT(run("x←(⌽⍳70000)÷3 ◊ +/(⍒x)=⍳70000"), Prints("70000"));
+    CHECK_THAT(run("⍒5"), Throws(kepler::RankError));
 }
 
 TEST_CASE_METHOD(GeneralFixture, "rho (⍴)", "[rho][function]") {
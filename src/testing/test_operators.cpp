@@ -41,6 +41,21 @@ TEST_CASE_METHOD(GeneralFixture, "slash (/)", "[slash][operators]") {
     CHECK_THAT(run("1 2 3 +/ 1 2 3"), Throws(kepler::NotImplemented));
 }
 
+TEST_CASE_METHOD(GeneralFixture, "fused reduction (/)", "[slash][fusion][operators]") {
+    CHECK_THAT(run("+/1 2 3×4 5 6"), Prints("32"));
+    CHECK_THAT(run("-/1 2 3×4"), Prints("8"));
+    CHECK_THAT(run("⌈/|3 ¯8 2-1"), Prints("9"));
+    CHECK_THAT(run("∧/1 2 3=1 2 3"), Prints("1"));
+    CHECK_THAT(run("∧/1 2 3=1 2 4"), Prints("0"));
+    CHECK_THAT(run("+/-⍳4"), Prints("¯10"));
+    CHECK_THAT(run("+/(1 2)(3 4)×2"), Prints("8 12"));
+    CHECK_THAT(run("+/⍳100000"), Prints("5000050000"));
+    CHECK_THAT(run("+/(⍳100000)×2"), Prints("1.00001E10"));
+
+    CHECK_THAT(run("+/1 2 3÷0 1 2"), Throws(kepler::DomainError));
+    CHECK_THAT(run("+/1 2 3×4 5"), Throws(kepler::LengthError));
+}
+
 TEST_CASE_METHOD(GeneralFixture, "diaeresis (¨)", "[diaeresis][operators]") {
     CHECK_THAT(run("{2+⍵}¨2 3 4"), Prints("4 5 6"));
     CHECK_THAT(run("2 3 4{2+⍵}¨2"), Prints("4 4 4"));
@@ -89,6 +104,9 @@ TEST_CASE_METHOD(GeneralFixture, "Inner product (.)", "[inner-product][operators
     CHECK_THAT(run("4 2 1 +.× 1 0 1"), Prints("5"));
     CHECK_THAT(run("1 2 3 +.× 4 5 6"), Prints("32"));
     CHECK_THAT(run("3 3 ∧.= 3 3 3 3"), Throws(kepler::LengthError));
+    CHECK_THAT(run("1 2 3 ∧.= 1 2 3"), Prints("1"));
+    CHECK_THAT(run("3 ⌈.| ¯1 5 ¯4"), Prints("2"));
+    CHECK_THAT(run("0 1 2 +.÷ 0 1 2"), Prints("3"));
 }
 
 TEST_CASE_METHOD(GeneralFixture, "Power (⍣)", "[power][operators]") {
@@ -99,7 +117,8 @@ TEST_CASE_METHOD(GeneralFixture, "Power (⍣)", "[power][operators]") {
     CHECK_THAT(run("(f⍣0)102301"), Prints("102301"));
     CHECK_THAT(run("(f⍣0)102301"), Prints("102301"));
     CHECK_THAT(run("(f⍣102301)0"), Prints("102301"));
-    CHECK_THAT(run("(f⍣'abc')4"), Throws(kepler::DomainError));
+    CHECK_THAT(run("(f⍣'a')4"), Throws(kepler::DomainError));
+    CHECK_THAT(run("(f⍣'abc')4"), Throws(kepler::LengthError));
 }
 
 TEST_CASE_METHOD(GeneralFixture, "Outer product (.)", "[outer-product][operators]") {
@@ -0,0 +1,86 @@
+//
+// Copyright 2023 Nikolaj Banke Jensen.
+//
+// This file is part of Kepler.
+// 
+// Kepler is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Kepler is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License 
+// along with Kepler. If not, see <https://www.gnu.org/licenses/>.
+//
+#include <catch2/catch_test_macros.hpp>
+#include "testing/fixtures/general_fixture.h"
+#include "matcher.h"
+#include "core/error_type.h"
+#include "core/memory.h"
+
+TEST_CASE_METHOD(GeneralFixture, "constant-folding", "[constant-folding][optimizer]") {
+    CHECK_THAT(run("2×3"), Prints("6"));
+    CHECK_THAT(run("+/⍳10"), Prints("55"));
+    CHECK_THAT(run("1 (2×3) (4 5)"), Prints("┌─┬─┬───┐\n"
+                                           "│1│6│4 5│\n"
+                                           "└─┴─┴───┘"));
+    CHECK_THAT(run("{⍵×2×3}¨1 2"), Prints("6 12"));
+
+    // Errors are reported where the expression is evaluated.
+    CHECK_THAT(run("1÷0"), Throws(kepler::DomainError));
+    CHECK_THAT(run("{⍵:1÷0 ◊ 2} 0"), Prints("2"));
+
+    // The index origin may change before the expression is evaluated.
+    CHECK_THAT(run("⎕IO←0 ◊ ⍳3"), Prints("0 1 2"));
+    CHECK_THAT(run("f←{⍵+⍳3} ◊ ⎕IO←1 ◊ f 0"), Prints("1 2 3"));
+    CHECK_THAT(run("g←{⎕IO←0 ◊ ⍵} ◊ ⎕IO←1 ◊ g 0 ◊ ⍳3"), Prints("0 1 2"));
+
+    // Values too large to keep are given up on before they are computed in full.
+    kepler::memory::clear();
+    CHECK_THAT(run("f←{⍵+⍴3000000⍴1}"), Prints(""));
+    CHECK(kepler::memory::usage().allocated < 3000000);
+    CHECK_THAT(run("f 1"), Prints("3000001"));
+}
+
+TEST_CASE_METHOD(GeneralFixture, "simplification", "[simplification][optimizer]") {
+    CHECK_THAT(run("x←2 3 ◊ (⊢x) (⊣x) (x+0) (0+x) (x-0) (1×x) (x×1) (x÷1)"), Prints("┌───┬───┬───┬───┬───┬───┬───┬───┐\n"
+                                                                                "│2 3│2 3│2 3│2 3│2 3│2 3│2 3│2 3│\n"
+                                                                                "└───┴───┴───┴───┴───┴───┴───┴───┘"));
+    CHECK_THAT(run("x←'abc' ◊ ⌽⌽x"), Prints("abc"));
+    CHECK_THAT(run("x←2 3⍴⍳6 ◊ ⊖⊖⌽x"), Prints("3 2 1\n"
+                                             "6 5 4"));
+
+    // Identities of arithmetic only hold for numeric arguments.
+    CHECK_THAT(run("x←'abc' ◊ x+0"), Throws(kepler::DomainError));
+    CHECK_THAT(run("{1×⍵}'a'"), Throws(kepler::DomainError));
+}
+
+TEST_CASE_METHOD(GeneralFixture, "invariants", "[invariants][optimizer]") {
+    CHECK_THAT(run("n←3 ◊ {⍵+⍳n}¨1 2"), Prints("┌─────┬─────┐\n"
+                                              "│2 3 4│3 4 5│\n"
+                                              "└─────┴─────┘"));
+    CHECK_THAT(run("n←1 ◊ ({⍵+n×2}⍣3) 0"), Prints("6"));
+    CHECK_THAT(run("n←5 ◊ {⍵:n+⍳2 ◊ 0}¨1 0"), Prints("┌───┬─┐\n"
+                                                    "│6 7│0│\n"
+                                                    "└───┴─┘"));
+
+    // Variables assigned in the body are not invariant.
+    CHECK_THAT(run("n←5 ◊ {n←⍵ ◊ n+⍳3}¨1 2"), Prints("┌─────┬─────┐\n"
+                                                    "│2 3 4│3 4 5│\n"
+                                                    "└─────┴─────┘"));
+    CHECK_THAT(run("n←0 ◊ ({n←n+1 ◊ ⍵+n}⍣3) 0"), Prints("6"));
+
+    // Neither are primitives depending on the index origin, if the body assigns it.
+    CHECK_THAT(run("{⎕IO←⍵ ◊ ⍳3}¨0 1"), Prints("┌─────┬─────┐\n"
+                                              "│0 1 2│1 2 3│\n"
+                                              "└─────┴─────┘"));
+
+    // Invariants are evaluated again in every application of the operator.
+    CHECK_THAT(run("n←1 ◊ a←{⍵+n×10}¨1 2 ◊ n←2 ◊ a ({⍵+n×10}¨1 2)"), Prints("┌─────┬─────┐\n"
+                                                                          "│11 12│21 22│\n"
+                                                                          "└─────┴─────┘"));
+}
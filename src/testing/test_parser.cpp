@@ -126,7 +126,7 @@ TEST_CASE_METHOD(ParserFixture, "variables", "[variables][parser]") {
     CHECK_THAT(run("←1+2"), Throws(kepler::SyntaxError));
 
     CHECK_THAT(run("v ← 12 ◊ 1 2 v 1 2"), Prints("Statements(Assignment(Token(ID, v) ← Scalar(Token(NUMBER, 12))), Vector(Scalar(Token(NUMBER, 1)), Scalar(Token(NUMBER, 2)), Variable(Token(ID, v)), Scalar(Token(NUMBER, 1)), Scalar(Token(NUMBER, 2))))"));
-    CHECK_THAT(run("v ← 2J¯1 ◊ 1 2 'abc' ¯5 ¯2E3 v 100"), Prints("Statements(Assignment(Token(ID, v) ← Scalar(Token(NUMBER, 2J-1))), Vector(Scalar(Token(NUMBER, 1)), Scalar(Token(NUMBER, 2)), Scalar(Token(STRING, abc)), Scalar(Token(NUMBER, -5)), Scalar(Token(NUMBER, -2E3)), Variable(Token(ID, v)), Scalar(Token(NUMBER, 100))))"));
+    CHECK_THAT(run("v ← 2J¯1 ◊ 1 2 'abc' ¯5 ¯2E3 v 100"), Prints("Statements(Assignment(Token(ID, v) ← Scalar(Token(NUMBER, 2J-1))), Vector(Scalar(Token(NUMBER, 1)), Scalar(Token(NUMBER, 2)), Scalar(Token(STRING, abc)), Scalar(Token(NUMBER, -5)), Scalar(Token(NUMBER, -2000)), Variable(Token(ID, v)), Scalar(Token(NUMBER, 100))))"));
 }
 
 TEST_CASE_METHOD(ParserFixture, "parenthesis", "[parenthesis][parser]") {
@@ -158,4 +158,53 @@ TEST_CASE_METHOD(ParserFixture, "functions", "[functions][parser]") {
     CHECK_THAT(run("1 2 3 (+) 4 5 6"), Prints("Statements(DyadicFunction(Vector(Scalar(Token(NUMBER, 1)), Scalar(Token(NUMBER, 2)), Scalar(Token(NUMBER, 3))) Function(Token(PLUS, +)) Vector(Scalar(Token(NUMBER, 4)), Scalar(Token(NUMBER, 5)), Scalar(Token(NUMBER, 6)))))"));
 
     CHECK_THAT(run("1 2 3 (+∘-) 4 5 6"), Prints("Statements(DyadicFunction(Vector(Scalar(Token(NUMBER, 1)), Scalar(Token(NUMBER, 2)), Scalar(Token(NUMBER, 3))) DyadicOperator(Function(Token(PLUS, +)) Token(JOT, ∘) Function(Token(MINUS, -))) Vector(Scalar(Token(NUMBER, 4)), Scalar(Token(NUMBER, 5)), Scalar(Token(NUMBER, 6)))))"));
-}
\ No newline at end of file
+}
+
+TEST_CASE_METHOD(ParserFixture, "nesting", "[nesting][parser]") {
+    const int depth = 1000;
+
+    std::string dfns;
+    std::string expected;
+    for(int i = 0; i < depth; ++i) {
+        dfns = "f←{" + dfns + "}";
+        expected = "FunctionAssignment(Token(ID, f) ← AnonymousFunction(Statements(" + expected + ")))";
+    }
+    CHECK_THAT(run(std::string(dfns)), Prints("Statements(" + expected + ")"));
+    CHECK_THAT(run(dfns + "}"), Throws(kepler::SyntaxError));
+    CHECK_THAT(run("{" + dfns), Throws(kepler::SyntaxError));
+
+    // Functions defined inside one another share the tokens of their definitions, so deep nesting parses in linear time.
+    std::string deep;
+    for(int i = 0; i < 10 * depth; ++i) {
+        deep += "f←{";
+    }
+    deep.append(10 * depth, '}');
+    auto ast = parse(std::move(deep));
+    auto outer = dynamic_cast<kepler::FunctionAssignment*>(ast->children.front());
+    auto body = outer ? dynamic_cast<kepler::AnonymousFunction*>(outer->function) : nullptr;
+    auto inner = body ? dynamic_cast<kepler::FunctionAssignment*>(body->body->children.front()) : nullptr;
+    CHECK(inner != nullptr);
+    if(inner) {
+        CHECK(outer->definition.size() == 4 * 10 * depth - 2);
+        CHECK(inner->definition.begin() > outer->definition.begin());
+        CHECK(inner->definition.end() < outer->definition.end());
+    }
+    delete ast;
+
+    std::string parens = std::string(depth, '(') + "1" + std::string(depth, ')');
+    CHECK_THAT(run(std::string(parens)), Prints("Statements(Scalar(Token(NUMBER, 1)))"));
+    CHECK_THAT(run(parens + ")"), Throws(kepler::SyntaxError));
+
+    std::string statements;
+    for(int i = 0; i < depth; ++i) {
+        statements += "{⍵}1 ◊ ";
+    }
+    CHECK_THAT(run(std::move(statements)), Prints([&] {
+        std::string result = "Statements(";
+        for(int i = 0; i < depth; ++i) {
+            result += (i == 0 ? "" : ", ");
+            result += "MonadicFunction(AnonymousFunction(Statements(Variable(Token(OMEGA, ⍵)))) Scalar(Token(NUMBER, 1)))";
+        }
+        return result + ")";
+    }()));
+}
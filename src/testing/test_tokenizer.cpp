@@ -491,5 +491,31 @@ TEST_CASE_METHOD(TokenizerFixture, "line", "[line][lexer]") {
 
 TEST_CASE_METHOD(TokenizerFixture, "corner-cases", "[corner-cases][lexer]") {
     CHECK_THAT_THROWS(run("∂∂"), Throws(kepler::SyntaxError));
+    CHECK_THAT_THROWS(run("⍫"), Throws(kepler::SyntaxError));
+    CHECK_THAT_THROWS(run("𝔸"), Throws(kepler::SyntaxError));
+    CHECK_THAT_THROWS(run("."), Throws(kepler::SyntaxError));
     CHECK_THAT(run(""), Outputs({}));
-}
\ No newline at end of file
+    CHECK_THAT(run("⎕IO×.5"), Outputs({{kepler::ID, U"⎕IO"}, {kepler::TIMES, U"×"}, {kepler::NUMBER, U".5"}}));
+}
+
+TEST_CASE_METHOD(TokenizerFixture, "token-location", "[token-location][lexer]") {
+    auto tokens = run("abc←12 ¯3J2 'xy'");
+    CHECK(tokens[1].offset == 0);
+    CHECK(tokens[1].length == 3);
+    CHECK(tokens[2].offset == 3);
+    CHECK(tokens[3].value == kepler::Number(12));
+    CHECK(tokens[4].offset == 7);
+    CHECK(tokens[4].length == 4);
+    CHECK(tokens[4].value == kepler::Number(-3, 2));
+    CHECK(tokens[5].length == 4);
+    CHECK(tokens[5].content() == U"xy");
+    CHECK(tokens[1].id == run("abc")[1].id);
+
+    // Only identifiers and primitives are interned, as numbers keep their value and strings are read from the input.
+    std::vector<kepler::Char> input = {U'1', U' ', U'\'', U'x', U'y', U'\''};
+    kepler::Tokenizer tokenizer;
+    auto literals = tokenizer.tokenize(&input);
+    CHECK(literals[1].id == kepler::no_id);
+    CHECK(literals[2].id == kepler::no_id);
+    CHECK(literals[2].content(&input) == U"xy");
+}